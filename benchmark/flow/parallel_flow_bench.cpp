@@ -0,0 +1,95 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <flow/flow.hpp>
+#include <flow/parallel_builder.hpp>
+
+#include <stdx/ct_string.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <nanobench.h>
+
+namespace {
+// a startup flow of 500 steps: 20 independent chains of 25 steps each
+constexpr auto num_chains = std::size_t{20};
+constexpr auto chain_length = std::size_t{25};
+
+// how long each step takes
+auto step_time = std::chrono::nanoseconds{};
+
+auto do_step() -> void {
+    using clock_t = std::chrono::steady_clock;
+    auto const end = clock_t::now() + step_time;
+    while (clock_t::now() < end) {
+    }
+}
+
+// step names are "s000" to "s499"
+template <std::size_t I>
+constexpr auto digits = std::array{'s', static_cast<char>('0' + I / 100),
+                                   static_cast<char>('0' + I / 10 % 10),
+                                   static_cast<char>('0' + I % 10)};
+
+template <std::size_t I>
+constexpr auto step_name =
+    stdx::ct_string<5>{std::string_view{digits<I>.data(), 4}};
+
+template <std::size_t I>
+constexpr auto step = flow::action<step_name<I>>([] { do_step(); });
+
+template <std::size_t Chain, std::size_t... Is>
+constexpr auto make_chain(std::index_sequence<Is...>) {
+    return (*step<Chain * chain_length + Is> >> ...);
+}
+
+template <std::size_t... Chains>
+constexpr auto make_flow(std::index_sequence<Chains...>) {
+    return flow::graph<>{}.add(
+        make_chain<Chains>(std::make_index_sequence<chain_length>{})...);
+}
+
+struct startup_flow_t {
+    constexpr static auto value =
+        make_flow(std::make_index_sequence<num_chains>{});
+};
+
+constexpr auto serial_flow =
+    flow::graph_builder<"", flow::impl>::render<startup_flow_t>();
+
+template <std::size_t NumThreads>
+constexpr auto parallel_flow =
+    flow::parallel_graph_builder<"", flow::impl,
+                                 NumThreads>::template render<startup_flow_t>();
+
+auto run_startup(std::chrono::nanoseconds t) -> void {
+    step_time = t;
+
+    auto bench = ankerl::nanobench::Bench()
+                     .title("Running a 500-step flow, " +
+                            std::to_string(t.count()) + "ns per step")
+                     .unit("flow")
+                     .relative(true)
+                     .minEpochIterations(t.count() == 0 ? 1000 : 10);
+
+    bench.run("graph_builder", [] { serial_flow(); });
+    bench.run("parallel_graph_builder, 2 threads",
+              [] { parallel_flow<2>(); });
+    bench.run("parallel_graph_builder, 4 threads",
+              [] { parallel_flow<4>(); });
+    bench.run("parallel_graph_builder, 8 threads",
+              [] { parallel_flow<8>(); });
+}
+} // namespace
+
+int main() {
+    // the overhead of scheduling each step on the pool
+    run_startup(std::chrono::nanoseconds{0});
+    // steps that do some initialization each
+    run_startup(std::chrono::microseconds{2});
+    run_startup(std::chrono::microseconds{20});
+}
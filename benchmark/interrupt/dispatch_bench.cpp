@@ -0,0 +1,167 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <interrupt/config.hpp>
+#include <interrupt/dispatch.hpp>
+#include <interrupt/fwd.hpp>
+#include <interrupt/hal.hpp>
+#include <interrupt/impl.hpp>
+#include <interrupt/policies.hpp>
+
+#include <stdx/concepts.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include <nanobench.h>
+
+using interrupt::operator""_irq;
+
+namespace {
+struct bench_hal {
+    static auto init() -> void {}
+
+    template <bool, interrupt::irq_num_t, std::size_t>
+    static auto irq_init() -> void {}
+
+    template <interrupt::status_policy P>
+    static auto run(interrupt::irq_num_t, stdx::invocable auto const &isr)
+        -> void {
+        P::run([] {}, [&] { isr(); });
+    }
+};
+} // namespace
+template <> inline auto interrupt::injected_hal<> = bench_hal{};
+
+namespace {
+// A register HAL where every access is volatile, as MMIO would be, and can be
+// made slower: a read over a peripheral bus typically takes tens of cycles.
+int access_cost{};
+
+auto access() -> void {
+    for (auto i = 0; i < access_cost; ++i) {
+        ankerl::nanobench::doNotOptimizeAway(i);
+    }
+}
+
+template <typename Field> struct field_value_t {
+    std::uint32_t value;
+};
+
+template <typename Reg, std::uint32_t Mask> struct mock_field_t {
+    using RegisterType = Reg;
+
+    constexpr static auto get_register() -> Reg { return {}; }
+    constexpr static auto get_mask() -> typename Reg::DataType { return Mask; }
+
+    constexpr auto operator()(std::uint32_t value) const {
+        return field_value_t<mock_field_t>{value};
+    }
+};
+
+template <int Id> struct mock_register_t {
+    using DataType = std::uint32_t;
+    constexpr static mock_field_t<mock_register_t, 0xffff'ffffu> raw{};
+
+    static inline DataType volatile value{};
+};
+
+template <typename... Ops> constexpr auto apply(Ops... ops) {
+    return (ops(), ...);
+}
+
+template <typename Field> constexpr auto read(Field) {
+    return [] {
+        access();
+        return Field::RegisterType::value & Field::get_mask();
+    };
+}
+
+template <typename Field> constexpr auto clear(Field) {
+    return [] {
+        access();
+        auto &v = Field::RegisterType::value;
+        v = v & ~Field::get_mask();
+    };
+}
+
+template <typename Field> constexpr auto write(field_value_t<Field> v) {
+    return [=] {
+        access();
+        auto &r = Field::RegisterType::value;
+        r = r & ~v.value;
+    };
+}
+
+using enable_reg_t = mock_register_t<0>;
+using status_reg_t = mock_register_t<1>;
+
+std::uint32_t isr_count{};
+
+template <std::size_t N> struct flow_t {
+    auto operator()() const -> void { ++isr_count; }
+    constexpr static bool active = true;
+};
+
+struct bench_nexus {
+    template <typename T> constexpr static auto service = T{};
+};
+
+template <std::size_t N>
+using sub_t = interrupt::sub_irq_impl<
+    interrupt::sub_irq<mock_field_t<enable_reg_t, 1u << N>,
+                       mock_field_t<status_reg_t, 1u << N>,
+                       interrupt::policies<>, flow_t<N>>,
+    bench_nexus>;
+
+constexpr auto num_subs = std::size_t{24};
+
+template <typename Dispatch, std::size_t... Is>
+auto make_shared(std::index_sequence<Is...>)
+    -> interrupt::shared_irq_impl<
+        interrupt::shared_irq<17_irq, 1, interrupt::policies<Dispatch>>,
+        sub_t<Is>...>;
+
+template <typename Dispatch>
+using shared_t = decltype(make_shared<Dispatch>(
+    std::make_index_sequence<num_subs>{}));
+
+using sequential_t = shared_t<interrupt::sequential_dispatch>;
+using coalesced_t = shared_t<interrupt::coalesced_dispatch<>>;
+using coalesced_w1c_t =
+    shared_t<interrupt::coalesced_dispatch<interrupt::write_one_to_clear>>;
+
+template <typename Impl>
+auto bench_dispatch(ankerl::nanobench::Bench &bench, std::string const &name,
+                    std::uint32_t pending) -> void {
+    bench.run(name, [&] {
+        status_reg_t::value = pending;
+        Impl::run();
+    });
+}
+} // namespace
+
+int main() {
+    enable_reg_t::value = 0xff'ffffu;
+
+    for (auto cost : {0, 32}) {
+        access_cost = cost;
+        for (auto [label, pending] : {std::pair{"1 pending", 0x00'1000u},
+                                      std::pair{"3 pending", 0x80'0401u},
+                                      std::pair{"24 pending", 0xff'ffffu}}) {
+            auto bench = ankerl::nanobench::Bench()
+                             .title("24 sub-IRQs, " + std::string{label} +
+                                    ", access cost " + std::to_string(cost))
+                             .unit("interrupt")
+                             .relative(true)
+                             .minEpochIterations(100'000);
+
+            bench_dispatch<sequential_t>(bench, "sequential", pending);
+            bench_dispatch<coalesced_t>(bench, "coalesced", pending);
+            bench_dispatch<coalesced_w1c_t>(
+                bench, "coalesced, write 1 to clear", pending);
+        }
+    }
+    ankerl::nanobench::doNotOptimizeAway(isr_count);
+}
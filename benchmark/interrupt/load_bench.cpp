@@ -0,0 +1,180 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <interrupt/config.hpp>
+#include <interrupt/fwd.hpp>
+#include <interrupt/hal.hpp>
+#include <interrupt/instrumentation.hpp>
+#include <interrupt/manager.hpp>
+#include <interrupt/policies.hpp>
+#include <interrupt/sim/generator.hpp>
+#include <interrupt/sim/hal.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <nanobench.h>
+
+using interrupt::operator""_irq;
+
+namespace {
+constinit auto sim_irqs = interrupt::sim::controller<>{};
+} // namespace
+template <> inline auto interrupt::injected_hal<> =
+    interrupt::sim::hal<sim_irqs>{};
+
+namespace {
+std::uint64_t isr_count{};
+
+template <std::size_t N> struct flow_t {
+    auto operator()() const -> void { ++isr_count; }
+    constexpr static bool active = true;
+};
+
+struct bench_nexus {
+    template <typename T> constexpr static auto service = T{};
+};
+
+// 8 IRQs, each at its own priority: IRQ 0 is the most urgent
+constexpr auto num_irqs = std::size_t{8};
+
+template <std::size_t I>
+constexpr auto irq_number = static_cast<interrupt::irq_num_t>(I);
+
+template <std::size_t... Is>
+auto make_config(std::index_sequence<Is...>) -> interrupt::root<
+    interrupt::irq<irq_number<Is>, Is, interrupt::policies<>, flow_t<Is>>...>;
+
+using config_t =
+    decltype(make_config(std::make_index_sequence<num_irqs>{}));
+
+constexpr auto manager = interrupt::manager<config_t, bench_nexus>{};
+
+// the upper bound of the histogram bucket that holds a quantile
+auto quantile(interrupt::irq_stats const &s, double q) -> std::uint64_t {
+    auto const target = static_cast<std::uint64_t>(q * s.count);
+    auto seen = std::uint64_t{};
+    for (auto i = std::size_t{}; i < s.histogram.size(); ++i) {
+        seen += s.histogram[i];
+        if (seen > target) {
+            return std::uint64_t{1} << i;
+        }
+    }
+    return s.max_cycles;
+}
+
+auto merged_stats() -> interrupt::irq_stats {
+    auto all = interrupt::irq_stats{};
+    for (auto i = std::size_t{}; i < num_irqs; ++i) {
+        auto const &s = sim_irqs.latency(static_cast<interrupt::irq_num_t>(i));
+        all.count += s.count;
+        all.max_cycles = std::max(all.max_cycles, s.max_cycles);
+        for (auto b = std::size_t{}; b < s.histogram.size(); ++b) {
+            all.histogram[b] += s.histogram[b];
+        }
+    }
+    return all;
+}
+
+struct load {
+    char const *name;
+    interrupt::sim::arrival pattern;
+    double rate_per_irq;
+};
+
+// raises a fixed number of interrupts on every IRQ, with the core thread
+// busy-waiting for them, and reports what the core kept up with
+auto run_load(load const &l, std::uint64_t limit) -> void {
+    auto sources = std::vector<interrupt::sim::source>{};
+    for (auto i = std::size_t{}; i < num_irqs; ++i) {
+        sources.push_back({.irq = static_cast<interrupt::irq_num_t>(i),
+                           .rate = l.rate_per_irq,
+                           .pattern = l.pattern});
+    }
+
+    sim_irqs.reset_stats();
+    auto const start = std::chrono::steady_clock::now();
+    {
+        auto core = std::jthread{[](std::stop_token stop) {
+            sim_irqs.run(stop, interrupt::sim::idle_mode::spin);
+        }};
+        auto g = interrupt::sim::generator{sim_irqs, std::move(sources), limit};
+        g.wait();
+        for (auto i = std::size_t{}; i < num_irqs; ++i) {
+            while (sim_irqs.is_pending(static_cast<interrupt::irq_num_t>(i))) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    auto const seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+
+    auto const s = merged_stats();
+    std::printf("| %-8s | %10.0f | %10.0f | %7.2f%% | %7llu | %7llu | %9lu |"
+                " %8llu |\n",
+                l.name, l.rate_per_irq * num_irqs,
+                static_cast<double>(sim_irqs.serviced()) / seconds,
+                100.0 * static_cast<double>(sim_irqs.raised() -
+                                            sim_irqs.serviced()) /
+                    static_cast<double>(sim_irqs.raised()),
+                static_cast<unsigned long long>(quantile(s, 0.5)),
+                static_cast<unsigned long long>(quantile(s, 0.99)),
+                static_cast<unsigned long>(s.max_cycles),
+                static_cast<unsigned long long>(sim_irqs.preemptions()));
+}
+} // namespace
+
+int main() {
+    sim_irqs.attach(manager);
+    manager.init();
+
+    {
+        // the cost of the simulation itself, on one thread, against calling
+        // the manager directly
+        auto bench = ankerl::nanobench::Bench()
+                         .title("Dispatch, one thread")
+                         .unit("interrupt")
+                         .relative(true)
+                         .minEpochIterations(200'000);
+
+        bench.run("manager.run(n)", [&] { manager.run(irq_number<3>); });
+        bench.run("raise + service", [&] {
+            sim_irqs.raise(irq_number<3>);
+            sim_irqs.service();
+        });
+        bench.run("raise 8 + service", [&] {
+            for (auto i = std::size_t{}; i < num_irqs; ++i) {
+                sim_irqs.raise(static_cast<interrupt::irq_num_t>(i));
+            }
+            sim_irqs.service();
+        });
+    }
+
+    // latency is in ns from first raise to the start of the ISR, to the
+    // power of 2 above; merged interrupts were raised again while pending
+    std::printf("\n| %-8s | %10s | %10s | %8s | %7s | %7s | %9s | %8s |\n",
+                "load", "raised/s", "serviced/s", "merged", "p50 ns", "p99 ns",
+                "max ns", "preempts");
+    std::printf("|----------|------------|------------|----------|---------|"
+                "---------|-----------|----------|\n");
+    constexpr auto limit = std::uint64_t{100'000};
+    for (auto const &l : {
+             load{"poisson", interrupt::sim::arrival::poisson, 10'000},
+             load{"poisson", interrupt::sim::arrival::poisson, 100'000},
+             load{"poisson", interrupt::sim::arrival::poisson, 1'000'000},
+             load{"bursty", interrupt::sim::arrival::bursty, 10'000},
+             load{"bursty", interrupt::sim::arrival::bursty, 100'000},
+             load{"bursty", interrupt::sim::arrival::bursty, 1'000'000},
+         }) {
+        run_load(l, limit);
+    }
+    ankerl::nanobench::doNotOptimizeAway(isr_count);
+}
@@ -0,0 +1,127 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <interrupt/config.hpp>
+#include <interrupt/fwd.hpp>
+#include <interrupt/hal.hpp>
+#include <interrupt/manager.hpp>
+#include <interrupt/policies.hpp>
+
+#include <stdx/concepts.hpp>
+#include <stdx/utility.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include <nanobench.h>
+
+using interrupt::operator""_irq;
+
+namespace {
+struct bench_hal {
+    static auto init() -> void {}
+
+    template <bool, interrupt::irq_num_t, std::size_t>
+    static auto irq_init() -> void {}
+
+    template <interrupt::status_policy P>
+    static auto run(interrupt::irq_num_t, stdx::invocable auto const &isr)
+        -> void {
+        P::run([] {}, [&] { isr(); });
+    }
+};
+} // namespace
+template <> inline auto interrupt::injected_hal<> = bench_hal{};
+
+namespace {
+std::uint32_t isr_count{};
+
+template <std::size_t N> struct flow_t {
+    auto operator()() const -> void { ++isr_count; }
+    constexpr static bool active = true;
+};
+
+struct bench_nexus {
+    template <typename T> constexpr static auto service = T{};
+};
+
+// 16 IRQs spread over 0..60, as on an MCU where peripherals are sparse
+constexpr auto num_irqs = std::size_t{16};
+
+template <std::size_t I>
+constexpr auto irq_number = static_cast<interrupt::irq_num_t>(I * 4);
+
+template <std::size_t... Is>
+auto make_config(std::index_sequence<Is...>) -> interrupt::root<
+    interrupt::irq<irq_number<Is>, 1, interrupt::policies<>, flow_t<Is>>...>;
+
+using config_t =
+    decltype(make_config(std::make_index_sequence<num_irqs>{}));
+using manager_t = interrupt::manager<config_t, bench_nexus>;
+
+constexpr auto manager = manager_t{};
+
+// an IRQ number the compiler can't see through, as it would come from the
+// interrupt controller
+auto opaque(interrupt::irq_num_t n) -> interrupt::irq_num_t {
+    auto volatile v = n;
+    return v;
+}
+
+// what a port without a runtime entry point would have to write
+template <std::size_t... Is>
+auto run_by_cascade(interrupt::irq_num_t n, std::index_sequence<Is...>)
+    -> void {
+    (void)((n == irq_number<Is> and
+            (manager.template run<irq_number<Is>>(), true)) or
+           ...);
+}
+} // namespace
+
+int main() {
+    auto sequence = std::array<interrupt::irq_num_t, 64>{};
+    for (auto i = std::size_t{}; i < sequence.size(); ++i) {
+        // a scattered, repeatable order of the configured IRQs
+        sequence[i] = static_cast<interrupt::irq_num_t>(
+            (i * 7 % num_irqs) * 4);
+    }
+    constexpr auto last = irq_number<num_irqs - 1>;
+
+    {
+        auto bench = ankerl::nanobench::Bench()
+                         .title("One IRQ, always the same")
+                         .unit("interrupt")
+                         .relative(true)
+                         .minEpochIterations(1'000'000);
+
+        bench.run("run<N>()", [&] { manager.run<last>(); });
+        bench.run("run(n)", [&] { manager.run(opaque(last)); });
+        bench.run("if cascade", [&] {
+            run_by_cascade(opaque(last),
+                           std::make_index_sequence<num_irqs>{});
+        });
+    }
+
+    {
+        auto bench = ankerl::nanobench::Bench()
+                         .title("16 IRQs, in a scattered order")
+                         .unit("interrupt")
+                         .relative(true)
+                         .batch(sequence.size())
+                         .minEpochIterations(100'000);
+
+        bench.run("run(n)", [&] {
+            for (auto n : sequence) {
+                manager.run(opaque(n));
+            }
+        });
+        bench.run("if cascade", [&] {
+            for (auto n : sequence) {
+                run_by_cascade(opaque(n),
+                               std::make_index_sequence<num_irqs>{});
+            }
+        });
+    }
+    ankerl::nanobench::doNotOptimizeAway(isr_count);
+}
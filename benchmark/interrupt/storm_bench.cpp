@@ -0,0 +1,123 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <interrupt/config.hpp>
+#include <interrupt/dynamic_controller.hpp>
+#include <interrupt/fwd.hpp>
+#include <interrupt/hal.hpp>
+#include <interrupt/manager.hpp>
+#include <interrupt/policies.hpp>
+#include <interrupt/sim/registers.hpp>
+#include <interrupt/storm.hpp>
+
+#include <stdx/concepts.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <nanobench.h>
+
+using interrupt::operator""_irq;
+
+namespace {
+// a free-running counter, read as a cycle counter register would be
+std::uint32_t volatile cycles{};
+
+struct bench_hal {
+    static auto init() -> void {}
+
+    template <bool, interrupt::irq_num_t, std::size_t>
+    static auto irq_init() -> void {}
+
+    template <interrupt::status_policy P>
+    static auto run(interrupt::irq_num_t, stdx::invocable auto const &isr)
+        -> void {
+        P::run([] {}, [&] { isr(); });
+    }
+
+    static auto cycle_count() -> std::uint32_t { return cycles; }
+};
+} // namespace
+template <> inline auto interrupt::injected_hal<> = bench_hal{};
+
+namespace {
+std::uint32_t isr_count{};
+
+template <std::size_t N> struct flow_t {
+    auto operator()() const -> void { ++isr_count; }
+    constexpr static bool active = true;
+};
+
+struct bench_nexus {
+    template <typename T> constexpr static auto service = T{};
+};
+
+using enable_reg_t = interrupt::sim::reg<0>;
+using status_reg_t = interrupt::sim::reg<1>;
+using enable_t = enable_reg_t::field_t<0>;
+using status_t = status_reg_t::field_t<0>;
+
+constinit auto storms = interrupt::storm_monitor{};
+
+struct dynamic_t;
+constexpr auto max_per_window = std::uint32_t{2000};
+using guard_t =
+    interrupt::storm_guard<storms, dynamic_t, max_per_window, 1000>;
+
+template <typename Policies>
+using config_t = interrupt::root<interrupt::shared_irq<
+    17_irq, 4, interrupt::policies<>,
+    interrupt::sub_irq<enable_t, status_t, Policies, flow_t<0>>>>;
+
+using plain_config_t = config_t<interrupt::policies<>>;
+using guarded_config_t = config_t<interrupt::policies<guard_t>>;
+
+struct dynamic_t : interrupt::dynamic_controller<guarded_config_t> {};
+
+constexpr auto plain = interrupt::manager<plain_config_t, bench_nexus>{};
+constexpr auto guarded = interrupt::manager<guarded_config_t, bench_nexus>{};
+} // namespace
+
+int main() {
+    plain.init();
+    guarded.init();
+
+    {
+        auto bench = ankerl::nanobench::Bench()
+                         .title("Servicing a sub_irq")
+                         .unit("interrupt")
+                         .relative(true)
+                         .minEpochIterations(1'000'000);
+
+        // the counter advances once per interrupt, so neither ever storms
+        bench.run("unguarded", [&] {
+            cycles = cycles + 1;
+            apply(set(status_t{}));
+            plain.run<17_irq>();
+        });
+        bench.run("storm_guard, counting", [&] {
+            cycles = cycles + 1;
+            apply(set(status_t{}));
+            guarded.run<17_irq>();
+        });
+    }
+
+    {
+        // once an interrupt storms, each occurrence costs nothing until it is
+        // polled, and a poll services any number of occurrences at once
+        for (auto i = std::uint32_t{}; i <= max_per_window; ++i) {
+            apply(set(status_t{}));
+            guarded.run<17_irq>();
+        }
+
+        auto bench = ankerl::nanobench::Bench()
+                         .title("Servicing a storming sub_irq")
+                         .unit("poll")
+                         .minEpochIterations(1'000'000);
+
+        bench.run("storm_monitor::poll()", [&] {
+            apply(set(status_t{}));
+            storms.poll();
+        });
+    }
+    ankerl::nanobench::doNotOptimizeAway(isr_count);
+}
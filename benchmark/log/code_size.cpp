@@ -0,0 +1,93 @@
+// Log call sites whose compiled size is reported by the log_code_size target.
+// This file is compiled once for each logger, selected by LOG_CODE_SIZE_NULL,
+// LOG_CODE_SIZE_FMT or LOG_CODE_SIZE_BINARY; each call_site_ function holds
+// one log call. The transports call functions defined elsewhere, so that the
+// code measured is just what a call site needs. The binary logger is measured
+// twice: with IDs looked up by calls, and with IDs from a generated header.
+
+#include <log/log.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(LOG_CODE_SIZE_FMT)
+#include <log/fmt/logger.hpp>
+
+#include <iterator>
+
+extern "C" auto emit_char(char c) -> void;
+
+namespace {
+struct char_sink {
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+
+    auto operator*() -> char_sink & { return *this; }
+    auto operator++() -> char_sink & { return *this; }
+    auto operator++(int) -> char_sink { return *this; }
+    auto operator=(char c) -> char_sink & {
+        emit_char(c);
+        return *this;
+    }
+};
+} // namespace
+
+template <> inline auto logging::config<> = logging::fmt::config{char_sink{}};
+
+#elif defined(LOG_CODE_SIZE_BINARY)
+#include <log/catalog/encoder.hpp>
+
+#include <stdx/span.hpp>
+
+#include <array>
+
+extern "C" auto emit_words(std::uint32_t const *words, std::size_t n) -> void;
+extern "C" auto emit_bytes(std::uint8_t const *bytes, std::size_t n) -> void;
+
+namespace {
+struct transport {
+    using concurrent_t = void;
+
+    template <typename... Args>
+    auto log_by_args(std::uint32_t header, Args... args) -> void {
+        auto const words =
+            std::array{header, static_cast<std::uint32_t>(args)...};
+        emit_words(words.data(), words.size());
+    }
+    template <std::size_t N>
+    auto log_by_buf(stdx::span<std::uint8_t const, N> data) -> void {
+        emit_bytes(data.data(), data.size());
+    }
+};
+} // namespace
+
+template <>
+inline auto logging::config<> = logging::binary::config{transport{}};
+
+#elif !defined(LOG_CODE_SIZE_NULL)
+#error "Define LOG_CODE_SIZE_NULL, LOG_CODE_SIZE_FMT or LOG_CODE_SIZE_BINARY"
+#endif
+
+extern "C" {
+auto call_site_0_args() -> void { CIB_INFO("No arguments"); }
+
+auto call_site_1_arg(std::uint32_t a) -> void { CIB_INFO("One: {}", a); }
+
+auto call_site_2_args(std::uint32_t a, std::uint32_t b) -> void {
+    CIB_INFO("Two: {} {}", a, b);
+}
+
+auto call_site_4_args(std::uint32_t a, std::uint32_t b, std::uint32_t c,
+                      std::uint32_t d) -> void {
+    CIB_INFO("Four: {} {} {} {}", a, b, c, d);
+}
+
+auto call_site_8_bit_arg(std::uint8_t a) -> void { CIB_INFO("Byte: {}", a); }
+
+auto call_site_64_bit_arg(std::uint64_t a) -> void {
+    CIB_INFO("Wide: {}", a);
+}
+}
@@ -0,0 +1,77 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <log/catalog/encoder.hpp>
+#include <log/catalog/level_table.hpp>
+
+#include <stdx/ct_format.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+#include <nanobench.h>
+
+template <typename> auto catalog() -> string_id { return 42u; }
+template <typename> auto module() -> module_id { return 17u; }
+
+namespace {
+struct transport {
+    using concurrent_t = void;
+
+    template <typename... Args>
+    auto log_by_args(std::uint32_t header, Args... args) -> void {
+        auto x = header;
+        ((x ^= args), ...);
+        sink.fetch_add(x, std::memory_order_relaxed);
+    }
+    static inline std::atomic<std::uint32_t> sink{};
+};
+
+struct runtime_flavor_t;
+struct floor_flavor_t;
+
+template <logging::level L, typename Flavor = logging::default_flavor_t>
+using log_env =
+    stdx::make_env_t<logging::get_level, L, logging::get_flavor,
+                     stdx::type_identity<Flavor>{}>;
+} // namespace
+
+template <>
+inline auto logging::binary::levels<runtime_flavor_t> =
+    logging::binary::level_table<>{};
+template <>
+inline auto logging::binary::levels<floor_flavor_t> =
+    logging::binary::level_table<128, logging::level::INFO>{};
+
+int main() {
+    auto cfg = logging::binary::config{transport{}};
+    logging::binary::levels<runtime_flavor_t>.set(17, logging::level::WARN);
+
+    auto bench = ankerl::nanobench::Bench()
+                     .title("log level filtering")
+                     .unit("log call")
+                     .relative(true)
+                     .minEpochIterations(1'000'000);
+
+    auto i = std::uint32_t{};
+    bench.run("no level table, logged", [&] {
+        cfg.logger.log_msg<log_env<logging::level::TRACE>>(
+            stdx::ct_format<"{} {}">(i, i + 1));
+        ++i;
+    });
+    bench.run("level table, logged", [&] {
+        cfg.logger.log_msg<log_env<logging::level::ERROR, runtime_flavor_t>>(
+            stdx::ct_format<"{} {}">(i, i + 1));
+        ++i;
+    });
+    bench.run("level table, suppressed at runtime", [&] {
+        cfg.logger.log_msg<log_env<logging::level::TRACE, runtime_flavor_t>>(
+            stdx::ct_format<"{} {}">(i, i + 1));
+        ++i;
+    });
+    bench.run("level table, below compile-time floor", [&] {
+        cfg.logger.log_msg<log_env<logging::level::TRACE, floor_flavor_t>>(
+            stdx::ct_format<"{} {}">(i, i + 1));
+        ++i;
+    });
+    ankerl::nanobench::doNotOptimizeAway(transport::sink.load());
+}
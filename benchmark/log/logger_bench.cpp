@@ -0,0 +1,156 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <log/catalog/encoder.hpp>
+#include <log/fmt/logger.hpp>
+#include <log/level.hpp>
+#include <log/log.hpp>
+
+#include <stdx/ct_format.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nanobench.h>
+
+template <typename> auto catalog() -> string_id { return 42u; }
+template <typename> auto module() -> module_id { return 17u; }
+
+namespace {
+constexpr auto msgs_per_thread = std::size_t{1} << 14u;
+
+using log_env = stdx::make_env_t<logging::get_level, logging::level::TRACE>;
+
+// an fmt destination that discards its output
+struct null_sink {
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+
+    auto operator*() -> null_sink & { return *this; }
+    auto operator++() -> null_sink & { return *this; }
+    auto operator++(int) -> null_sink { return *this; }
+    auto operator=(char c) -> null_sink & {
+        ankerl::nanobench::doNotOptimizeAway(c);
+        return *this;
+    }
+};
+
+// a binary transport that discards its output
+template <bool Concurrent> struct null_transport {
+    template <typename... Args>
+    auto log_by_args(std::uint32_t header, Args... args) -> void {
+        auto x = header;
+        ((x ^= static_cast<std::uint32_t>(args)), ...);
+        sink.fetch_add(x, std::memory_order_relaxed);
+    }
+    template <std::size_t N>
+    auto log_by_buf(stdx::span<std::uint8_t const, N> data) -> void {
+        sink.fetch_add(static_cast<std::uint32_t>(data.size()),
+                       std::memory_order_relaxed);
+    }
+    static inline std::atomic<std::uint32_t> sink{};
+};
+
+template <> struct null_transport<true> : null_transport<false> {
+    using concurrent_t = void;
+};
+
+auto run_threads(std::size_t num_threads, auto &&log) -> void {
+    auto threads = std::vector<std::thread>{};
+    for (auto t = std::size_t{}; t < num_threads; ++t) {
+        threads.emplace_back([&, t] {
+            for (auto i = std::size_t{}; i < msgs_per_thread; ++i) {
+                log(static_cast<std::uint32_t>(t),
+                    static_cast<std::uint32_t>(i));
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+}
+
+// One log call of each shape: argument counts, then argument widths.
+template <typename Logger>
+auto bench_calls(ankerl::nanobench::Bench &bench, std::string const &name,
+                 Logger &logger) -> void {
+    auto i = std::uint32_t{};
+    auto const log = [&](auto const &fr) {
+        logger.template log<log_env>(__FILE__, __LINE__, fr);
+        ++i;
+    };
+
+    bench.run(name + ", 0 args", [&] { log(stdx::ct_format<"Hello">()); });
+    bench.run(name + ", 1 arg", [&] { log(stdx::ct_format<"{}">(i)); });
+    bench.run(name + ", 2 args",
+              [&] { log(stdx::ct_format<"{} {}">(i, i + 1)); });
+    bench.run(name + ", 4 args", [&] {
+        log(stdx::ct_format<"{} {} {} {}">(i, i + 1, i + 2, i + 3));
+    });
+    bench.run(name + ", 8 args", [&] {
+        log(stdx::ct_format<"{} {} {} {} {} {} {} {}">(
+            i, i + 1, i + 2, i + 3, i + 4, i + 5, i + 6, i + 7));
+    });
+
+    bench.run(name + ", 8-bit arg", [&] {
+        log(stdx::ct_format<"{}">(static_cast<std::uint8_t>(i)));
+    });
+    bench.run(name + ", 64-bit arg", [&] {
+        log(stdx::ct_format<"{}">(std::uint64_t{i} << 32u | i));
+    });
+    bench.run(name + ", double arg",
+              [&] { log(stdx::ct_format<"{}">(static_cast<double>(i))); });
+}
+} // namespace
+
+int main() {
+    auto null_cfg = logging::null::config{};
+    auto fmt_cfg = logging::fmt::config{null_sink{}};
+    auto binary_cfg = logging::binary::config{null_transport<true>{}};
+
+    auto bench = ankerl::nanobench::Bench()
+                     .title("log call latency")
+                     .unit("log call")
+                     .relative(true)
+                     .minEpochIterations(100'000);
+    bench_calls(bench, "null", null_cfg.logger);
+    bench_calls(bench, "fmt", fmt_cfg.logger);
+    bench_calls(bench, "binary", binary_cfg.logger);
+
+    auto locked_cfg = logging::binary::config{null_transport<false>{}};
+
+    auto contention = ankerl::nanobench::Bench()
+                          .title("log_writer contention")
+                          .unit("log call")
+                          .relative(true)
+                          .minEpochIterations(3);
+
+    for (auto threads : {1u, 2u, 4u, 8u}) {
+        contention.batch(threads * msgs_per_thread);
+
+        contention.run(
+            "critical section, " + std::to_string(threads) + " threads", [&] {
+                run_threads(threads, [&](auto t, auto i) {
+                    locked_cfg.logger.log_msg<log_env>(
+                        stdx::ct_format<"{} {}">(t, i));
+                });
+            });
+
+        contention.run(
+            "concurrent transport, " + std::to_string(threads) + " threads",
+            [&] {
+                run_threads(threads, [&](auto t, auto i) {
+                    binary_cfg.logger.log_msg<log_env>(
+                        stdx::ct_format<"{} {}">(t, i));
+                });
+            });
+    }
+    ankerl::nanobench::doNotOptimizeAway(null_transport<false>::sink.load());
+}
@@ -0,0 +1,124 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <log/catalog/encoder.hpp>
+#include <log/persistent_ring.hpp>
+
+#include <stdx/bit.hpp>
+#include <stdx/ct_format.hpp>
+#include <stdx/span.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <nanobench.h>
+
+template <typename> auto catalog() -> string_id { return 42u; }
+template <typename> auto module() -> module_id { return 17u; }
+
+namespace {
+constexpr auto msgs_per_thread = std::size_t{1} << 14u;
+constexpr auto num_records = std::size_t{1} << 16u;
+
+using log_env = stdx::make_env_t<logging::get_level, logging::level::TRACE>;
+using ring_t = logging::persistent_ring<64>;
+
+// writes each record to a file with a system call
+struct write_destination {
+    template <typename... Args>
+    auto log_by_args(std::uint32_t header, Args... args) -> void {
+        auto const words =
+            std::array{stdx::to_le(header),
+                       stdx::to_le(static_cast<std::uint32_t>(args))...};
+        write(words.data(), sizeof(words));
+    }
+    auto log_by_buf(stdx::span<std::uint8_t const> data) -> void {
+        write(data.data(), data.size());
+    }
+    auto write(void const *data, std::size_t size) const -> void {
+        ankerl::nanobench::doNotOptimizeAway(::write(fd, data, size));
+    }
+    int fd;
+};
+
+auto temp_file() -> int {
+    char name[] = "/tmp/persistent_benchXXXXXX";
+    auto const fd = ::mkstemp(name);
+    if (fd < 0) {
+        std::abort();
+    }
+    ::unlink(name);
+    return fd;
+}
+
+auto run_threads(std::size_t num_threads, auto &&log) -> void {
+    auto threads = std::vector<std::thread>{};
+    for (auto t = std::size_t{}; t < num_threads; ++t) {
+        threads.emplace_back([&, t] {
+            for (auto i = std::size_t{}; i < msgs_per_thread; ++i) {
+                log(static_cast<std::uint32_t>(t),
+                    static_cast<std::uint32_t>(i));
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+}
+} // namespace
+
+int main() {
+    auto const ring_fd = temp_file();
+    auto const ring_bytes = ring_t::bytes_for(num_records);
+    if (::ftruncate(ring_fd, static_cast<off_t>(ring_bytes)) != 0) {
+        return 1;
+    }
+    auto const memory = ::mmap(nullptr, ring_bytes, PROT_READ | PROT_WRITE,
+                               MAP_SHARED, ring_fd, 0);
+    if (memory == MAP_FAILED) {
+        return 1;
+    }
+    auto ring = ring_t{memory, ring_bytes};
+    auto ring_cfg = logging::binary::config{ring.destination()};
+
+    auto const write_fd = temp_file();
+    auto write_cfg = logging::binary::config{write_destination{write_fd}};
+
+    auto bench = ankerl::nanobench::Bench()
+                     .title("crash-persistent logging")
+                     .unit("log call")
+                     .relative(true)
+                     .minEpochIterations(3);
+
+    for (auto threads : {1u, 2u, 4u, 8u}) {
+        bench.batch(threads * msgs_per_thread);
+
+        bench.run("write(), " + std::to_string(threads) + " threads", [&] {
+            ::lseek(write_fd, 0, SEEK_SET);
+            run_threads(threads, [&](auto t, auto i) {
+                write_cfg.logger.log_msg<log_env>(
+                    stdx::ct_format<"{} {}">(t, i));
+            });
+        });
+
+        bench.run("mapped ring, " + std::to_string(threads) + " threads",
+                  [&] {
+                      run_threads(threads, [&](auto t, auto i) {
+                          ring_cfg.logger.log_msg<log_env>(
+                              stdx::ct_format<"{} {}">(t, i));
+                      });
+                  });
+    }
+
+    ::munmap(memory, ring_bytes);
+    ::close(ring_fd);
+    ::close(write_fd);
+}
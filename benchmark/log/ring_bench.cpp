@@ -0,0 +1,104 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <log/catalog/encoder.hpp>
+#include <log/catalog/ring_destination.hpp>
+
+#include <stdx/ct_format.hpp>
+#include <stdx/span.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nanobench.h>
+
+template <typename> auto catalog() -> string_id { return 42u; }
+template <typename> auto module() -> module_id { return 17u; }
+
+namespace {
+constexpr auto msgs_per_thread = std::size_t{1} << 14u;
+
+using log_env = stdx::make_env_t<logging::get_level, logging::level::TRACE>;
+
+// stands in for a slow-ish transport (e.g. a trace port)
+struct transport {
+    template <typename... Args>
+    auto log_by_args(std::uint32_t header, Args... args) -> void {
+        auto x = header;
+        ((x ^= args), ...);
+        for (auto i = 0; i < 16; ++i) {
+            x = x * 1664525u + 1013904223u;
+        }
+        sink.fetch_add(x, std::memory_order_relaxed);
+    }
+    auto log_by_buf(stdx::span<std::uint8_t const> data) -> void {
+        sink.fetch_add(data.size(), std::memory_order_relaxed);
+    }
+    static inline std::atomic<std::uint32_t> sink{};
+};
+
+auto run_threads(std::size_t num_threads, auto &&log) -> void {
+    auto threads = std::vector<std::thread>{};
+    for (auto t = std::size_t{}; t < num_threads; ++t) {
+        threads.emplace_back([&, t] {
+            for (auto i = std::size_t{}; i < msgs_per_thread; ++i) {
+                log(static_cast<std::uint32_t>(t),
+                    static_cast<std::uint32_t>(i));
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+}
+
+using rings_t = logging::binary::per_core_rings<16, 4096>;
+rings_t rings{};
+} // namespace
+
+int main() {
+    auto locked_cfg = logging::binary::config{transport{}};
+    auto ring_cfg = logging::binary::config{rings.destination()};
+
+    auto bench = ankerl::nanobench::Bench()
+                     .title("binary logger contention")
+                     .unit("log call")
+                     .relative(true)
+                     .minEpochIterations(3);
+
+    for (auto threads : {1u, 2u, 4u, 8u, 16u}) {
+        bench.batch(threads * msgs_per_thread);
+
+        bench.run("critical section, " + std::to_string(threads) + " threads",
+                  [&] {
+                      run_threads(threads, [&](auto t, auto i) {
+                          locked_cfg.logger.log_msg<log_env>(
+                              stdx::ct_format<"{} {}">(t, i));
+                      });
+                  });
+
+        bench.run("per-core rings, " + std::to_string(threads) + " threads",
+                  [&] {
+                      auto done = std::atomic<bool>{};
+                      auto drainer = std::thread{[&] {
+                          auto t = transport{};
+                          while (not done.load(std::memory_order_relaxed)) {
+                              if (rings.drain(t) == 0) {
+                                  std::this_thread::yield();
+                              }
+                          }
+                          rings.drain(t);
+                      }};
+                      run_threads(threads, [&](auto t, auto i) {
+                          ring_cfg.logger.log_msg<log_env>(
+                              stdx::ct_format<"{} {}">(t, i));
+                      });
+                      done = true;
+                      drainer.join();
+                  });
+    }
+    ankerl::nanobench::doNotOptimizeAway(rings.num_dropped());
+}
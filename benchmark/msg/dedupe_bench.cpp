@@ -0,0 +1,113 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <msg/dedupe_cache.hpp>
+#include <msg/field.hpp>
+#include <msg/message.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <nanobench.h>
+
+using namespace msg;
+
+using conn_f = field<"conn", std::uint32_t>::located<at{0_dw, 15_msb, 0_lsb}>;
+using type_f = field<"type", std::uint8_t>::located<at{0_dw, 23_msb, 16_lsb}>;
+using seq_f = field<"seq", std::uint32_t>::located<at{1_dw, 31_msb, 0_lsb}>;
+using small_defn = message<"small", conn_f, type_f, seq_f>;
+
+// a larger message: the same header followed by payload words, each with a
+// reserved (don't care) byte
+template <stdx::ct_string Name, std::uint32_t DW>
+using payload_f =
+    field<Name, std::uint32_t>::located<at{dword_index_t{DW}, 23_msb, 0_lsb}>;
+using large_defn =
+    message<"large", conn_f, type_f, seq_f, payload_f<"p0", 2>,
+            payload_f<"p1", 3>, payload_f<"p2", 4>, payload_f<"p3", 5>,
+            payload_f<"p4", 6>, payload_f<"p5", 7>, payload_f<"p6", 8>,
+            payload_f<"p7", 9>, payload_f<"p8", 10>, payload_f<"p9", 11>,
+            payload_f<"p10", 12>, payload_f<"p11", 13>, payload_f<"p12", 14>,
+            payload_f<"p13", 15>>;
+
+constexpr auto trace_length = std::size_t{1} << 16u;
+
+// field-by-field equivalence, as msg::equivalent used to do it
+template <typename Defn>
+auto fieldwise_equivalent(auto const &lhs, auto const &rhs) -> bool {
+    return []<typename... Fields>(stdx::type_list<Fields...>, auto const &l,
+                                  auto const &r) {
+        return (... and (l.get(Fields{}) == r.get(Fields{})));
+    }(typename Defn::fields_t{}, lhs, rhs);
+}
+
+// a trace of messages where about a third are retransmissions of a recent one
+template <typename Defn> auto make_trace() {
+    auto rng = std::mt19937{42};
+    auto trace = std::vector<owning<Defn>>{};
+    trace.reserve(trace_length);
+    for (auto i = std::size_t{}; i < trace_length; ++i) {
+        if (i > 64 and rng() % 3 == 0) {
+            trace.push_back(trace[i - 1 - rng() % 64]);
+            continue;
+        }
+        auto m = owning<Defn>{"conn"_f = rng() & 0xffffu,
+                              "seq"_f = static_cast<std::uint32_t>(i)};
+        auto d = m.data();
+        for (auto j = std::size_t{2}; j < d.size(); ++j) {
+            d[j] = static_cast<std::uint32_t>(rng());
+        }
+        trace.push_back(m);
+    }
+    return trace;
+}
+
+template <typename Defn> auto bench_msg(char const *name) -> void {
+    auto const trace = make_trace<Defn>();
+    auto bench = ankerl::nanobench::Bench()
+                     .title(std::string{"dedupe ("} + name + " message)")
+                     .unit("msg")
+                     .batch(trace.size() - 1)
+                     .relative(true)
+                     .minEpochIterations(10);
+
+    bench.run("fieldwise equivalent", [&] {
+        auto n = std::size_t{};
+        for (auto i = std::size_t{1}; i < trace.size(); ++i) {
+            n += fieldwise_equivalent<Defn>(trace[i - 1], trace[i]) ? 1 : 0;
+        }
+        ankerl::nanobench::doNotOptimizeAway(n);
+    });
+
+    bench.run("masked equivalent", [&] {
+        auto n = std::size_t{};
+        for (auto i = std::size_t{1}; i < trace.size(); ++i) {
+            n += equivalent(trace[i - 1], trace[i]) ? 1 : 0;
+        }
+        ankerl::nanobench::doNotOptimizeAway(n);
+    });
+
+    bench.run("hash", [&] {
+        auto h = std::uint64_t{};
+        for (auto i = std::size_t{1}; i < trace.size(); ++i) {
+            h ^= msg::hash(trace[i]);
+        }
+        ankerl::nanobench::doNotOptimizeAway(h);
+    });
+
+    bench.run("dedupe_cache insert", [&] {
+        auto cache = dedupe_cache<Defn, 256>{};
+        auto n = std::size_t{};
+        for (auto i = std::size_t{1}; i < trace.size(); ++i) {
+            n += cache.insert(trace[i]) ? 1 : 0;
+        }
+        ankerl::nanobench::doNotOptimizeAway(n);
+    });
+}
+
+int main() {
+    bench_msg<small_defn>("small");
+    bench_msg<large_defn>("large");
+}
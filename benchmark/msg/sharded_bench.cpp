@@ -0,0 +1,121 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <cib/cib.hpp>
+#include <match/constant.hpp>
+#include <msg/callback.hpp>
+#include <msg/field.hpp>
+#include <msg/message.hpp>
+#include <msg/sharded_service.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nanobench.h>
+
+using namespace msg;
+
+using conn_f = field<"conn", std::uint32_t>::located<at{0_dw, 31_msb, 0_lsb}>;
+using seq_f = field<"seq", std::uint32_t>::located<at{1_dw, 31_msb, 0_lsb}>;
+using payload_f =
+    field<"payload", std::uint32_t>::located<at{2_dw, 31_msb, 0_lsb}>;
+
+using msg_defn = message<"bench_msg", conn_f, seq_f, payload_f>;
+using msg_t = owning<msg_defn>;
+
+constexpr auto max_threads = std::size_t{16};
+constexpr auto num_connections = std::uint32_t{4096};
+constexpr auto trace_length = std::size_t{1} << 20u;
+
+using spec_t = shard_spec<conn_f, max_threads, 4096>;
+struct test_sharded_service : sharded_service<spec_t, msg_t> {};
+
+std::atomic<std::uint64_t> work_sink{};
+
+// simulate a handler that does a little work per message
+constexpr auto cb = msg::callback<"callback", msg_defn>(
+    match::always, [](msg::const_view<msg_defn> m) {
+        auto x = std::uint64_t{m.get("payload"_f)};
+        for (auto i = 0; i < 64; ++i) {
+            x = x * 6364136223846793005ull + 1442695040888963407ull;
+        }
+        work_sink.fetch_add(x, std::memory_order_relaxed);
+    });
+
+struct test_project {
+    constexpr static auto config =
+        cib::config(cib::exports<test_sharded_service>,
+                    cib::extend<test_sharded_service>(cb));
+};
+
+auto make_trace() {
+    // a skewed connection distribution, as seen by a real gateway
+    auto rng = std::mt19937{42};
+    auto dist = std::geometric_distribution<std::uint32_t>{0.002};
+    auto trace = std::vector<msg_t>{};
+    trace.reserve(trace_length);
+    for (auto i = std::size_t{}; i < trace_length; ++i) {
+        trace.push_back(msg_t{"conn"_f = dist(rng) % num_connections,
+                              "seq"_f = static_cast<std::uint32_t>(i),
+                              "payload"_f = static_cast<std::uint32_t>(rng())});
+    }
+    return trace;
+}
+
+auto replay(std::vector<msg_t> const &trace, std::size_t num_threads) -> void {
+    auto const &svc = *cib::service<test_sharded_service>;
+    auto processed = std::atomic<std::size_t>{};
+
+    auto workers = std::vector<std::thread>{};
+    for (auto t = std::size_t{}; t < num_threads; ++t) {
+        workers.emplace_back([&, t] {
+            while (processed.load(std::memory_order_relaxed) < trace.size()) {
+                auto n = std::size_t{};
+                for (auto s = t; s < svc.num_shards(); s += num_threads) {
+                    n += svc.process(s);
+                }
+                if (n == 0) {
+                    std::this_thread::yield();
+                } else {
+                    processed.fetch_add(n, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    for (auto const &m : trace) {
+        // with one producer, a change in dropped() means m was dropped
+        auto dropped = svc.dropped();
+        static_cast<void>(svc.handle(m));
+        while (svc.dropped() != dropped) {
+            std::this_thread::yield();
+            dropped = svc.dropped();
+            static_cast<void>(svc.handle(m));
+        }
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+}
+
+int main() {
+    cib::nexus<test_project> test_nexus{};
+    test_nexus.init();
+
+    auto const trace = make_trace();
+    auto bench = ankerl::nanobench::Bench()
+                     .title("sharded_service replay")
+                     .unit("msg")
+                     .batch(trace.size())
+                     .relative(true)
+                     .minEpochIterations(3);
+
+    for (auto threads : {1u, 2u, 4u, 8u, 16u}) {
+        bench.run(std::to_string(threads) + " threads",
+                  [&] { replay(trace, threads); });
+    }
+}
@@ -2,6 +2,7 @@ function(gen_str_catalog)
     set(options FORGET_OLD_IDS)
     set(oneValueArgs
         OUTPUT_CPP
+        OUTPUT_HPP
         OUTPUT_XML
         OUTPUT_JSON
         GEN_STR_CATALOG
@@ -64,6 +65,9 @@ function(gen_str_catalog)
     if(SC_GUID_MASK)
         set(GUID_MASK_ARG --guid_mask ${SC_GUID_MASK})
     endif()
+    if(SC_OUTPUT_HPP)
+        set(HPP_OUTPUT_ARG --hpp_output ${SC_OUTPUT_HPP})
+    endif()
     if(SC_MODULE_ID_MAX)
         set(MODULE_ID_MAX_ARG --module_id_max ${SC_MODULE_ID_MAX})
     endif()
@@ -72,14 +76,15 @@ function(gen_str_catalog)
     endif()
 
     add_custom_command(
-        OUTPUT ${SC_OUTPUT_CPP} ${SC_OUTPUT_JSON} ${SC_OUTPUT_XML}
+        OUTPUT ${SC_OUTPUT_CPP} ${SC_OUTPUT_HPP} ${SC_OUTPUT_JSON}
+               ${SC_OUTPUT_XML}
         COMMAND
             ${Python3_EXECUTABLE} ${SC_GEN_STR_CATALOG} --input ${UNDEFS}
             --json_input ${INPUT_JSON} --cpp_headers ${INPUT_HEADERS}
             --cpp_output ${SC_OUTPUT_CPP} --json_output ${SC_OUTPUT_JSON}
             --xml_output ${SC_OUTPUT_XML} --stable_json ${STABLE_JSON}
             ${FORGET_ARG} ${CLIENT_NAME_ARG} ${VERSION_ARG} ${GUID_ID_ARG}
-            ${GUID_MASK_ARG} ${MODULE_ID_MAX_ARG}
+            ${GUID_MASK_ARG} ${MODULE_ID_MAX_ARG} ${HPP_OUTPUT_ARG}
         DEPENDS ${UNDEFS} ${INPUT_JSON} ${SC_GEN_STR_CATALOG} ${STABLE_JSON}
         COMMAND_EXPAND_LISTS)
 
@@ -88,3 +93,13 @@ function(gen_str_catalog)
         target_link_libraries(${SC_OUTPUT_LIB} PUBLIC cib)
     endif()
 endfunction()
+
+# Second pass: compile TARGET with string and module IDs taken from the header
+# generated by gen_str_catalog(OUTPUT_HPP ...), so that they are compile-time
+# constants. The definition is public: everything linked with TARGET must be
+# built the same way.
+function(target_use_str_catalog_header TARGET HEADER)
+    target_sources(${TARGET} PRIVATE ${HEADER})
+    target_compile_definitions(${TARGET}
+                               PUBLIC CIB_LOG_CATALOG_HEADER="${HEADER}")
+endfunction()
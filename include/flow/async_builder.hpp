@@ -0,0 +1,232 @@
+#pragma once
+
+#include <async/concepts.hpp>
+#include <async/just.hpp>
+#include <async/just_result_of.hpp>
+#include <async/let_value.hpp>
+#include <async/sequence.hpp>
+#include <async/sync_wait.hpp>
+#include <async/then.hpp>
+#include <async/variant_sender.hpp>
+#include <async/when_all.hpp>
+#include <flow/common.hpp>
+#include <flow/graph_builder.hpp>
+#include <flow/impl.hpp>
+#include <flow/log.hpp>
+#include <flow/parallel_builder.hpp>
+#include <log/log.hpp>
+
+#include <stdx/compiler.hpp>
+#include <stdx/ct_format.hpp>
+#include <stdx/ct_string.hpp>
+#include <stdx/panic.hpp>
+#include <stdx/tuple.hpp>
+#include <stdx/tuple_algorithms.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace flow {
+namespace detail {
+/**
+ * A step as a sender. A step that returns a sender completes when that
+ * sender does, and its values are dropped; a step that returns void
+ * completes when it returns.
+ */
+template <stdx::ct_string FlowName, typename CTNode>
+[[nodiscard]] constexpr auto step_sender() -> async::sender auto {
+    using func_t = typename CTNode::func_t;
+    if constexpr (std::is_void_v<std::invoke_result_t<func_t>>) {
+        return async::just_result_of(run_func<FlowName, CTNode>);
+    } else {
+        static_assert(async::sender<std::invoke_result_t<func_t>>,
+                      "An async flow step must return void or a sender");
+        return async::just() | async::let_value([] {
+                   return async::make_variant_sender(
+                       static_cast<bool>(CTNode::condition),
+                       [] {
+                           log_node<FlowName, CTNode>();
+                           return func_t{}() | async::then([](auto &&...) {});
+                       },
+                       [] { return async::just(); });
+               });
+    }
+}
+
+// the length of the longest path to each node: nodes at the same level do
+// not depend on one another
+template <std::size_t NumNodes, std::size_t NumEdges>
+[[nodiscard]] constexpr auto levels(dag<NumNodes, NumEdges> const &d)
+    -> std::array<std::size_t, NumNodes> {
+    std::array<std::size_t, NumNodes> l{};
+    for (auto i = std::size_t{}; i < NumNodes; ++i) {
+        for (auto e = d.successor_offsets[i]; e < d.successor_offsets[i + 1];
+             ++e) {
+            auto const j = d.successors[e];
+            l[j] = std::max(l[j], l[i] + 1);
+        }
+    }
+    return l;
+}
+
+// the level of each of Nodes, found by the node Output creates for it
+template <typename Output, typename Nodes, std::size_t NumNodes,
+          std::size_t NumEdges>
+[[nodiscard]] constexpr auto node_levels(dag<NumNodes, NumEdges> const &d)
+    -> std::array<std::size_t, NumNodes> {
+    auto const l = levels(d);
+    auto const level_of = [&](auto node) {
+        return l[static_cast<std::size_t>(
+            std::distance(std::begin(d.nodes),
+                          std::find(std::begin(d.nodes), std::end(d.nodes),
+                                    node)))];
+    };
+
+    std::array<std::size_t, NumNodes> result{};
+    [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        ((result[Is] = level_of(Output::create_node(
+              stdx::tuple_element_t<Is, Nodes>{}))),
+         ...);
+    }(std::make_index_sequence<NumNodes>{});
+    return result;
+}
+
+// the indices of the nodes at a level
+template <std::size_t Level, std::size_t Count, std::size_t NumNodes>
+[[nodiscard]] constexpr auto
+level_members(std::array<std::size_t, NumNodes> const &levels)
+    -> std::array<std::size_t, Count> {
+    std::array<std::size_t, Count> members{};
+    auto m = std::begin(members);
+    for (auto i = std::size_t{}; i < NumNodes; ++i) {
+        if (levels[i] == Level) {
+            *m++ = i;
+        }
+    }
+    return members;
+}
+} // namespace detail
+
+/**
+ * Renders a flow into a sender. A step may return a sender -- to wait for
+ * I/O, a timer, or an interrupt -- and the flow waits for it without
+ * blocking the steps that do not depend on it.
+ *
+ * Each step is placed at a level: one more than the highest level of the
+ * steps it depends on. The steps at a level run together under
+ * async::when_all, and the levels run in sequence, so the waits of
+ * independent steps overlap. A step does wait for every step at lower
+ * levels, not only those it depends on.
+ *
+ * Running the flow through its FunctionPtr waits for the sender with
+ * async::sync_wait; sender() gives the sender itself to compose or await.
+ *
+ * @tparam Name The name of the flow, for logging.
+ * @tparam Impl As for graph_builder.
+ */
+template <stdx::ct_string Name,
+          template <stdx::ct_string, std::size_t> typename Impl>
+struct async_graph_builder {
+    using dag_builder_t = parallel_graph_builder<Name, Impl>;
+
+    template <typename Initialized> class built_flow {
+        using graph_t = std::remove_cvref_t<decltype(Initialized::value)>;
+        using nodes_t = decltype(stdx::to_unsorted_set(
+            flow::dsl::get_nodes(Initialized::value)));
+
+        constexpr static auto flow_dag =
+            dag_builder_t::template build_dag<Initialized>();
+        constexpr static auto num_nodes = std::size(flow_dag.nodes);
+
+        using output_t = Impl<graph_t::name, num_nodes>;
+
+        constexpr static auto levels =
+            detail::node_levels<output_t, nodes_t>(flow_dag);
+        constexpr static auto num_levels =
+            num_nodes == 0
+                ? std::size_t{}
+                : *std::max_element(std::begin(levels), std::end(levels)) + 1;
+
+        template <std::size_t Level>
+        [[nodiscard]] constexpr static auto level_sender()
+            -> async::sender auto {
+            constexpr auto count = static_cast<std::size_t>(
+                std::count(std::begin(levels), std::end(levels), Level));
+            constexpr auto members =
+                detail::level_members<Level, count>(levels);
+
+            return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                return async::when_all(
+                    detail::step_sender<
+                        graph_t::name,
+                        stdx::tuple_element_t<members[Is], nodes_t>>()...);
+            }(std::make_index_sequence<count>{});
+        }
+
+        static auto log_start() -> void {
+            if constexpr (not Name.empty()) {
+                logging::log<decltype(get_log_env<built_flow>())>(
+                    __FILE__, __LINE__,
+                    stdx::ct_format<"flow.start({})">(stdx::cts_t<Name>{}));
+            }
+        }
+
+        static auto log_end() -> void {
+            if constexpr (not Name.empty()) {
+                logging::log<decltype(get_log_env<built_flow>())>(
+                    __FILE__, __LINE__,
+                    stdx::ct_format<"flow.end({})">(stdx::cts_t<Name>{}));
+            }
+        }
+
+        static auto run() -> void {
+            static_cast<void>(async::sync_wait(sender()));
+        }
+
+      public:
+        constexpr static auto ct_name = Name;
+
+        /**
+         * @return A sender that runs the flow when started, and completes
+         * with no values once every step has.
+         */
+        [[nodiscard]] constexpr static auto sender() -> async::sender auto {
+            return [&]<std::size_t... Ls>(std::index_sequence<Ls...>) {
+                return (async::just_result_of(log_start) | ... |
+                        async::seq(level_sender<Ls>())) |
+                       async::then(log_end);
+            }(std::make_index_sequence<num_levels>{});
+        }
+
+        // NOLINTNEXTLINE(google-explicit-constructor)
+        constexpr explicit(false) operator FunctionPtr() const { return run; }
+        auto operator()() const -> void { run(); }
+        constexpr static bool active = num_nodes > 0;
+    };
+
+    template <typename Initialized>
+    [[nodiscard]] constexpr static auto render() -> built_flow<Initialized> {
+        return {};
+    }
+};
+
+template <stdx::ct_string Name = "">
+using async_builder = graph<Name, async_graph_builder<Name, impl>>;
+
+template <stdx::ct_string Name = ""> struct async_service {
+    using builder_t = async_builder<Name>;
+    using interface_t = FunctionPtr;
+
+    CONSTEVAL static auto uninitialized() -> interface_t {
+        return [] {
+            using namespace stdx::literals;
+            stdx::panic<"Attempting to run flow ("_cts + Name +
+                        ") before it is initialized"_cts>();
+        };
+    }
+};
+} // namespace flow
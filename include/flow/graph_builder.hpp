@@ -206,8 +206,9 @@ struct graph_builder {
             Name, dup_nodes);
     }
 
+    // the flow's nodes and their successors, checked but not yet sorted
     template <typename Graph>
-    [[nodiscard]] constexpr static auto build(Graph const &input) {
+    [[nodiscard]] constexpr static auto build_graph(Graph const &input) {
         auto nodes = flow::dsl::get_nodes(input);
         auto mentioned_nodes = flow::dsl::get_all_mentioned_nodes(input);
 
@@ -228,8 +229,14 @@ struct graph_builder {
                 node_set),
             "Output node type is not compatible with given input nodes");
 
-        auto g =
-            make_graph<output_t, node_capacity, edge_capacity>(node_set, edges);
+        return make_graph<output_t, node_capacity, edge_capacity>(node_set,
+                                                                  edges);
+    }
+
+    template <typename Graph>
+    [[nodiscard]] constexpr static auto build(Graph const &input) {
+        auto g = build_graph(input);
+        using output_t = Impl<Graph::name, decltype(g)::capacity()>;
         return topo_sort<output_t>(g);
     }
 
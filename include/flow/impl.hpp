@@ -16,16 +16,20 @@
 
 namespace flow {
 namespace detail {
+template <stdx::ct_string FlowName, typename CTNode>
+constexpr auto log_node() -> void {
+    if constexpr (not FlowName.empty()) {
+        logging::log<decltype(get_log_env<CTNode, log_env_id_t<FlowName>>())>(
+            __FILE__, __LINE__,
+            stdx::ct_format<"flow.{}({})">(stdx::cts_t<CTNode::ct_type>{},
+                                           stdx::cts_t<CTNode::ct_name>{}));
+    }
+}
+
 template <stdx::ct_string FlowName, typename CTNode>
 constexpr auto run_func() -> void {
     if (CTNode::condition) {
-        if constexpr (not FlowName.empty()) {
-            logging::log<
-                decltype(get_log_env<CTNode, log_env_id_t<FlowName>>())>(
-                __FILE__, __LINE__,
-                stdx::ct_format<"flow.{}({})">(stdx::cts_t<CTNode::ct_type>{},
-                                               stdx::cts_t<CTNode::ct_name>{}));
-        }
+        log_node<FlowName, CTNode>();
         typename CTNode::func_t{}();
     }
 }
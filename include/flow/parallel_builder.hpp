@@ -0,0 +1,256 @@
+#pragma once
+
+#include <flow/common.hpp>
+#include <flow/graph_builder.hpp>
+#include <flow/impl.hpp>
+#include <flow/log.hpp>
+#include <flow/work_stealing_pool.hpp>
+#include <log/log.hpp>
+
+#include <stdx/compiler.hpp>
+#include <stdx/ct_format.hpp>
+#include <stdx/ct_string.hpp>
+#include <stdx/cx_multimap.hpp>
+#include <stdx/panic.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace flow {
+namespace detail {
+/**
+ * A flow as a DAG: its nodes in a topological order, how many predecessors
+ * each has, and the successors of each, by index. The successors of node i
+ * are successors[successor_offsets[i]] to successors[successor_offsets[i+1]].
+ */
+template <std::size_t NumNodes, std::size_t NumEdges> struct dag {
+    std::array<FunctionPtr, NumNodes> nodes{};
+    std::array<std::size_t, NumNodes> predecessor_counts{};
+    std::array<std::size_t, NumNodes + 1> successor_offsets{};
+    std::array<std::size_t, NumEdges> successors{};
+
+    [[nodiscard]] constexpr auto num_edges() const -> std::size_t {
+        return successor_offsets[NumNodes];
+    }
+};
+
+// the most edges a graph_builder graph can hold
+template <typename Graph> struct edge_capacity;
+template <typename K, typename V, std::size_t N, std::size_t E>
+struct edge_capacity<stdx::cx_multimap<K, V, N, E>>
+    : std::integral_constant<std::size_t, N * E> {};
+
+template <typename Dag, typename Order, typename Graph>
+[[nodiscard]] constexpr auto to_dag(Order const &order, Graph const &g)
+    -> Dag {
+    auto const index_of = [&](auto node) {
+        return static_cast<std::size_t>(
+            std::distance(std::begin(order), std::find(std::begin(order),
+                                                       std::end(order), node)));
+    };
+
+    Dag d{};
+    auto edge = std::size_t{};
+    for (auto i = std::size_t{}; i < std::size(order); ++i) {
+        d.nodes[i] = order[i];
+        d.successor_offsets[i] = edge;
+        auto const it = std::find_if(
+            g.begin(), g.end(),
+            [&](auto const &entry) { return entry.key == order[i]; });
+        if (it != g.end()) {
+            for (auto const &successor : it->value) {
+                auto const j = index_of(successor);
+                d.successors[edge++] = j;
+                ++d.predecessor_counts[j];
+            }
+        }
+    }
+    d.successor_offsets[std::size(order)] = edge;
+    return d;
+}
+
+template <std::size_t NumEdges, std::size_t NumNodes, std::size_t Capacity>
+[[nodiscard]] constexpr auto compact(dag<NumNodes, Capacity> const &d)
+    -> dag<NumNodes, NumEdges> {
+    dag<NumNodes, NumEdges> c{d.nodes, d.predecessor_counts,
+                              d.successor_offsets};
+    std::copy_n(std::begin(d.successors), NumEdges, std::begin(c.successors));
+    return c;
+}
+
+/**
+ * Runs the nodes of a DAG on a pool, each as soon as its predecessors have
+ * finished, and returns when all have finished. The calling thread runs
+ * nodes too while it waits.
+ */
+template <std::size_t NumNodes, std::size_t NumEdges> class dag_run {
+    dag<NumNodes, NumEdges> const &d;
+    work_stealing_pool &pool;
+    std::array<std::atomic<std::size_t>, NumNodes> waiting_for{};
+    std::atomic<std::size_t> left{NumNodes};
+
+    auto submit(std::size_t i) -> void {
+        pool.submit({&run_node, this, i});
+    }
+
+    // runs a node, then the first of its successors that it makes ready,
+    // and so on, and queues the others for any thread to take
+    static auto run_node(void *context, std::size_t i) -> void {
+        auto &r = *static_cast<dag_run *>(context);
+        auto &pool = r.pool;
+        auto finished = std::size_t{};
+        for (auto next = i; next < NumNodes; ++finished) {
+            auto const n = std::exchange(next, NumNodes);
+            r.d.nodes[n]();
+
+            for (auto e = r.d.successor_offsets[n];
+                 e < r.d.successor_offsets[n + 1]; ++e) {
+                auto const j = r.d.successors[e];
+                if (r.waiting_for[j].fetch_sub(
+                        1, std::memory_order_acq_rel) == 1) {
+                    if (next == NumNodes) {
+                        next = j;
+                    } else {
+                        r.submit(j);
+                    }
+                }
+            }
+        }
+        // the runner may return as soon as left reaches 0
+        if (r.left.fetch_sub(finished, std::memory_order_acq_rel) ==
+            finished) {
+            pool.notify();
+        }
+    }
+
+  public:
+    dag_run(dag<NumNodes, NumEdges> const &dg, work_stealing_pool &p)
+        : d{dg}, pool{p} {
+        for (auto i = std::size_t{}; i < NumNodes; ++i) {
+            waiting_for[i].store(d.predecessor_counts[i],
+                                 std::memory_order_relaxed);
+        }
+    }
+
+    auto operator()() -> void {
+        for (auto i = std::size_t{}; i < NumNodes; ++i) {
+            if (d.predecessor_counts[i] == 0) {
+                submit(i);
+            }
+        }
+        pool.wait_until(
+            [&] { return left.load(std::memory_order_acquire) == 0; });
+    }
+};
+} // namespace detail
+
+/**
+ * Renders a flow into a DAG of its steps, and runs each step on a thread
+ * pool as soon as all the steps it depends on have run. Steps with no
+ * ordering between them may run concurrently, so they must be safe to.
+ *
+ * The DAG is built at compile time: the nodes in a topological order, with
+ * a count of predecessors and a list of successors for each, so running the
+ * flow only counts down one atomic per node.
+ *
+ * @tparam Name       The name of the flow, for logging.
+ * @tparam Impl       As for graph_builder.
+ * @tparam NumThreads The size of the pool the flow runs on. Flows with the
+ *                    same NumThreads share a pool.
+ */
+template <stdx::ct_string Name,
+          template <stdx::ct_string, std::size_t> typename Impl,
+          std::size_t NumThreads = 4>
+struct parallel_graph_builder {
+    using serial_builder_t = graph_builder<Name, Impl>;
+
+    template <typename Graph>
+    [[nodiscard]] constexpr static auto build(Graph const &input) {
+        auto g = serial_builder_t::build_graph(input);
+        using graph_t = decltype(g);
+        using output_t = Impl<Graph::name, graph_t::capacity()>;
+        using dag_t = detail::dag<graph_t::capacity(),
+                                  detail::edge_capacity<graph_t>::value>;
+
+        // topo_sort consumes the graph it sorts
+        auto sorted_g = g;
+        auto const sorted =
+            serial_builder_t::template topo_sort<output_t>(sorted_g);
+        if (not sorted) {
+            return std::optional<dag_t>{};
+        }
+        return std::optional<dag_t>{
+            detail::to_dag<dag_t>(sorted->functionPtrs, g)};
+    }
+
+    template <typename Initialized> constexpr static auto build_dag() {
+        constexpr auto v = Initialized::value;
+        constexpr auto built = build(v);
+        static_assert(built.has_value(),
+                      "Topological sort failed: cycle in flow");
+        return detail::compact<built->num_edges()>(*built);
+    }
+
+    template <typename Initialized> class built_flow {
+        constexpr static auto flow_dag = build_dag<Initialized>();
+        constexpr static auto num_nodes = std::size(flow_dag.nodes);
+
+        static auto run() -> void {
+            constexpr static bool loggingEnabled = not Name.empty();
+
+            if constexpr (loggingEnabled) {
+                logging::log<decltype(get_log_env<built_flow>())>(
+                    __FILE__, __LINE__,
+                    stdx::ct_format<"flow.start({})">(stdx::cts_t<Name>{}));
+            }
+
+            if constexpr (num_nodes > 0) {
+                detail::dag_run{flow_dag, thread_pool<NumThreads>()}();
+            }
+
+            if constexpr (loggingEnabled) {
+                logging::log<decltype(get_log_env<built_flow>())>(
+                    __FILE__, __LINE__,
+                    stdx::ct_format<"flow.end({})">(stdx::cts_t<Name>{}));
+            }
+        }
+
+      public:
+        constexpr static auto ct_name = Name;
+
+        // NOLINTNEXTLINE(google-explicit-constructor)
+        constexpr explicit(false) operator FunctionPtr() const { return run; }
+        auto operator()() const -> void { run(); }
+        constexpr static bool active = num_nodes > 0;
+    };
+
+    template <typename Initialized>
+    [[nodiscard]] constexpr static auto render() -> built_flow<Initialized> {
+        return {};
+    }
+};
+
+template <stdx::ct_string Name = "", std::size_t NumThreads = 4>
+using parallel_builder =
+    graph<Name, parallel_graph_builder<Name, impl, NumThreads>>;
+
+template <stdx::ct_string Name = "", std::size_t NumThreads = 4>
+struct parallel_service {
+    using builder_t = parallel_builder<Name, NumThreads>;
+    using interface_t = FunctionPtr;
+
+    CONSTEVAL static auto uninitialized() -> interface_t {
+        return [] {
+            using namespace stdx::literals;
+            stdx::panic<"Attempting to run flow ("_cts + Name +
+                        ") before it is initialized"_cts>();
+        };
+    }
+};
+} // namespace flow
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace flow {
+/**
+ * A fixed-size pool of threads, each with its own queue of tasks. A thread
+ * runs the tasks it submitted itself newest first, and when its queue is
+ * empty, steals the oldest task from another thread's queue.
+ *
+ * Tasks are plain function pointers with a context, so submitting one does
+ * not allocate beyond the queue's own storage. A thread waiting for tasks to
+ * finish (with wait_until) runs queued tasks meanwhile, so a task may itself
+ * submit tasks and wait for them.
+ */
+class work_stealing_pool {
+  public:
+    struct task {
+        auto (*fn)(void *, std::size_t) -> void;
+        void *context;
+        std::size_t arg;
+
+        auto operator()() const -> void { fn(context, arg); }
+    };
+
+  private:
+    struct queue {
+        std::mutex m;
+        std::deque<task> tasks;
+    };
+
+    std::vector<std::unique_ptr<queue>> queues;
+    std::atomic<std::size_t> next_queue{};
+
+    // bumped whenever a task is submitted or finishes, to wake sleepers
+    std::atomic<std::uint32_t> epoch{};
+
+    std::vector<std::jthread> threads;
+
+    // the pool and queue of the worker thread running, if any
+    static inline thread_local work_stealing_pool *current_pool{};
+    static inline thread_local std::size_t current_queue{};
+
+    [[nodiscard]] auto own_queue() const -> std::optional<std::size_t> {
+        if (current_pool == this) {
+            return current_queue;
+        }
+        return {};
+    }
+
+    auto pop(std::size_t q) -> std::optional<task> {
+        auto &own = *queues[q];
+        auto const lock = std::lock_guard{own.m};
+        if (own.tasks.empty()) {
+            return {};
+        }
+        auto const t = own.tasks.back();
+        own.tasks.pop_back();
+        return t;
+    }
+
+    auto steal(std::size_t thief) -> std::optional<task> {
+        auto const n = queues.size();
+        for (auto i = std::size_t{1}; i <= n; ++i) {
+            auto &victim = *queues[(thief + i) % n];
+            auto const lock = std::lock_guard{victim.m};
+            if (not victim.tasks.empty()) {
+                auto const t = victim.tasks.front();
+                victim.tasks.pop_front();
+                return t;
+            }
+        }
+        return {};
+    }
+
+    auto find_task() -> std::optional<task> {
+        if (auto const q = own_queue()) {
+            if (auto t = pop(*q)) {
+                return t;
+            }
+            return steal(*q);
+        }
+        return steal(next_queue.load(std::memory_order_relaxed));
+    }
+
+    auto work(std::stop_token stop, std::size_t q) -> void {
+        current_pool = this;
+        current_queue = q;
+        while (true) {
+            // load the epoch before checking for a stop: the destructor's
+            // notify() after request_stop() then either changes it or comes
+            // after the check, so the wait below cannot miss it
+            auto const seen = epoch.load(std::memory_order_acquire);
+            if (stop.stop_requested()) {
+                return;
+            }
+            if (auto const t = find_task()) {
+                (*t)();
+            } else {
+                epoch.wait(seen, std::memory_order_acquire);
+            }
+        }
+    }
+
+  public:
+    explicit work_stealing_pool(std::size_t num_threads) {
+        num_threads = std::max(num_threads, std::size_t{1});
+        queues.reserve(num_threads);
+        for (auto i = std::size_t{}; i < num_threads; ++i) {
+            queues.push_back(std::make_unique<queue>());
+        }
+        threads.reserve(num_threads);
+        for (auto i = std::size_t{}; i < num_threads; ++i) {
+            threads.emplace_back(
+                [this, i](std::stop_token stop) { work(stop, i); });
+        }
+    }
+
+    work_stealing_pool(work_stealing_pool const &) = delete;
+    auto operator=(work_stealing_pool const &) -> work_stealing_pool & = delete;
+
+    ~work_stealing_pool() {
+        for (auto &t : threads) {
+            t.request_stop();
+        }
+        notify();
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t { return queues.size(); }
+
+    /**
+     * Queues a task: on the calling thread's own queue when that is one of
+     * the pool's threads, otherwise on each thread's queue in turn.
+     */
+    auto submit(task t) -> void {
+        auto const own = own_queue();
+        auto const q =
+            own ? *own
+                : next_queue.fetch_add(1, std::memory_order_relaxed) % size();
+        {
+            auto const lock = std::lock_guard{queues[q]->m};
+            queues[q]->tasks.push_back(t);
+        }
+        // one thread is enough to take one task
+        epoch.fetch_add(1, std::memory_order_release);
+        epoch.notify_one();
+    }
+
+    /**
+     * Wakes threads waiting in wait_until. A task that another thread waits
+     * for calls this when it has finished, after its last use of anything
+     * the waiter owns.
+     */
+    auto notify() -> void {
+        epoch.fetch_add(1, std::memory_order_release);
+        epoch.notify_all();
+    }
+
+    /**
+     * Runs queued tasks until done() returns true, and sleeps when there are
+     * none. done() is checked after every task and every notify().
+     */
+    template <typename Done> auto wait_until(Done const &done) -> void {
+        while (not done()) {
+            auto const seen = epoch.load(std::memory_order_acquire);
+            if (done()) {
+                return;
+            }
+            if (auto const t = find_task()) {
+                (*t)();
+            } else {
+                epoch.wait(seen, std::memory_order_acquire);
+            }
+        }
+    }
+};
+
+/**
+ * @tparam NumThreads The number of threads in the pool.
+ * @return A pool shared by everything that asks for the same size, started
+ * on first use.
+ */
+template <std::size_t NumThreads> auto thread_pool() -> work_stealing_pool & {
+    static auto pool = work_stealing_pool{NumThreads};
+    return pool;
+}
+} // namespace flow
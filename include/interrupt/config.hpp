@@ -19,6 +19,18 @@ template <typename Policies> struct policy_config {
     using resources_t =
         typename Policies::template type<required_resources_policy,
                                          required_resources<>>::resources;
+    using dispatch_policy_t =
+        typename Policies::template type<sub_irq_dispatch_policy,
+                                         sequential_dispatch>;
+    using instrumentation_policy_t =
+        typename Policies::template type<irq_instrumentation_policy,
+                                         no_instrumentation>;
+    using execution_policy_t =
+        typename Policies::template type<flow_execution_policy,
+                                         run_flows_in_isr>;
+    using storm_policy_t =
+        typename Policies::template type<irq_storm_policy,
+                                         no_storm_detection>;
 };
 
 template <base_irq_config... Cfgs> struct parent_config {
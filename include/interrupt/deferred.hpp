@@ -0,0 +1,147 @@
+#pragma once
+
+#include <interrupt/policies.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace interrupt {
+/**
+ * A queue of deferred work: the bottom halves of interrupts whose flows are
+ * run with defer_flows.
+ *
+ * Work is posted from interrupt context without locking, and run later, in
+ * order of priority, by whatever drains the queue (a MainLoop action, or a
+ * dedicated thread). Each work item is queued at most once: posting an item
+ * that is already pending does nothing, so that an interrupt firing several
+ * times before its bottom half runs is serviced once, and the queue can
+ * never overflow.
+ *
+ * Any number of producers may post concurrently; there must be one consumer.
+ *
+ * @tparam NumPriorities The number of priority levels. Priority 0 runs first.
+ */
+template <std::size_t NumPriorities = 4> class deferred_queue {
+  public:
+    struct work {
+        constexpr work(auto (*f)()->void, std::size_t p) : fn{f}, priority{p} {}
+
+        auto (*fn)() -> void;
+        std::size_t priority;
+        work *next{};
+        std::atomic<bool> queued{};
+    };
+
+  private:
+    // each priority has a lock-free stack that producers push onto, and a
+    // list that only the consumer touches, taken from the stack in one
+    // exchange and reversed into posting order
+    std::array<std::atomic<work *>, NumPriorities> posted{};
+    std::array<work *, NumPriorities> ready{};
+
+    auto take_posted(std::size_t p) -> void {
+        auto *w = posted[p].exchange(nullptr, std::memory_order_acquire);
+        work *in_order{};
+        while (w != nullptr) {
+            auto *const next = w->next;
+            w->next = in_order;
+            in_order = w;
+            w = next;
+        }
+        ready[p] = in_order;
+    }
+
+  public:
+    constexpr static auto num_priorities() -> std::size_t {
+        return NumPriorities;
+    }
+
+    // safe to call from any interrupt or thread
+    auto post(work &w) -> void {
+        if (w.queued.exchange(true, std::memory_order_acquire)) {
+            return;
+        }
+        auto &head = posted[w.priority];
+        w.next = head.load(std::memory_order_relaxed);
+        while (not head.compare_exchange_weak(w.next, &w,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * Runs the most urgent piece of pending work, if there is one.
+     *
+     * The work item may be posted again as soon as it has been taken off the
+     * queue, i.e. while it runs.
+     *
+     * @return Whether anything was run.
+     */
+    auto run_one() -> bool {
+        for (auto p = std::size_t{}; p < NumPriorities; ++p) {
+            if (ready[p] == nullptr) {
+                take_posted(p);
+            }
+            if (auto *const w = ready[p]; w != nullptr) {
+                ready[p] = w->next;
+                w->queued.store(false, std::memory_order_release);
+                w->fn();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Runs pending work until there is none, always choosing the most urgent
+     * next: work posted meanwhile at a higher priority runs before any more
+     * at a lower priority.
+     *
+     * @return The number of work items run.
+     */
+    auto run_pending() -> std::size_t {
+        auto n = std::size_t{};
+        while (run_one()) {
+            ++n;
+        }
+        return n;
+    }
+
+    // only exact when called from the consumer
+    [[nodiscard]] auto empty() const -> bool {
+        for (auto p = std::size_t{}; p < NumPriorities; ++p) {
+            if (ready[p] != nullptr or
+                posted[p].load(std::memory_order_relaxed) != nullptr) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * Runs a configuration's flows as deferred work: in interrupt context, only
+ * the status policy and posting the work run.
+ *
+ * @tparam Queue     The deferred_queue to post to.
+ * @tparam Priority  The priority of the work in that queue.
+ */
+template <auto &Queue, std::size_t Priority = 0> struct defer_flows {
+    using policy_type = flow_execution_policy;
+    using queue_t = std::remove_cvref_t<decltype(Queue)>;
+
+    static_assert(Priority < queue_t::num_priorities(),
+                  "Deferred work priority is out of range for its queue");
+
+    template <auto (*Flows)()->void>
+    constinit static inline auto work = typename queue_t::work{Flows, Priority};
+
+    template <auto (*Flows)()->void> static auto run() -> void {
+        Queue.post(work<Flows>);
+    }
+
+    static_assert(execution_policy<defer_flows>);
+};
+} // namespace interrupt
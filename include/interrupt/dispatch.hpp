@@ -0,0 +1,231 @@
+#pragma once
+
+#include <interrupt/policies.hpp>
+
+#include <boost/mp11/algorithm.hpp>
+#include <boost/mp11/list.hpp>
+#include <boost/mp11/utility.hpp>
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+
+namespace interrupt {
+// A field of a memory-mapped register, as reprogrammed by dynamic_controller.
+template <typename F>
+concept register_field = requires {
+    typename F::RegisterType;
+    typename F::RegisterType::DataType;
+    {
+        F::get_mask()
+    } -> std::convertible_to<typename F::RegisterType::DataType>;
+};
+
+// Clears each pending status field with its own clear operation.
+struct clear_each_field {
+    template <typename Register, typename... Subs>
+    static auto clear_pending(typename Register::DataType pending) -> void {
+        using data_t = typename Register::DataType;
+        constexpr static auto clears = [] {
+            auto table =
+                std::array<void (*)(), std::numeric_limits<data_t>::digits>{};
+            ((table[static_cast<std::size_t>(
+                  std::countr_zero(Subs::status_field.get_mask()))] =
+                  [] { apply(clear(Subs::status_field)); }),
+             ...);
+            return table;
+        }();
+        for (auto p = pending; p != 0; p = static_cast<data_t>(p & (p - 1u))) {
+            clears[static_cast<std::size_t>(std::countr_zero(p))]();
+        }
+    }
+};
+
+// Clears all the pending status fields in a register with one write, for
+// registers where writing 1 to a status bit clears it.
+struct write_one_to_clear {
+    template <typename Register, typename...>
+    static auto clear_pending(typename Register::DataType pending) -> void {
+        if (pending != 0) {
+            apply(write(Register{}.raw(pending)));
+        }
+    }
+};
+
+namespace detail::coalesce {
+template <typename Sub>
+using enable_field_t = std::remove_cvref_t<decltype(Sub::enable_field)>;
+template <typename Sub>
+using status_field_t = std::remove_cvref_t<decltype(Sub::status_field)>;
+template <typename Sub>
+using enable_reg_t = typename enable_field_t<Sub>::RegisterType;
+template <typename Sub>
+using status_reg_t = typename status_field_t<Sub>::RegisterType;
+
+template <typename Sub, typename Policy>
+constexpr auto clears = std::same_as<typename Sub::status_policy_t, Policy>;
+
+template <typename Sub>
+concept coalescable =
+    Sub::active and register_field<enable_field_t<Sub>> and
+    register_field<status_field_t<Sub>> and requires { Sub::run_isr(); } and
+    (clears<Sub, clear_status_first> or clears<Sub, clear_status_last> or
+     clears<Sub, dont_clear_status>) and
+    std::same_as<typename Sub::storm_policy_t, no_storm_detection>;
+
+template <typename Sub>
+using is_coalescable = std::bool_constant<coalescable<Sub>>;
+
+template <typename Register> struct in_status_register {
+    template <typename Sub>
+    using fn = std::is_same<status_reg_t<Sub>, Register>;
+};
+
+// The values of a set of registers, each read once.
+template <typename... Registers> struct register_values {
+    std::tuple<typename Registers::DataType...> values{
+        static_cast<typename Registers::DataType>(
+            apply(read(Registers{}.raw)))...};
+
+    template <typename Register>
+    [[nodiscard]] auto get() const -> typename Register::DataType {
+        using index_t =
+            boost::mp11::mp_find<boost::mp11::mp_list<Registers...>, Register>;
+        return std::get<index_t::value>(values);
+    }
+};
+
+template <typename ClearPolicy, typename Register, typename... Subs>
+struct status_group {
+    using data_t = typename Register::DataType;
+
+    template <typename Sub>
+    constexpr static auto status_mask =
+        static_cast<data_t>(status_field_t<Sub>::get_mask());
+
+    static_assert((std::has_single_bit(status_mask<Subs>) and ...),
+                  "Coalesced dispatch needs one-bit status fields");
+
+    template <typename Policy>
+    constexpr static auto mask_for =
+        (data_t{} | ... |
+         (clears<Subs, Policy> ? status_mask<Subs> : data_t{}));
+
+    constexpr static auto mask = (data_t{} | ... | status_mask<Subs>);
+
+    // when each enable bit is in the same place as its status bit, in one
+    // register, the enables can be masked in with one AND
+    constexpr static auto aligned =
+        boost::mp11::mp_size<boost::mp11::mp_unique<
+            boost::mp11::mp_list<enable_reg_t<Subs>...>>>::value == 1 and
+        (... and
+         (std::same_as<typename enable_reg_t<Subs>::DataType, data_t> and
+          enable_field_t<Subs>::get_mask() == status_mask<Subs>));
+
+    // indexed by status bit
+    constexpr static auto isrs = [] {
+        auto table =
+            std::array<void (*)(), std::numeric_limits<data_t>::digits>{};
+        ((table[static_cast<std::size_t>(
+              std::countr_zero(status_mask<Subs>))] = &Subs::run_isr),
+         ...);
+        return table;
+    }();
+
+    template <typename Enables>
+    static auto enabled(Enables const &enables) -> data_t {
+        if constexpr (aligned) {
+            using enable_t = enable_reg_t<boost::mp11::mp_first<
+                boost::mp11::mp_list<Subs...>>>;
+            return enables.template get<enable_t>();
+        } else {
+            auto e = data_t{};
+            (
+                [&] {
+                    if ((enables.template get<enable_reg_t<Subs>>() &
+                         enable_field_t<Subs>::get_mask()) != 0) {
+                        e |= status_mask<Subs>;
+                    }
+                }(),
+                ...);
+            return e;
+        }
+    }
+
+    template <typename Enables> static auto run(Enables const &enables) {
+        auto const status =
+            static_cast<data_t>(apply(read(Register{}.raw)));
+        auto const pending =
+            static_cast<data_t>(status & mask & enabled(enables));
+        if (pending == 0) {
+            return;
+        }
+
+        ClearPolicy::template clear_pending<Register, Subs...>(
+            static_cast<data_t>(pending & mask_for<clear_status_first>));
+        for (auto p = pending; p != 0; p = static_cast<data_t>(p & (p - 1u))) {
+            isrs[static_cast<std::size_t>(std::countr_zero(p))]();
+        }
+        ClearPolicy::template clear_pending<Register, Subs...>(
+            static_cast<data_t>(pending & mask_for<clear_status_last>));
+    }
+};
+} // namespace detail::coalesce
+
+/**
+ * Dispatches sub-interrupts a register at a time.
+ *
+ * Sub-interrupts are grouped by the register that holds their status field.
+ * Each enable and status register is read once; the enabled, pending bits
+ * are found with one AND and visited lowest first, each jumping straight to
+ * its ISR. Status fields are cleared a register at a time: those of subs
+ * with clear_status_first before any of the group's ISRs run, those of subs
+ * with clear_status_last after they have all run.
+ *
+ * A sub-interrupt takes part if its fields are register fields (with a
+ * one-bit status field) and it uses one of the standard status policies;
+ * others run afterwards, as they would with sequential_dispatch.
+ *
+ * @tparam ClearPolicy How to clear the status fields in a register:
+ *                     clear_each_field or write_one_to_clear.
+ */
+template <typename ClearPolicy = clear_each_field> struct coalesced_dispatch {
+    using policy_type = sub_irq_dispatch_policy;
+
+    template <typename... Subs> static auto run() -> void {
+        using namespace boost::mp11;
+        using namespace detail::coalesce;
+
+        using subs_t = mp_copy_if<mp_list<Subs...>, is_coalescable>;
+        if constexpr (not mp_empty<subs_t>::value) {
+            using enable_regs_t = mp_unique<mp_transform<enable_reg_t, subs_t>>;
+            using status_regs_t = mp_unique<mp_transform<status_reg_t, subs_t>>;
+
+            auto const enables = mp_rename<enable_regs_t, register_values>{};
+            mp_for_each<mp_transform<mp_identity, status_regs_t>>(
+                [&]<typename R>(mp_identity<R>) {
+                    using group_subs_t =
+                        mp_copy_if_q<subs_t, in_status_register<R>>;
+                    using group_t =
+                        mp_apply<status_group,
+                                 mp_push_front<group_subs_t, ClearPolicy, R>>;
+                    group_t::run(enables);
+                });
+        }
+
+        (
+            [] {
+                if constexpr (not coalescable<Subs>) {
+                    Subs::run();
+                }
+            }(),
+            ...);
+    }
+
+    static_assert(dispatch_policy<coalesced_dispatch>);
+};
+} // namespace interrupt
@@ -10,8 +10,11 @@
 #include <boost/mp11/algorithm.hpp>
 #include <boost/mp11/list.hpp>
 
+#include <bitset>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <tuple>
 #include <type_traits>
 
 namespace interrupt {
@@ -27,11 +30,17 @@ concept has_resource =
 
 template <typename Root> struct dynamic_controller {
   private:
-    using all_resources_t =
-        boost::mp11::mp_unique<decltype(Root::descendants.apply(
-            []<typename... Irqs>(Irqs const &...) {
-                return boost::mp11::mp_append<typename Irqs::resources_t...>{};
-            }))>;
+    // a function object rather than a lambda: GCC 12 fails to compile
+    // members whose types depend on a lambda in a decltype
+    struct collect_resources {
+        template <typename... Irqs>
+        constexpr auto operator()(Irqs const &...) const {
+            return boost::mp11::mp_append<typename Irqs::resources_t...>{};
+        }
+    };
+
+    using all_resources_t = boost::mp11::mp_unique<decltype(
+        Root::descendants.apply(collect_resources{}))>;
 
     template <typename Register>
     CONSTINIT static inline typename Register::DataType allowed_enables =
@@ -40,14 +49,30 @@ template <typename Root> struct dynamic_controller {
     template <typename Register>
     CONSTINIT static inline typename Register::DataType dynamic_enables{};
 
+    // interrupts not masked by storm_guard: kept apart from dynamic_enables,
+    // so that a storm ending restores what the application chose
+    template <typename Register>
+    CONSTINIT static inline typename Register::DataType storm_enables =
+        std::numeric_limits<typename Register::DataType>::max();
+
+    // the value last written to each register
+    template <typename Register>
+    CONSTINIT static inline typename Register::DataType written_enables{};
+
+    constexpr static std::size_t num_resources =
+        boost::mp11::mp_size<all_resources_t>::value;
+
     template <typename Resource>
-    CONSTINIT static inline bool is_resource_on = true;
+    using resource_index_t = boost::mp11::mp_find<all_resources_t, Resource>;
+
+    // one bit per resource, indexed as in all_resources_t
+    CONSTINIT static inline std::bitset<num_resources> resources_off{};
 
-    template <typename Resource> struct doesnt_require_resource {
+    template <typename Resource> struct requires_resource {
         template <typename Irq>
         using fn =
             std::bool_constant<has_enable_field<Irq> and
-                               not boost::mp11::mp_contains<
+                               boost::mp11::mp_contains<
                                    typename Irq::resources_t, Resource>::value>;
     };
 
@@ -57,13 +82,13 @@ template <typename Root> struct dynamic_controller {
     };
 
     /**
-     * For each ResourceType, keep track of what interrupts can still be enabled
-     * when that resource goes down.
+     * For each ResourceType, the interrupts that must be disabled when that
+     * resource goes down: together, these masks are a resource-by-register
+     * matrix, computed at compile time.
      *
      * Each bit in this mask corresponds to an interrupt enable field in
-     * RegType. If the bit is '1', that means the corresponding interrupt can be
-     * enabled when the resource is not available. If the bit is '0', that means
-     * the corresponding interrupt must be disabled when the resource is not
+     * RegType. If the bit is '1', that means the corresponding interrupt
+     * requires the resource, and must be disabled when the resource is not
      * available.
      *
      * @tparam ResourceType
@@ -73,10 +98,10 @@ template <typename Root> struct dynamic_controller {
      *      The specific register mask we want to check.
      */
     template <typename ResourceType, typename RegType>
-    constexpr static typename RegType::DataType irqs_allowed = []() {
-        // get all interrupt enable fields that don't require the given resource
+    constexpr static typename RegType::DataType irqs_requiring = []() {
+        // get all interrupt enable fields that require the given resource
         auto const matching_irqs =
-            stdx::filter<doesnt_require_resource<ResourceType>::template fn>(
+            stdx::filter<requires_resource<ResourceType>::template fn>(
                 Root::descendants);
         auto const interrupt_enables_tuple = stdx::transform(
             [](auto irq) { return irq.enable_field; }, matching_irqs);
@@ -86,8 +111,7 @@ template <typename Root> struct dynamic_controller {
             stdx::filter<in_register<RegType>::template fn>(
                 interrupt_enables_tuple);
 
-        // set the bits in the mask for interrupts that don't require the
-        // resource
+        // set the bits in the mask for interrupts that require the resource
         using DataType = typename RegType::DataType;
         return fields_in_reg.fold_left(
             DataType{}, [](DataType value, auto field) -> DataType {
@@ -95,19 +119,26 @@ template <typename Root> struct dynamic_controller {
             });
     }();
 
+    template <typename R>
+    [[nodiscard]] static auto final_enables() -> typename R::DataType {
+        return static_cast<typename R::DataType>(
+            allowed_enables<R> & dynamic_enables<R> & storm_enables<R>);
+    }
+
+    template <typename R> static inline void reprogram_interrupt_enable() {
+        // make sure we don't enable any interrupts that are not allowed
+        // according to resource availability, or that are storming
+        auto const enables = final_enables<R>();
+
+        // update the hardware register
+        written_enables<R> = enables;
+        apply(write(R{}.raw(enables)));
+    }
+
     template <typename RegTypeTuple>
     static inline void reprogram_interrupt_enables(RegTypeTuple regs) {
-        stdx::for_each(
-            []<typename R>(R reg) {
-                // make sure we don't enable any interrupts that are not allowed
-                // according to resource availability
-                auto const final_enables =
-                    allowed_enables<R> & dynamic_enables<R>;
-
-                // update the hardware registers
-                apply(write(reg.raw(final_enables)));
-            },
-            regs);
+        stdx::for_each([]<typename R>(R) { reprogram_interrupt_enable<R>(); },
+                       regs);
     }
 
     /**
@@ -121,30 +152,38 @@ template <typename Root> struct dynamic_controller {
             []<typename Irq>(Irq) { return Irq::enable_field.get_register(); },
             stdx::filter<has_resource_t>(Root::descendants)));
 
+    template <typename Resource> struct affected_by {
+        template <typename R>
+        using fn = std::bool_constant<irqs_requiring<Resource, R> != 0>;
+    };
+
     /**
-     * Reprogram interrupt enables based on updated resource availability.
+     * tuple of the interrupt registers affected by one resource
      */
-    static inline auto recalculate_allowed_enables() {
-        // set allowed_enables mask for each resource affected register
-        stdx::for_each(
-            []<typename R>(R) {
-                using DataType = typename R::DataType;
-                allowed_enables<R> = std::numeric_limits<DataType>::max();
-            },
+    template <typename Resource>
+    constexpr static auto resource_affected_regs =
+        stdx::filter<affected_by<Resource>::template fn>(
             all_resource_affected_regs);
 
-        // for each resource, if it is not on, mask out unavailable interrupts
-        stdx::template_for_each<all_resources_t>([]<typename Rsrc>() {
-            if (not is_resource_on<Rsrc>) {
-                stdx::for_each(
-                    []<typename R>(R) {
-                        allowed_enables<R> &= irqs_allowed<Rsrc, R>;
-                    },
-                    all_resource_affected_regs);
+    /**
+     * Recalculate the allowed enables of one register from the resources
+     * that affect it, and reprogram it if its final value changed.
+     */
+    template <typename R> static inline void recalculate_allowed_enables() {
+        using DataType = typename R::DataType;
+        auto disallowed = DataType{};
+        stdx::template_for_each<all_resources_t>([&]<typename Rsrc>() {
+            if constexpr (irqs_requiring<Rsrc, R> != 0) {
+                if (resources_off.test(resource_index_t<Rsrc>::value)) {
+                    disallowed |= irqs_requiring<Rsrc, R>;
+                }
             }
         });
+        allowed_enables<R> = static_cast<DataType>(~disallowed);
 
-        return all_resource_affected_regs;
+        if (final_enables<R>() != written_enables<R>) {
+            reprogram_interrupt_enable<R>();
+        }
     }
 
     /**
@@ -163,6 +202,11 @@ template <typename Root> struct dynamic_controller {
                                (... or Irq::template triggers_flow<Flows>)>;
     };
 
+    template <typename... Flows>
+    constexpr static auto flow_enable_fields = stdx::transform(
+        [](auto irq) { return irq.enable_field; },
+        stdx::filter<match_flow<Flows...>::template fn>(Root::descendants));
+
     template <bool Enable, typename... Flows>
     static inline void enable_by_name() {
         // NOTE: critical section is not needed here because shared state is
@@ -172,27 +216,136 @@ template <typename Root> struct dynamic_controller {
         //       this will require another way to manage them vs. mmio
         //       registers. once that goes in, then enable_by_field should be
         //       removed or made private.
-        auto const matching_irqs =
-            stdx::filter<match_flow<Flows...>::template fn>(Root::descendants);
-
-        auto const interrupt_enables_tuple = stdx::transform(
-            [](auto irq) { return irq.enable_field; }, matching_irqs);
-
-        interrupt_enables_tuple.apply([]<typename... Fields>(Fields...) {
+        flow_enable_fields<Flows...>.apply([]<typename... Fields>(Fields...) {
             enable_by_field<Enable, Fields...>();
         });
     }
 
+    template <typename ResourceType>
+    static inline void set_resource_status(resource_status status) {
+        auto const off = status == resource_status::OFF;
+        if (resources_off.test(resource_index_t<ResourceType>::value) == off) {
+            return;
+        }
+        resources_off.set(resource_index_t<ResourceType>::value, off);
+
+        // only the registers that depend on this resource can change
+        stdx::for_each([]<typename R>(R) { recalculate_allowed_enables<R>(); },
+                       resource_affected_regs<ResourceType>);
+    }
+
     template <typename ResourceType>
     static inline void update_resource(resource_status status) {
-        conc::call_in_critical_section<dynamic_controller>([&] {
-            is_resource_on<ResourceType> = (status == resource_status::ON);
-            recalculate_allowed_enables();
-            reprogram_interrupt_enables(all_resource_affected_regs);
-        });
+        if constexpr (resource_index_t<ResourceType>::value < num_resources) {
+            conc::call_in_critical_section<dynamic_controller>(
+                [&] { set_resource_status<ResourceType>(status); });
+        }
     }
 
+    template <typename Irq>
+    using has_register_enable_t = std::bool_constant<
+        has_enable_field<Irq> and requires {
+            typename std::remove_cvref_t<
+                decltype(Irq::enable_field)>::RegisterType;
+        }>;
+
+    /**
+     * tuple of every interrupt enable register
+     */
+    constexpr static auto all_enable_regs =
+        stdx::to_unsorted_set(stdx::transform(
+            []<typename Irq>(Irq) { return Irq::enable_field.get_register(); },
+            stdx::filter<has_register_enable_t>(Root::descendants)));
+
+    template <typename Register> struct register_changes {
+        using register_t = Register;
+        typename Register::DataType set{};
+        typename Register::DataType clear{};
+        bool touched{};
+    };
+
+    struct make_register_changes {
+        template <typename... Registers>
+        constexpr auto operator()(Registers...) const {
+            return std::tuple<register_changes<Registers>...>{};
+        }
+    };
+
   public:
+    /**
+     * A batch of enable and disable changes, applied together by commit():
+     * in one critical section, with one write to each register touched.
+     *
+     * Changes are applied in the order they are made, so a later change to
+     * an interrupt overrides an earlier one. A transaction that is never
+     * committed changes nothing.
+     */
+    class transaction {
+        using changes_t = decltype(all_enable_regs.apply(
+            make_register_changes{}));
+        changes_t changes{};
+
+      public:
+        template <bool Enable, typename... Fields>
+        auto enable_by_field() -> transaction & {
+            (
+                [&] {
+                    using R = typename Fields::RegisterType;
+                    auto &c = std::get<register_changes<R>>(changes);
+                    if constexpr (Enable) {
+                        c.set |= Fields::get_mask();
+                        c.clear &= ~Fields::get_mask();
+                    } else {
+                        c.clear |= Fields::get_mask();
+                        c.set &= ~Fields::get_mask();
+                    }
+                    c.touched = true;
+                }(),
+                ...);
+            return *this;
+        }
+
+        template <typename... Flows> auto enable() -> transaction & {
+            flow_enable_fields<Flows...>.apply(
+                [&]<typename... Fields>(Fields...) {
+                    enable_by_field<true, Fields...>();
+                });
+            return *this;
+        }
+
+        template <typename... Flows> auto disable() -> transaction & {
+            flow_enable_fields<Flows...>.apply(
+                [&]<typename... Fields>(Fields...) {
+                    enable_by_field<false, Fields...>();
+                });
+            return *this;
+        }
+
+        auto commit() -> void {
+            conc::call_in_critical_section<dynamic_controller>([&] {
+                std::apply(
+                    []<typename... Changes>(Changes const &...cs) {
+                        (commit_register(cs), ...);
+                    },
+                    changes);
+            });
+            changes = {};
+        }
+
+      private:
+        template <typename Changes>
+        static auto commit_register(Changes const &c) -> void {
+            using R = typename Changes::register_t;
+            if (c.touched) {
+                dynamic_enables<R> = static_cast<typename R::DataType>(
+                    (dynamic_enables<R> & ~c.clear) | c.set);
+                reprogram_interrupt_enable<R>();
+            }
+        }
+    };
+
+    [[nodiscard]] static auto begin() -> transaction { return {}; }
+
     template <typename ResourceType> static inline void turn_on_resource() {
         update_resource<ResourceType>(resource_status::ON);
     }
@@ -220,6 +373,30 @@ template <typename Root> struct dynamic_controller {
         });
     }
 
+    /**
+     * Masks or unmasks interrupts for storm_guard. This is separate from
+     * enable_by_field: an interrupt is enabled only when the application
+     * enables it and it is not masked.
+     */
+    template <bool Mask, typename... Fields>
+    static inline void storm_mask_by_field() {
+        conc::call_in_critical_section<dynamic_controller>([] {
+            [[maybe_unused]] auto const mask = []<typename F>() -> void {
+                using R = typename F::RegisterType;
+                if constexpr (Mask) {
+                    storm_enables<R> &= ~F::get_mask();
+                } else {
+                    storm_enables<R> |= F::get_mask();
+                }
+            };
+            (mask.template operator()<Fields>(), ...);
+
+            auto const unique_regs = stdx::to_unsorted_set(
+                stdx::tuple<typename Fields::RegisterType...>{});
+            reprogram_interrupt_enables(unique_regs);
+        });
+    }
+
     template <typename... Flows> static inline void enable() {
         enable_by_name<true, Flows...>();
     }
@@ -7,6 +7,8 @@
 #include <stdx/concepts.hpp>
 #include <stdx/type_traits.hpp>
 
+#include <cstdint>
+
 namespace interrupt {
 template <typename T>
 concept hal_interface = requires(T const &t, void (*isr)()) {
@@ -32,6 +34,11 @@ template <typename...> struct null_hal {
         undefined();
     }
 
+    static auto cycle_count() -> std::uint32_t {
+        undefined();
+        return 0;
+    }
+
   private:
     static auto undefined() -> void {
         static_assert(stdx::always_false_v<null_hal>,
@@ -61,6 +68,14 @@ struct hal {
                                   stdx::invocable auto const &isr) -> void {
         injected_hal<Ts...>.template run<P>(irq, isr);
     }
+
+    // Only needed (and only required of the injected HAL) when an ISR is
+    // instrumented: a free-running cycle counter, which may wrap.
+    template <typename... Ts>
+        requires(sizeof...(Ts) == 0)
+    ALWAYS_INLINE static auto cycle_count() -> std::uint32_t {
+        return injected_hal<Ts...>.cycle_count();
+    }
 };
 
 static_assert(hal_interface<hal>);
@@ -3,10 +3,67 @@
 #include <interrupt/concepts.hpp>
 #include <interrupt/hal.hpp>
 
+#include <stdx/compiler.hpp>
 #include <stdx/tuple.hpp>
 #include <stdx/tuple_algorithms.hpp>
 
+#include <concepts>
+
 namespace interrupt {
+namespace detail {
+template <typename Config>
+constexpr auto instrumented =
+    not std::same_as<typename Config::instrumentation_policy_t,
+                     no_instrumentation>;
+
+template <typename Config, typename... Nexi> auto flows() -> void {
+    Config::template isr<Nexi...>();
+}
+
+template <typename Config, typename... Nexi>
+ALWAYS_INLINE auto execute_flows() -> void {
+    using execution_policy_t = typename Config::execution_policy_t;
+    if constexpr (std::same_as<execution_policy_t, run_flows_in_isr>) {
+        Config::template isr<Nexi...>();
+    } else {
+        execution_policy_t::template run<&flows<Config, Nexi...>>();
+    }
+}
+
+// With the default policies, these are exactly the calls they wrap.
+template <typename Config, typename... Nexi>
+ALWAYS_INLINE auto run_flows() -> void {
+    if constexpr (instrumented<Config>) {
+        Config::instrumentation_policy_t::template run<Config>(
+            [] { execute_flows<Config, Nexi...>(); });
+    } else {
+        execute_flows<Config, Nexi...>();
+    }
+}
+
+// With the default policy, this is exactly the call it wraps.
+template <typename Config, auto (*Service)()->void>
+ALWAYS_INLINE auto guard_storms() -> void {
+    using storm_policy_t = typename Config::storm_policy_t;
+    if constexpr (std::same_as<storm_policy_t, no_storm_detection>) {
+        Service();
+    } else {
+        storm_policy_t::template run<Config, Service>();
+    }
+}
+
+template <typename Config, typename... Subs>
+ALWAYS_INLINE auto dispatch() -> void {
+    using dispatch_policy_t = typename Config::dispatch_policy_t;
+    if constexpr (instrumented<Config>) {
+        Config::instrumentation_policy_t::template run<Config>(
+            [] { dispatch_policy_t::template run<Subs...>(); });
+    } else {
+        dispatch_policy_t::template run<Subs...>();
+    }
+}
+} // namespace detail
+
 template <typename Nexus, typename Config>
 concept nexus_for_cfg = Config::template has_flows_for<Nexus>;
 
@@ -25,8 +82,9 @@ struct irq_impl : Config {
     static auto run() -> void {
         if constexpr (active) {
             using status_policy_t = typename Config::status_policy_t;
-            hal::run<status_policy_t>(Config::irq_number,
-                                      [] { Config::template isr<Nexi...>(); });
+            hal::run<status_policy_t>(Config::irq_number, [] {
+                detail::run_flows<Config, Nexi...>();
+            });
         }
     }
 };
@@ -48,13 +106,26 @@ struct sub_irq_impl : Config {
 
     static auto run() -> void {
         if constexpr (active) {
-            using status_policy_t = typename Config::status_policy_t;
             if (apply(read(enable_field)) && apply(read(status_field))) {
-                status_policy_t::run([&] { apply(clear(status_field)); },
-                                     [&] { Config::template isr<Nexi...>(); });
+                detail::guard_storms<Config, &service>();
             }
         }
     }
+
+    // Clears the status according to the status policy and runs the ISR.
+    ALWAYS_INLINE static auto service() -> void {
+        using status_policy_t = typename Config::status_policy_t;
+        status_policy_t::run([&] { apply(clear(status_field)); },
+                             [&] { detail::run_flows<Config, Nexi...>(); });
+    }
+
+    // Runs the ISR without checking the fields, for a dispatcher that has
+    // already read them.
+    static auto run_isr() -> void {
+        if constexpr (active) {
+            detail::run_flows<Config, Nexi...>();
+        }
+    }
 };
 
 template <typename Config> struct id_irq_impl : Config {
@@ -85,8 +156,9 @@ struct shared_irq_impl : Config {
     static auto run() -> void {
         if constexpr (active) {
             using status_policy_t = typename Config::status_policy_t;
-            hal::run<status_policy_t>(Config::irq_number,
-                                      [] { (Subs::run(), ...); });
+            hal::run<status_policy_t>(Config::irq_number, [] {
+                detail::dispatch<Config, Subs...>();
+            });
         }
     }
 };
@@ -109,12 +181,22 @@ struct shared_sub_irq_impl : Config {
 
     static auto run() -> void {
         if constexpr (active) {
-            using status_policy_t = typename Config::status_policy_t;
             if (apply(read(enable_field)) && apply(read(status_field))) {
-                status_policy_t::run([&] { apply(clear(status_field)); },
-                                     [&] { (Subs::run(), ...); });
+                detail::guard_storms<Config, &service>();
             }
         }
     }
+
+    ALWAYS_INLINE static auto service() -> void {
+        using status_policy_t = typename Config::status_policy_t;
+        status_policy_t::run([&] { apply(clear(status_field)); },
+                             [&] { run_isr(); });
+    }
+
+    static auto run_isr() -> void {
+        if constexpr (active) {
+            detail::dispatch<Config, Subs...>();
+        }
+    }
 };
 } // namespace interrupt
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <interrupt/hal.hpp>
+#include <interrupt/policies.hpp>
+
+#include <stdx/concepts.hpp>
+
+#include <conc/concurrency.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace interrupt {
+/**
+ * What has been measured of one ISR.
+ *
+ * histogram[i] counts the runs that took fewer than 2^i cycles, and at least
+ * 2^(i - 1); the last bucket also counts every longer run.
+ */
+struct irq_stats {
+    constexpr static auto num_buckets = std::size_t{20};
+
+    std::uint32_t count{};
+    std::uint32_t max_cycles{};
+    std::array<std::uint32_t, num_buckets> histogram{};
+
+    constexpr auto record(std::uint32_t cycles) -> void {
+        ++count;
+        max_cycles = std::max(max_cycles, cycles);
+        auto const bucket = std::min(
+            static_cast<std::size_t>(std::bit_width(cycles)), num_buckets - 1);
+        ++histogram[bucket];
+    }
+
+    friend constexpr auto operator==(irq_stats const &, irq_stats const &)
+        -> bool = default;
+};
+
+namespace detail {
+// One cache line (or more) for each instrumented ISR, so that ISRs running
+// on different cores don't contend.
+template <typename Config> struct irq_counters {
+    alignas(64) static inline irq_stats stats{};
+};
+} // namespace detail
+
+/**
+ * Times each run of an ISR with the HAL's cycle_count() and records it in
+ * the ISR's counters; read them out with snapshot_stats<Config>().
+ */
+struct measure_latency {
+    using policy_type = irq_instrumentation_policy;
+
+    template <typename Config>
+    static void run(stdx::invocable auto const &isr) {
+        auto const start = hal::cycle_count();
+        isr();
+        auto const cycles =
+            static_cast<std::uint32_t>(hal::cycle_count() - start);
+        detail::irq_counters<Config>::stats.record(cycles);
+    }
+
+    static_assert(instrumentation_policy<measure_latency>);
+};
+
+/**
+ * @tparam Config The interrupt configuration (irq, sub_irq, ...) whose ISR
+ *                is measured.
+ * @return A consistent copy of what has been measured so far.
+ */
+template <typename Config>
+[[nodiscard]] auto snapshot_stats() -> irq_stats {
+    using counters_t = detail::irq_counters<Config>;
+    return conc::call_in_critical_section<counters_t>(
+        [] { return counters_t::stats; });
+}
+
+template <typename Config> auto reset_stats() -> void {
+    using counters_t = detail::irq_counters<Config>;
+    conc::call_in_critical_section<counters_t>(
+        [] { counters_t::stats = irq_stats{}; });
+}
+} // namespace interrupt
@@ -8,11 +8,38 @@
 #include <stdx/utility.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
 #include <type_traits>
 
 namespace interrupt {
 namespace detail {
 template <typename Dynamic, irq_interface... Impls> struct manager {
+    using isr_t = auto (*)() -> void;
+
+  private:
+    constexpr static auto num_irqs =
+        std::size_t{std::max({stdx::to_underlying(Impls::irq_number)...})} + 1;
+
+    static auto unused_irq() -> void {}
+
+    // indexed by IRQ number; where several configurations share an IRQ
+    // number, the first one wins, as it does for run<Number>()
+    constexpr static auto isrs = [] {
+        auto table = std::array<isr_t, num_irqs>{};
+        table.fill(&unused_irq);
+        (
+            [&] {
+                auto &entry = table[stdx::to_underlying(Impls::irq_number)];
+                if (entry == &unused_irq) {
+                    entry = &Impls::run;
+                }
+            }(),
+            ...);
+        return table;
+    }();
+
+  public:
     void init() const {
         // TODO: log exact interrupt manager configuration
         //       (should be a single compile-time string with no arguments)
@@ -39,6 +66,28 @@ template <typename Dynamic, irq_interface... Impls> struct manager {
         }
     }
 
+    /**
+     * Runs the interrupt with a number known only at runtime, e.g. in a
+     * generic vector table trampoline: one bounds check and one indirect
+     * call. Unconfigured IRQ numbers do nothing.
+     */
+    inline void run(irq_num_t number) const {
+        auto const n = std::size_t{stdx::to_underlying(number)};
+        if (n < num_irqs) {
+            isrs[n]();
+        }
+    }
+
+    /**
+     * @return A table of ISRs indexed by IRQ number, from 0 to max_irq(),
+     * for ports that install it directly. Unconfigured IRQ numbers have an
+     * ISR that does nothing.
+     */
+    [[nodiscard]] constexpr static auto vector_table()
+        -> std::array<isr_t, num_irqs> const & {
+        return isrs;
+    }
+
     [[nodiscard]] constexpr auto max_irq() const -> irq_num_t {
         return static_cast<irq_num_t>(
             std::max({stdx::to_underlying(Impls::irq_number)...}));
@@ -53,6 +53,75 @@ struct dont_clear_status {
     static_assert(status_policy<dont_clear_status>);
 };
 
+struct sub_irq_dispatch_policy;
+
+template <typename T>
+concept dispatch_policy =
+    policy<T> and requires { T::template run<>(); };
+
+// Runs each sub-interrupt in turn; each reads its own enable and status.
+struct sequential_dispatch {
+    using policy_type = sub_irq_dispatch_policy;
+
+    template <typename... Subs> static auto run() -> void {
+        (Subs::run(), ...);
+    }
+
+    static_assert(dispatch_policy<sequential_dispatch>);
+};
+
+struct irq_instrumentation_policy;
+
+template <typename T>
+concept instrumentation_policy = policy<T> and requires(void (*f)()) {
+    { T::template run<void>(f) } -> stdx::same_as<void>;
+};
+
+// The default: ISRs are run as they are, with nothing measured.
+struct no_instrumentation {
+    using policy_type = irq_instrumentation_policy;
+
+    template <typename> static void run(stdx::invocable auto const &isr) {
+        isr();
+    }
+
+    static_assert(instrumentation_policy<no_instrumentation>);
+};
+
+struct flow_execution_policy;
+
+template <typename T>
+concept execution_policy = policy<T> and requires {
+    { T::template run<static_cast<void (*)()>(nullptr)>() };
+};
+
+// The default: flows run in the ISR.
+struct run_flows_in_isr {
+    using policy_type = flow_execution_policy;
+
+    template <auto (*Flows)()->void> static auto run() -> void { Flows(); }
+
+    static_assert(execution_policy<run_flows_in_isr>);
+};
+
+struct irq_storm_policy;
+
+template <typename T>
+concept storm_policy = policy<T> and requires {
+    { T::template run<void, static_cast<void (*)()>(nullptr)>() };
+};
+
+// The default: every interrupt is serviced as it comes.
+struct no_storm_detection {
+    using policy_type = irq_storm_policy;
+
+    template <typename, auto (*Service)()->void> static auto run() -> void {
+        Service();
+    }
+
+    static_assert(storm_policy<no_storm_detection>);
+};
+
 struct required_resources_policy;
 template <typename... Resources> struct resource_list {};
 
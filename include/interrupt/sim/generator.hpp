@@ -0,0 +1,174 @@
+#pragma once
+
+#include <interrupt/fwd.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace interrupt::sim {
+enum struct arrival : std::uint8_t { poisson, bursty };
+
+/**
+ * One source of simulated interrupts.
+ *
+ * With poisson arrival, the gaps between interrupts are independent and
+ * exponentially distributed. With bursty arrival, interrupts come in bursts
+ * of burst_size, burst_spacing apart, and the bursts themselves arrive as a
+ * Poisson process; either way, rate is the mean number of interrupts per
+ * second.
+ */
+struct source {
+    irq_num_t irq;
+    double rate;
+    arrival pattern{arrival::poisson};
+    std::size_t burst_size{8};
+    std::chrono::nanoseconds burst_spacing{std::chrono::microseconds{1}};
+    // run before each raise, e.g. to set the status field of a sub_irq
+    std::function<void()> before_raise{};
+};
+
+/**
+ * A thread that raises interrupts on a sim::controller from a set of
+ * sources, until it has raised a limit or is destroyed.
+ *
+ * Arrival times are fixed in advance from a seeded generator, so a load is
+ * repeatable; if the thread falls behind, it raises the overdue interrupts
+ * at once rather than dropping them.
+ */
+template <typename Controller> class generator {
+    using clock = std::chrono::steady_clock;
+
+    struct schedule {
+        clock::time_point next;
+        std::size_t left_in_burst;
+    };
+
+    std::atomic<std::uint64_t> raise_count{};
+    std::atomic<bool> finished{};
+    std::jthread thread;
+
+    static auto burst_size(source const &s) -> std::size_t {
+        constexpr auto one = std::size_t{1};
+        return s.pattern == arrival::bursty ? std::max(s.burst_size, one) : one;
+    }
+
+    template <typename Rng>
+    static auto gap(source const &s, Rng &rng) -> clock::duration {
+        auto const mean_gap = static_cast<double>(burst_size(s)) / s.rate;
+        auto const seconds =
+            std::exponential_distribution<double>{1.0 / mean_gap}(rng);
+        return std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double>{seconds});
+    }
+
+    // sleeps while the wait is long, then spins (yielding, so as not to
+    // starve the core thread on a small host) for accuracy
+    static auto wait_until(clock::time_point t, std::stop_token const &stop)
+        -> bool {
+        constexpr auto spin_time = std::chrono::microseconds{100};
+        for (auto now = clock::now(); now < t; now = clock::now()) {
+            if (stop.stop_requested()) {
+                return false;
+            }
+            if (t - now > 2 * spin_time) {
+                std::this_thread::sleep_for(t - now - spin_time);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        return not stop.stop_requested();
+    }
+
+    auto generate(std::stop_token stop, Controller &c,
+                  std::vector<source> const &sources, std::uint64_t limit,
+                  std::uint64_t seed) -> void {
+        auto rng = std::mt19937_64{seed};
+        auto schedules = std::vector<schedule>{};
+        auto const start = clock::now();
+        for (auto const &s : sources) {
+            schedules.push_back(
+                {s.rate > 0 ? start + gap(s, rng) : start, burst_size(s)});
+        }
+
+        auto const next_due = [&] {
+            auto due = schedules.size();
+            for (auto i = std::size_t{}; i < schedules.size(); ++i) {
+                if (sources[i].rate > 0 and
+                    (due == schedules.size() or
+                     schedules[i].next < schedules[due].next)) {
+                    due = i;
+                }
+            }
+            return due;
+        };
+
+        for (auto count = std::uint64_t{}; count < limit; ++count) {
+            auto const i = next_due();
+            if (i == schedules.size() or
+                not wait_until(schedules[i].next, stop)) {
+                break;
+            }
+            auto const &s = sources[i];
+            if (s.before_raise) {
+                s.before_raise();
+            }
+            c.raise(s.irq);
+            raise_count.fetch_add(1, std::memory_order_relaxed);
+
+            auto &sched = schedules[i];
+            if (--sched.left_in_burst > 0) {
+                sched.next += s.burst_spacing;
+            } else {
+                sched.left_in_burst = burst_size(s);
+                sched.next += gap(s, rng);
+            }
+        }
+        finished.store(true, std::memory_order_release);
+        finished.notify_all();
+    }
+
+  public:
+    constexpr static auto unlimited = std::numeric_limits<std::uint64_t>::max();
+
+    /**
+     * Starts raising interrupts at once.
+     *
+     * @param c       The controller to raise interrupts on.
+     * @param sources What to raise, and when.
+     * @param limit   How many interrupts to raise in all.
+     * @param seed    Seeds the arrival times.
+     */
+    generator(Controller &c, std::vector<source> sources,
+              std::uint64_t limit = unlimited, std::uint64_t seed = 1)
+        : thread{[this, &c, s = std::move(sources), limit,
+                  seed](std::stop_token stop) {
+              generate(std::move(stop), c, s, limit, seed);
+          }} {}
+
+    // blocks until the limit has been raised, or the thread has stopped
+    auto wait() const -> void {
+        finished.wait(false, std::memory_order_acquire);
+    }
+
+    auto stop() -> void {
+        thread.request_stop();
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    [[nodiscard]] auto raised() const -> std::uint64_t {
+        return raise_count.load(std::memory_order_relaxed);
+    }
+};
+} // namespace interrupt::sim
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <interrupt/fwd.hpp>
+#include <interrupt/instrumentation.hpp>
+#include <interrupt/policies.hpp>
+
+#include <stdx/concepts.hpp>
+#include <stdx/utility.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+namespace interrupt::sim {
+enum struct idle_mode : std::uint8_t { wait, spin };
+
+/**
+ * A simulated interrupt controller and the core it interrupts, for running
+ * an interrupt configuration on a host, e.g. to benchmark or soak-test it.
+ *
+ * Interrupts are raised from any thread with raise(). They are serviced on
+ * one thread -- the simulated core -- by service() or run(), which call the
+ * attached manager's run(irq_number) for the most urgent pending interrupt
+ * that is enabled, until none is left. As on an Arm NVIC, a lower priority
+ * value is more urgent, a pending interrupt is taken once however many times
+ * it was raised, and a disabled interrupt stays pending until it is enabled.
+ *
+ * Preemption is emulated at preemption points: an interrupt only preempts
+ * the one being serviced if it is strictly more urgent, and only when the
+ * ISR calls service(). The sim::hal does that on entry to every ISR, so an
+ * interrupt raised while a less urgent one is being taken runs first; a
+ * long-running flow may call service() to be preempted part way through.
+ *
+ * The time from an interrupt first being raised to its ISR starting is
+ * recorded, per IRQ, in nanoseconds.
+ *
+ * @tparam NumIrqs The number of IRQ numbers: 0 to NumIrqs - 1.
+ */
+template <std::size_t NumIrqs = 64> class controller {
+    using word_t = std::uint64_t;
+    constexpr static auto word_bits = std::size_t{64};
+    constexpr static auto num_words = (NumIrqs + word_bits - 1) / word_bits;
+    constexpr static auto idle = std::numeric_limits<priority_t>::max();
+
+    // when each IRQ was first raised (0 when it is not pending), and a
+    // pending bit for each IRQ, set once that time is recorded
+    std::array<std::atomic<std::uint64_t>, NumIrqs> pending_since{};
+    std::array<std::atomic<word_t>, num_words> pending{};
+    std::array<std::atomic<word_t>, num_words> enabled{};
+    std::array<priority_t, NumIrqs> priorities{};
+
+    auto (*dispatch)(irq_num_t) -> void {};
+
+    // the priority of the ISR the core is running; only touched by the core
+    priority_t active{idle};
+
+    std::array<irq_stats, NumIrqs> latencies{};
+    std::atomic<std::uint64_t> raise_count{};
+    std::atomic<std::uint64_t> service_count{};
+    std::atomic<std::uint64_t> preemption_count{};
+    std::atomic<std::uint32_t> wakeups{};
+
+    [[nodiscard]] static constexpr auto index(irq_num_t irq) -> std::size_t {
+        return static_cast<std::size_t>(stdx::to_underlying(irq));
+    }
+
+    [[nodiscard]] static constexpr auto bit(std::size_t n) -> word_t {
+        return word_t{1} << (n % word_bits);
+    }
+
+    // the most urgent interrupt that is pending, enabled, and more urgent
+    // than the active ISR, or NumIrqs if there is none
+    [[nodiscard]] auto next() const -> std::size_t {
+        auto best = NumIrqs;
+        auto best_priority = active;
+        for (auto w = std::size_t{}; w < num_words; ++w) {
+            auto bits = pending[w].load(std::memory_order_acquire) &
+                        enabled[w].load(std::memory_order_relaxed);
+            while (bits != 0) {
+                auto const n =
+                    w * word_bits +
+                    static_cast<std::size_t>(std::countr_zero(bits));
+                bits &= bits - 1;
+                if (priorities[n] < best_priority) {
+                    best = n;
+                    best_priority = priorities[n];
+                }
+            }
+        }
+        return best;
+    }
+
+    auto take(std::size_t n) -> void {
+        pending[n / word_bits].fetch_and(~bit(n), std::memory_order_acq_rel);
+        auto const since =
+            pending_since[n].exchange(0, std::memory_order_acq_rel);
+        auto const latency = std::min<std::uint64_t>(
+            now() - since, std::numeric_limits<std::uint32_t>::max());
+        latencies[n].record(static_cast<std::uint32_t>(latency));
+
+        if (active != idle) {
+            preemption_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        auto const preempted = std::exchange(active, priorities[n]);
+        if (dispatch != nullptr) {
+            dispatch(static_cast<irq_num_t>(n));
+        }
+        active = preempted;
+        service_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    auto wake() -> void {
+        wakeups.fetch_add(1, std::memory_order_release);
+        wakeups.notify_one();
+    }
+
+  public:
+    constexpr static auto num_irqs() -> std::size_t { return NumIrqs; }
+
+    // nanoseconds on a steady clock
+    [[nodiscard]] static auto now() -> std::uint64_t {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+    }
+
+    /**
+     * Sets the manager whose ISRs are run. A manager is stateless, so this
+     * only records its type.
+     */
+    template <typename Manager> auto attach(Manager const &) -> void {
+        dispatch = [](irq_num_t irq) { Manager{}.run(irq); };
+    }
+
+    auto configure(irq_num_t irq, bool enable, priority_t priority) -> void {
+        if (auto const n = index(irq); n < NumIrqs) {
+            priorities[n] = priority;
+            if (enable) {
+                enabled[n / word_bits].fetch_or(bit(n),
+                                                std::memory_order_relaxed);
+            } else {
+                enabled[n / word_bits].fetch_and(~bit(n),
+                                                 std::memory_order_relaxed);
+            }
+            wake();
+        }
+    }
+
+    // safe to call from any thread, including from an ISR
+    auto raise(irq_num_t irq) -> void {
+        auto const n = index(irq);
+        if (n >= NumIrqs) {
+            return;
+        }
+        raise_count.fetch_add(1, std::memory_order_relaxed);
+        auto expected = std::uint64_t{};
+        if (pending_since[n].compare_exchange_strong(
+                expected, std::max(now(), std::uint64_t{1}),
+                std::memory_order_acq_rel)) {
+            pending[n / word_bits].fetch_or(bit(n), std::memory_order_release);
+            wake();
+        }
+    }
+
+    /**
+     * Runs pending interrupts, most urgent first, until none can run. On the
+     * core thread only: from an ISR, this is a preemption point.
+     *
+     * @return The number of ISRs run.
+     */
+    auto service() -> std::size_t {
+        auto count = std::size_t{};
+        for (auto n = next(); n < NumIrqs; n = next()) {
+            take(n);
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * Makes the calling thread the simulated core: services interrupts as
+     * they are raised, until a stop is requested. When nothing is pending,
+     * the core either blocks until an interrupt is raised, or busy-waits
+     * (yielding to other threads), which takes a host CPU but keeps the
+     * latency of waking it out of the measurements.
+     */
+    auto run(std::stop_token stop, idle_mode mode = idle_mode::wait) -> void {
+        auto const on_stop = std::stop_callback{stop, [this] { wake(); }};
+        while (not stop.stop_requested()) {
+            auto const seen = wakeups.load(std::memory_order_acquire);
+            if (service() == 0) {
+                if (mode == idle_mode::wait) {
+                    wakeups.wait(seen, std::memory_order_acquire);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] auto is_pending(irq_num_t irq) const -> bool {
+        auto const n = index(irq);
+        return n < NumIrqs and
+               (pending[n / word_bits].load(std::memory_order_acquire) &
+                bit(n)) != 0;
+    }
+
+    /**
+     * @return The latency of each run of an IRQ's ISR so far, in
+     * nanoseconds from when it was first raised. Only consistent when the
+     * core is not running.
+     */
+    [[nodiscard]] auto latency(irq_num_t irq) const -> irq_stats const & {
+        return latencies[index(irq)];
+    }
+
+    [[nodiscard]] auto raised() const -> std::uint64_t {
+        return raise_count.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto serviced() const -> std::uint64_t {
+        return service_count.load(std::memory_order_relaxed);
+    }
+
+    // how many ISRs started while another was running
+    [[nodiscard]] auto preemptions() const -> std::uint64_t {
+        return preemption_count.load(std::memory_order_relaxed);
+    }
+
+    // only while the core is not running
+    auto reset_stats() -> void {
+        latencies = {};
+        raise_count.store(0, std::memory_order_relaxed);
+        service_count.store(0, std::memory_order_relaxed);
+        preemption_count.store(0, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * An interrupt HAL backed by a sim::controller.
+ *
+ * [source,cpp]
+ * ----
+ * constinit auto sim_irqs = interrupt::sim::controller<>{};
+ * template <> inline auto interrupt::injected_hal<> =
+ *     interrupt::sim::hal<sim_irqs>{};
+ * ----
+ */
+template <auto &Controller> struct hal {
+    static auto init() -> void {}
+
+    template <bool Enable, irq_num_t IrqNumber, priority_t Priority>
+    static auto irq_init() -> void {
+        Controller.configure(IrqNumber, Enable, Priority);
+    }
+
+    template <status_policy P>
+    static auto run(irq_num_t, stdx::invocable auto const &isr) -> void {
+        // the controller clears the pending state as it takes an interrupt;
+        // anything more urgent raised meanwhile preempts before the ISR
+        Controller.service();
+        P::run([] {}, [&] { isr(); });
+    }
+
+    static auto cycle_count() -> std::uint32_t {
+        return static_cast<std::uint32_t>(Controller.now());
+    }
+};
+} // namespace interrupt::sim
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+
+namespace interrupt::sim {
+/**
+ * In-memory stand-ins for memory-mapped enable and status registers, for
+ * running interrupt configurations on a host.
+ *
+ * Fields are accessed as the interrupt library accesses register fields:
+ * apply(read(f)), apply(clear(f)) and apply(write(R{}.raw(v))). The
+ * simulated hardware side uses apply(set(f)) to raise a status field. Every
+ * access is atomic, so a generator thread may set status bits while the
+ * simulated core reads and clears them.
+ */
+template <typename Field> struct field_value {
+    typename Field::DataType value;
+};
+
+template <typename Register, std::size_t Msb, std::size_t Lsb = Msb>
+struct field {
+    using RegisterType = Register;
+    using DataType = typename Register::DataType;
+
+    static_assert(Lsb <= Msb and Msb < sizeof(DataType) * CHAR_BIT,
+                  "Field bits are out of range for the register");
+
+    constexpr static auto get_register() -> Register { return {}; }
+
+    constexpr static auto get_mask() -> DataType {
+        constexpr auto width = Msb - Lsb + 1;
+        if constexpr (width == sizeof(DataType) * CHAR_BIT) {
+            return static_cast<DataType>(~DataType{});
+        } else {
+            return static_cast<DataType>(((DataType{1} << width) - 1u) << Lsb);
+        }
+    }
+
+    constexpr auto operator()(DataType value) const -> field_value<field> {
+        return {value};
+    }
+};
+
+/**
+ * @tparam Id Distinguishes registers: any structural value.
+ * @tparam T  The register's data type, which sets its width.
+ */
+template <auto Id, typename T = std::uint32_t> struct reg {
+    using DataType = T;
+
+    template <std::size_t Msb, std::size_t Lsb = Msb>
+    using field_t = field<reg, Msb, Lsb>;
+
+    constexpr static field_t<sizeof(T) * CHAR_BIT - 1, 0> raw{};
+
+    static inline std::atomic<T> value{};
+};
+
+template <typename R, std::size_t Msb, std::size_t Lsb>
+constexpr auto read(field<R, Msb, Lsb>) {
+    return [] {
+        using F = field<R, Msb, Lsb>;
+        return static_cast<typename F::DataType>(
+            (R::value.load(std::memory_order_acquire) & F::get_mask()) >> Lsb);
+    };
+}
+
+template <typename R, std::size_t Msb, std::size_t Lsb>
+constexpr auto clear(field<R, Msb, Lsb>) {
+    return [] {
+        using F = field<R, Msb, Lsb>;
+        R::value.fetch_and(static_cast<typename F::DataType>(~F::get_mask()),
+                           std::memory_order_acq_rel);
+    };
+}
+
+template <typename R, std::size_t Msb, std::size_t Lsb>
+constexpr auto set(field<R, Msb, Lsb>) {
+    return [] {
+        using F = field<R, Msb, Lsb>;
+        R::value.fetch_or(F::get_mask(), std::memory_order_acq_rel);
+    };
+}
+
+template <typename R, std::size_t Msb, std::size_t Lsb>
+constexpr auto write(field_value<field<R, Msb, Lsb>> v) {
+    return [v] {
+        using F = field<R, Msb, Lsb>;
+        using data_t = typename F::DataType;
+        auto const bits = static_cast<data_t>((v.value << Lsb) & F::get_mask());
+        if constexpr (F::get_mask() == static_cast<data_t>(~data_t{})) {
+            R::value.store(bits, std::memory_order_release);
+        } else {
+            auto old = R::value.load(std::memory_order_relaxed);
+            while (not R::value.compare_exchange_weak(
+                old, static_cast<data_t>((old & ~F::get_mask()) | bits),
+                std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            }
+        }
+    };
+}
+
+template <typename... Ops> constexpr auto apply(Ops... ops) {
+    return (ops(), ...);
+}
+} // namespace interrupt::sim
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <interrupt/hal.hpp>
+#include <interrupt/policies.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace interrupt {
+/**
+ * The interrupts that are masked because they are storming, and the polling
+ * that services them meanwhile.
+ *
+ * An interrupt guarded by storm_guard that fires too often is masked and
+ * added here from its ISR. Each call to poll() -- from a MainLoop action, or
+ * a timer -- services it if its status is set, coalescing every occurrence
+ * since the last poll into one run of its flows. Once it has been masked for
+ * a whole window and a poll finds its status clear, it is unmasked.
+ *
+ * Interrupts may be added concurrently; there must be one poller.
+ */
+class storm_monitor {
+  public:
+    struct entry {
+        constexpr entry(auto (*p)()->bool, auto (*r)()->void)
+            : poll{p}, resume{r} {}
+
+        // services the interrupt; returns whether it has calmed down
+        auto (*poll)() -> bool;
+        auto (*resume)() -> void;
+        entry *next{};
+        std::atomic<bool> listed{};
+    };
+
+  private:
+    // entries are pushed here by ISRs, and moved to the polled list, which
+    // only the poller touches
+    std::atomic<entry *> added{};
+    entry *polled{};
+
+  public:
+    // safe to call from any interrupt or thread; returns false if the entry
+    // was already listed
+    auto add(entry &e) -> bool {
+        if (e.listed.exchange(true, std::memory_order_acquire)) {
+            return false;
+        }
+        e.next = added.load(std::memory_order_relaxed);
+        while (not added.compare_exchange_weak(e.next, &e,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+        }
+        return true;
+    }
+
+    /**
+     * Services each storming interrupt once, and unmasks those that have
+     * calmed down.
+     *
+     * @return The number of interrupts still storming.
+     */
+    auto poll() -> std::size_t {
+        for (auto *e = added.exchange(nullptr, std::memory_order_acquire);
+             e != nullptr;) {
+            auto *const next = e->next;
+            e->next = polled;
+            polled = e;
+            e = next;
+        }
+
+        auto storming = std::size_t{};
+        for (auto **link = &polled; *link != nullptr;) {
+            auto &e = **link;
+            if (e.poll()) {
+                // off the list before unmasking: it may storm again at once
+                *link = e.next;
+                e.listed.store(false, std::memory_order_release);
+                e.resume();
+            } else {
+                link = &e.next;
+                ++storming;
+            }
+        }
+        return storming;
+    }
+
+    // only exact when called from the poller
+    [[nodiscard]] auto empty() const -> bool {
+        return polled == nullptr and
+               added.load(std::memory_order_relaxed) == nullptr;
+    }
+};
+
+namespace detail {
+// written by the ISR and the poller, and read from anywhere
+template <typename Config> struct storm_counters {
+    constinit static inline std::atomic<std::uint32_t> window_start{};
+    constinit static inline std::atomic<std::uint32_t> count{};
+    constinit static inline std::atomic<std::uint32_t> storms{};
+};
+} // namespace detail
+
+/**
+ * Detects an interrupt storm: more than MaxPerWindow interrupts in a window
+ * of WindowCycles of the HAL's cycle_count(). The interrupt is then masked
+ * through the dynamic controller and serviced by Monitor's polling instead,
+ * until it calms down. The mask is kept apart from what the application
+ * enables: an interrupt disabled during a storm stays disabled after it.
+ *
+ * Counting costs one cycle_count(), a compare, and an increment on each
+ * interrupt. Only sub_irq and shared_sub_irq configurations, which have an
+ * enable field to mask, can be guarded.
+ *
+ * @tparam Monitor      The storm_monitor that polls storming interrupts.
+ * @tparam Dynamic      The dynamic_controller for the configuration. It may
+ *                      be declared here and defined after the configuration.
+ * @tparam MaxPerWindow The most interrupts in a window that are not a storm.
+ * @tparam WindowCycles The length of a window.
+ */
+template <auto &Monitor, typename Dynamic, std::uint32_t MaxPerWindow,
+          std::uint32_t WindowCycles>
+struct storm_guard {
+    using policy_type = irq_storm_policy;
+
+    static_assert(WindowCycles > 0 and
+                      WindowCycles <=
+                          std::numeric_limits<std::uint32_t>::max() / 2,
+                  "The storm window must fit in half the cycle counter range");
+
+    template <typename Config, auto (*Service)()->void>
+    static auto run() -> void {
+        using counters_t = detail::storm_counters<Config>;
+        auto const now = hal::cycle_count();
+        if (now - counters_t::window_start.load(std::memory_order_relaxed) >=
+            WindowCycles) {
+            counters_t::window_start.store(now, std::memory_order_relaxed);
+            counters_t::count.store(0, std::memory_order_relaxed);
+        }
+        if (counters_t::count.fetch_add(1, std::memory_order_relaxed) >=
+            MaxPerWindow) {
+            mask<Config, Service>(now);
+        }
+        Service();
+    }
+
+    static_assert(storm_policy<storm_guard>);
+
+  private:
+    template <typename Config>
+    using enable_field_t = std::remove_cvref_t<decltype(Config::enable_field)>;
+
+    template <typename Config, auto (*Service)()->void>
+    static auto poll() -> bool {
+        using counters_t = detail::storm_counters<Config>;
+        if (apply(read(Config::status_field))) {
+            Service();
+            return false;
+        }
+        return hal::cycle_count() -
+                   counters_t::window_start.load(std::memory_order_relaxed) >=
+               WindowCycles;
+    }
+
+    template <typename Config> static auto resume() -> void {
+        using counters_t = detail::storm_counters<Config>;
+        counters_t::window_start.store(hal::cycle_count(),
+                                       std::memory_order_relaxed);
+        counters_t::count.store(0, std::memory_order_relaxed);
+        Dynamic::template storm_mask_by_field<false, enable_field_t<Config>>();
+    }
+
+    template <typename Config, auto (*Service)()->void>
+    constinit static inline auto entry =
+        storm_monitor::entry{&poll<Config, Service>, &resume<Config>};
+
+    template <typename Config, auto (*Service)()->void>
+    static auto mask(std::uint32_t now) -> void {
+        using counters_t = detail::storm_counters<Config>;
+        counters_t::window_start.store(now, std::memory_order_relaxed);
+        Dynamic::template storm_mask_by_field<true, enable_field_t<Config>>();
+        // an occurrence already pending when the mask took effect is part of
+        // the same storm
+        if (Monitor.add(entry<Config, Service>)) {
+            counters_t::storms.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+};
+
+/**
+ * @tparam Config The interrupt configuration (sub_irq, ...) guarded.
+ * @return How many times it has been masked for storming.
+ */
+template <typename Config> [[nodiscard]] auto storm_count() -> std::uint32_t {
+    return detail::storm_counters<Config>::storms.load(
+        std::memory_order_relaxed);
+}
+} // namespace interrupt
@@ -1,15 +1,22 @@
 #pragma once
 
 #include <stdx/type_traits.hpp>
+#include <stdx/utility.hpp>
 
 #include <concepts>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <type_traits>
 
 template <typename> struct encode_32;
 template <typename> struct encode_64;
 template <typename> struct encode_u32;
 template <typename> struct encode_u64;
+template <typename> struct encode_v32;
+template <typename> struct encode_v64;
+template <typename> struct encode_z32;
+template <typename> struct encode_z64;
 
 namespace logging {
 template <typename T>
@@ -56,4 +63,71 @@ struct default_arg_packer {
     template <packable T> using pack_as_t = typename encoding<T>::pack_t;
     template <packable T> using encode_as_t = typename encoding<T>::encode_t;
 };
+
+// Integral arguments are packed as LEB128 varints (signed values are zigzag
+// encoded first), so that small values take fewer bytes. Floating-point
+// arguments are packed as for default_arg_packer.
+template <typename T> struct varint_encoding : encoding<T> {};
+
+template <signed_packable T> struct varint_encoding<T> {
+    using encode_t = stdx::conditional_t<sizeof(T) <= sizeof(std::int32_t),
+                                         encode_z32<T>, encode_z64<T>>;
+    using pack_t = stdx::conditional_t<sizeof(T) <= sizeof(std::int32_t),
+                                       std::uint32_t, std::uint64_t>;
+};
+
+template <unsigned_packable T> struct varint_encoding<T> {
+    using encode_t = stdx::conditional_t<sizeof(T) <= sizeof(std::uint32_t),
+                                         encode_v32<T>, encode_v64<T>>;
+    using pack_t = stdx::conditional_t<sizeof(T) <= sizeof(std::uint32_t),
+                                       std::uint32_t, std::uint64_t>;
+};
+
+struct varint_arg_packer {
+    template <packable T>
+    using pack_as_t = typename varint_encoding<T>::pack_t;
+    template <packable T>
+    using encode_as_t = typename varint_encoding<T>::encode_t;
+
+    template <packable T>
+    constexpr static auto max_packed_size =
+        float_packable<T> ? sizeof(pack_as_t<T>)
+                          : (sizeof(pack_as_t<T>) * 8 + 6) / 7;
+
+    // Writes arg at dest and returns the end of what was written.
+    template <packable T>
+    static auto pack(std::uint8_t *dest, T arg) -> std::uint8_t * {
+        using U = pack_as_t<T>;
+        auto const v = stdx::to_underlying(arg);
+        if constexpr (float_packable<T>) {
+            auto u = U{};
+            std::memcpy(&u, &v, sizeof(U));
+            for (auto i = std::size_t{}; i < sizeof(U); ++i) {
+                *dest++ = static_cast<std::uint8_t>(u >> (8 * i));
+            }
+            return dest;
+        } else {
+            auto u = static_cast<U>(v);
+            if constexpr (signed_packable<T>) {
+                using S = std::make_signed_t<U>;
+                auto const s = static_cast<S>(v);
+                u = static_cast<U>(static_cast<U>(s) << 1u) ^
+                    static_cast<U>(s >> (sizeof(S) * 8 - 1));
+            }
+            while (u >= 0x80u) {
+                *dest++ = static_cast<std::uint8_t>(u | 0x80u);
+                u >>= 7u;
+            }
+            *dest++ = static_cast<std::uint8_t>(u);
+            return dest;
+        }
+    }
+};
+
+// A packer that writes each argument with a variable number of bytes.
+template <typename P>
+concept variable_length_packer = requires(std::uint8_t *p) {
+    { P::pack(p, 0) } -> std::same_as<std::uint8_t *>;
+    P::template max_packed_size<int>;
+};
 } // namespace logging
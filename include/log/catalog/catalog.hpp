@@ -8,6 +8,12 @@ template <typename, auto, typename T, T...> struct undefined;
 
 template <typename> struct message {};
 template <typename> struct module_string {};
+
+// Specialized (with a constexpr static value) in the header that
+// gen_str_catalog.py writes with --hpp_output, so that IDs are known at
+// compile time.
+template <typename> struct static_catalog {};
+template <typename> struct static_module {};
 } // namespace sc
 
 using string_id = std::uint32_t;
@@ -15,3 +21,34 @@ using module_id = std::uint32_t;
 
 template <typename> extern auto catalog() -> string_id;
 template <typename> extern auto module() -> module_id;
+
+namespace logging::binary {
+// Whether IDs come from the generated header is a whole-program choice: every
+// translation unit must be built the same way. The lookups for each choice
+// have distinct names so that a mixed build never merges the two definitions.
+#ifdef CIB_LOG_CATALOG_HEADER
+inline namespace static_ids {
+#else
+inline namespace extern_ids {
+#endif
+template <typename Message> auto lookup_catalog() -> string_id {
+    if constexpr (requires { sc::static_catalog<Message>::value; }) {
+        return sc::static_catalog<Message>::value;
+    } else {
+        return catalog<Message>();
+    }
+}
+
+template <typename Module> auto lookup_module() -> module_id {
+    if constexpr (requires { sc::static_module<Module>::value; }) {
+        return sc::static_module<Module>::value;
+    } else {
+        return module<Module>();
+    }
+}
+} // namespace static_ids/extern_ids
+} // namespace logging::binary
+
+#ifdef CIB_LOG_CATALOG_HEADER
+#include CIB_LOG_CATALOG_HEADER
+#endif
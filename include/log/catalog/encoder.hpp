@@ -3,6 +3,7 @@
 #include <log/catalog/arguments.hpp>
 #include <log/catalog/builder.hpp>
 #include <log/catalog/catalog.hpp>
+#include <log/catalog/level_table.hpp>
 #include <log/log.hpp>
 #include <log/module.hpp>
 #include <log/module_id.hpp>
@@ -46,13 +47,26 @@ template <typename S, auto Id> struct to_message_t {
 };
 } // namespace detail
 
+// A destination that is safe to call concurrently (e.g. per_core_rings) is
+// written to without a critical section.
+template <typename Dest>
+concept concurrent_destination = requires { typename Dest::concurrent_t; };
+
+template <typename Dest, typename F>
+auto call_for_destination(F &&f) -> void {
+    if constexpr (concurrent_destination<Dest>) {
+        std::forward<F>(f)();
+    } else {
+        conc::call_in_critical_section<Dest>(std::forward<F>(f));
+    }
+}
+
 template <typename Destinations> struct log_writer {
     template <std::size_t N>
     auto operator()(stdx::span<std::uint8_t const, N> msg) -> void {
         stdx::for_each(
             [&]<typename Dest>(Dest &dest) {
-                conc::call_in_critical_section<Dest>(
-                    [&] { dest.log_by_buf(msg); });
+                call_for_destination<Dest>([&] { dest.log_by_buf(msg); });
             },
             dests);
     }
@@ -62,7 +76,7 @@ template <typename Destinations> struct log_writer {
         [&]<std::size_t... Is>(std::index_sequence<Is...>) {
             stdx::for_each(
                 [&]<typename Dest>(Dest &dest) {
-                    conc::call_in_critical_section<Dest>(
+                    call_for_destination<Dest>(
                         [&] { dest.log_by_args(msg[Is]...); });
                 },
                 dests);
@@ -86,19 +100,29 @@ template <typename Writer> struct log_handler {
 
     template <typename Env, typename FmtResult>
     auto log_msg(FmtResult const &fr) -> void {
-        fr.args.apply([&]<typename... Args>(Args &&...args) {
-            auto builder = get_builder(Env{});
-            constexpr auto L = stdx::to_underlying(get_level(Env{}));
-            using Message = typename decltype(builder)::template convert_args<
-                detail::to_message_t<decltype(fr.str), logging::get_string_id(
-                                                           Env{})>::template fn,
-                std::remove_cvref_t<Args>...>;
+        auto const &levels = get_levels<Env>();
+        constexpr auto Level = get_level(Env{});
+        if constexpr (Level <= std::remove_cvref_t<decltype(levels)>::floor) {
             using Module =
                 decltype(detail::to_module<get_module(Env{}),
                                            logging::get_module_id(Env{})>());
-            w(builder.template build<L>(catalog<Message>(), module<Module>(),
-                                        std::forward<Args>(args)...));
-        });
+            auto const m = lookup_module<Module>();
+            if (not levels.enabled(m, Level)) {
+                return;
+            }
+            fr.args.apply([&]<typename... Args>(Args &&...args) {
+                auto builder = get_builder(Env{});
+                constexpr auto L = stdx::to_underlying(Level);
+                using Message =
+                    typename decltype(builder)::template convert_args<
+                        detail::to_message_t<
+                            decltype(fr.str),
+                            logging::get_string_id(Env{})>::template fn,
+                        std::remove_cvref_t<Args>...>;
+                w(builder.template build<L>(lookup_catalog<Message>(), m,
+                                            std::forward<Args>(args)...));
+            });
+        }
     }
 
     template <typename Env, auto Version, stdx::ct_string S = "">
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <stdx/bit.hpp>
+#include <stdx/span.hpp>
+
+#include <conc/concurrency.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace logging::binary {
+/**
+ * Accumulates log records into frames, writing each frame to a transport with
+ * one log_by_buf call.
+ *
+ * Records are appended whole, in little-endian byte order, so a frame is a
+ * concatenation of messages just as a capture is. A record that does not fit
+ * in the current frame starts a new one; a record larger than a frame is
+ * written on its own. flush() writes a partial frame.
+ *
+ * @tparam Dest        The transport: a destination with log_by_buf.
+ * @tparam FrameBytes  The size of a frame.
+ */
+template <typename Dest, std::size_t FrameBytes = 512> class frame_batcher {
+    Dest dest;
+    std::array<std::uint8_t, FrameBytes> frame{};
+    std::size_t used{};
+    std::size_t frames{};
+
+    auto write_frame() -> void {
+        if (used != 0) {
+            dest.log_by_buf(stdx::span<std::uint8_t const>{frame.data(), used});
+            used = 0;
+            ++frames;
+        }
+    }
+
+    auto append(void const *data, std::size_t size) -> void {
+        if (used + size > FrameBytes) {
+            write_frame();
+        }
+        if (size > FrameBytes) {
+            dest.log_by_buf(stdx::span<std::uint8_t const>{
+                static_cast<std::uint8_t const *>(data), size});
+            ++frames;
+            return;
+        }
+        std::memcpy(frame.data() + used, data, size);
+        used += size;
+    }
+
+    template <typename F> static auto locked(F &&f) -> void {
+        conc::call_in_critical_section<frame_batcher>(std::forward<F>(f));
+    }
+
+  public:
+    constexpr frame_batcher() = default;
+    constexpr explicit frame_batcher(Dest d) : dest{std::move(d)} {}
+
+    // A destination for logging::binary::config; it refers to this batcher.
+    struct destination_t {
+        // the batcher takes its own critical section
+        using concurrent_t = void;
+
+        template <typename... Args>
+        auto log_by_args(std::uint32_t header, Args... args) -> void {
+            auto const words = std::array{
+                stdx::to_le(header),
+                stdx::to_le(static_cast<std::uint32_t>(args))...};
+            batcher->locked(
+                [&] { batcher->append(words.data(), sizeof(words)); });
+        }
+
+        template <std::size_t N>
+        auto log_by_buf(stdx::span<std::uint8_t const, N> buf) -> void {
+            batcher->locked(
+                [&] { batcher->append(buf.data(), buf.size()); });
+        }
+
+        frame_batcher *batcher;
+    };
+
+    [[nodiscard]] auto destination() -> destination_t { return {this}; }
+
+    // Writes any records waiting in a partial frame.
+    auto flush() -> void {
+        locked([&] { write_frame(); });
+    }
+
+    [[nodiscard]] auto num_frames() const -> std::size_t {
+        auto n = std::size_t{};
+        locked([&] { n = frames; });
+        return n;
+    }
+
+    [[nodiscard]] auto transport() -> Dest & { return dest; }
+};
+} // namespace logging::binary
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <log/catalog/catalog.hpp>
+#include <log/flavor.hpp>
+#include <log/level.hpp>
+
+#include <msg/message.hpp>
+
+#include <stdx/utility.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace logging::binary {
+namespace defn {
+using msg::at;
+using msg::dword_index_t;
+using msg::field;
+using msg::message;
+using msg::operator""_msb;
+using msg::operator""_lsb;
+
+using level_control_module_id_f =
+    field<"module_id",
+          std::uint8_t>::located<at{dword_index_t{0}, 6_msb, 0_lsb}>;
+using level_control_all_modules_f =
+    field<"all_modules", bool>::located<at{dword_index_t{0}, 7_msb, 7_lsb}>;
+using level_control_level_f =
+    field<"level",
+          logging::level>::located<at{dword_index_t{0}, 10_msb, 8_lsb}>;
+
+// Sets the runtime level of one module (or all modules).
+using level_control_msg_t =
+    message<"log_level_control", level_control_module_id_f,
+            level_control_all_modules_f, level_control_level_f>;
+} // namespace defn
+
+// The default: every call that is compiled in is logged.
+struct all_levels {
+    constexpr static auto floor = level::TRACE;
+
+    [[nodiscard]] constexpr static auto enabled(module_id, level) -> bool {
+        return true;
+    }
+};
+
+/**
+ * Runtime log levels per module, under a compile-time floor.
+ *
+ * Calls less severe than Floor compile away. Other calls are logged if they
+ * are at least as severe as their module's level, which costs one relaxed
+ * load and a compare before any arguments are packed.
+ *
+ * @tparam NumModules  Modules with IDs at or above this share one level.
+ * @tparam Floor       The least severe level that is compiled in.
+ */
+template <std::size_t NumModules = 128, level Floor = level::TRACE>
+class level_table {
+    using slot_t = std::atomic<std::uint8_t>;
+
+    std::array<slot_t, NumModules + 1> thresholds{
+        []<std::size_t... Is>(std::index_sequence<Is...>) {
+            return std::array<slot_t, NumModules + 1>{
+                ((void)Is, slot_t{stdx::to_underlying(Floor)})...};
+        }(std::make_index_sequence<NumModules + 1>{})};
+
+    [[nodiscard]] constexpr static auto index(module_id m) -> std::size_t {
+        return std::min(std::size_t{m}, NumModules);
+    }
+
+  public:
+    constexpr static auto floor = Floor;
+
+    [[nodiscard]] auto enabled(module_id m, level l) const -> bool {
+        return stdx::to_underlying(l) <=
+               thresholds[index(m)].load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto get(module_id m) const -> level {
+        return static_cast<level>(
+            thresholds[index(m)].load(std::memory_order_relaxed));
+    }
+
+    auto set(module_id m, level l) -> void {
+        thresholds[index(m)].store(stdx::to_underlying(l),
+                               std::memory_order_relaxed);
+    }
+
+    auto set_all(level l) -> void {
+        for (auto &s : thresholds) {
+            s.store(stdx::to_underlying(l), std::memory_order_relaxed);
+        }
+    }
+
+    template <typename Msg> auto handle(Msg const &m) -> void {
+        using namespace msg;
+        auto const l = m.get("level"_field);
+        if (m.get("all_modules"_field)) {
+            set_all(l);
+        } else {
+            set(m.get("module_id"_field), l);
+        }
+    }
+};
+
+template <typename...> inline auto levels = all_levels{};
+
+template <typename Env> constexpr auto get_levels() -> auto & {
+    using flavor_t = typename decltype(get_flavor(Env{}))::type;
+    if constexpr (std::same_as<flavor_t, default_flavor_t>) {
+        return levels<>;
+    } else {
+        return levels<flavor_t>;
+    }
+}
+} // namespace logging::binary
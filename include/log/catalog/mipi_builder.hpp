@@ -6,6 +6,7 @@
 
 #include <stdx/bit.hpp>
 #include <stdx/compiler.hpp>
+#include <stdx/span.hpp>
 #include <stdx/type_traits.hpp>
 #include <stdx/utility.hpp>
 
@@ -63,11 +64,55 @@ template <typename Storage, packer P> struct catalog_builder {
     }
 };
 
+// A message whose size is only known at runtime: at most N bytes.
+template <std::size_t N> struct sized_message {
+    std::array<std::uint8_t, N> storage{};
+    std::size_t size{};
+
+    struct const_view_t {
+        stdx::span<std::uint8_t const> bytes;
+        [[nodiscard]] auto data() const { return bytes; }
+    };
+
+    [[nodiscard]] auto as_const_view() const -> const_view_t {
+        return {stdx::span<std::uint8_t const>{storage.data(), size}};
+    }
+};
+
+template <packer P> struct varint_catalog_builder {
+    template <auto Level, packable... Ts>
+    static auto build(string_id id, module_id m, Ts... args) {
+        using namespace msg;
+        constexpr auto header_size =
+            defn::varint_catalog_msg_t::size<std::uint8_t>::value;
+        using header_t = std::array<std::uint8_t, header_size>;
+        defn::varint_catalog_msg_t::owner_t<header_t> header{
+            "severity"_field = Level, "module_id"_field = m};
+
+        constexpr auto max_size = header_size + sizeof(id) +
+                                  (0 + ... + P::template max_packed_size<Ts>);
+        auto message = sized_message<max_size>{};
+        auto dest = message.storage.data();
+        std::memcpy(dest, &header.data()[0], header_size);
+        dest += header_size;
+        auto const le_id = stdx::to_le(id);
+        std::memcpy(dest, &le_id, sizeof(id));
+        dest += sizeof(id);
+        ((dest = P::pack(dest, args)), ...);
+        message.size = static_cast<std::size_t>(dest - message.storage.data());
+        return message;
+    }
+};
+
 template <packer P> struct builder<defn::catalog_msg_t, P> {
     template <auto Level, typename... Ts>
     static auto build(string_id id, module_id m, Ts... args) {
         using namespace msg;
-        if constexpr ((0 + ... + sizeof(Ts)) <= sizeof(std::uint32_t) * 2) {
+        if constexpr (variable_length_packer<P>) {
+            return varint_catalog_builder<P>{}.template build<Level>(id, m,
+                                                                     args...);
+        } else if constexpr ((0 + ... + sizeof(Ts)) <=
+                             sizeof(std::uint32_t) * 2) {
             constexpr auto header_size =
                 defn::catalog_msg_t::size<std::uint32_t>::value;
             constexpr auto payload_size =
@@ -13,7 +13,9 @@ using msg::operator""_lsb;
 
 enum struct type : uint8_t { Build = 0, Short32 = 1, Catalog = 3 };
 enum struct build_subtype : uint8_t { Compact32 = 0, Compact64 = 1, Long = 2 };
-enum struct catalog_subtype : uint8_t { Id32_Pack32 = 1 };
+// Id32_Varint is private to this library (Sys-T does not assign it): the
+// arguments are packed by logging::varint_arg_packer.
+enum struct catalog_subtype : uint8_t { Id32_Pack32 = 1, Id32_Varint = 0x3e };
 
 using type_f = field<"type", type>::located<at{dword_index_t{0}, 3_msb, 0_lsb}>;
 using opt_len_f =
@@ -63,5 +65,9 @@ using catalog_msg_t =
     message<"catalog", type_f::with_required<type::Catalog>, severity_f,
             module_id_f,
             catalog_subtype_f::with_required<catalog_subtype::Id32_Pack32>>;
+using varint_catalog_msg_t =
+    message<"varint_catalog", type_f::with_required<type::Catalog>,
+            severity_f, module_id_f,
+            catalog_subtype_f::with_required<catalog_subtype::Id32_Varint>>;
 } // namespace defn
 } // namespace logging::mipi
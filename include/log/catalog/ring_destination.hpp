@@ -0,0 +1,165 @@
+#pragma once
+
+#include <log/catalog/timestamp.hpp>
+#include <log/thread_index.hpp>
+#include <log/detail/mpsc_queue.hpp>
+
+#include <stdx/span.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <utility>
+
+namespace logging::binary {
+/**
+ * Per-core rings of log records, merged in timestamp order by a drainer.
+ *
+ * Logging through destination() copies the encoded message into a
+ * fixed-size record on the calling core's ring without taking a lock; if the
+ * ring is full, the record is dropped and counted. drain() (called from one
+ * background context) merges the rings in timestamp order and writes the
+ * records to the real transport.
+ *
+ * @tparam NumRings       The number of rings (usually the number of cores).
+ * @tparam RingCapacity   The number of records per ring (a power of two).
+ * @tparam MaxRecordBytes The size of the largest message that can be logged.
+ * @tparam RingIndex      Returns the ring for the calling core or thread.
+ *                        Indices wrap, so rings may be shared.
+ * @tparam Timestamp      Returns a monotonic timestamp.
+ */
+template <std::size_t NumRings, std::size_t RingCapacity,
+          std::size_t MaxRecordBytes = 32,
+          typename RingIndex = logging::thread_index,
+          typename Timestamp = steady_timestamp>
+class per_core_rings {
+    enum struct record_kind : std::uint8_t { args, buf };
+
+    struct record {
+        std::uint64_t timestamp;
+        std::uint16_t size;
+        record_kind kind;
+        std::array<std::uint8_t, MaxRecordBytes> data;
+    };
+
+    using ring_t = logging::detail::mpsc_queue<record, RingCapacity>;
+
+    auto push(record_kind kind, void const *data, std::size_t size) -> void {
+        auto r = record{Timestamp{}(), static_cast<std::uint16_t>(size), kind,
+                        {}};
+        std::memcpy(r.data.data(), data, size);
+        if (not rings[RingIndex{}() % NumRings].try_push(r)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    template <std::size_t N, typename Transport>
+    static auto emit_args(Transport &t, record const &r) -> void {
+        auto words = std::array<std::uint32_t, N>{};
+        std::memcpy(words.data(), r.data.data(), sizeof(words));
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            if constexpr (requires { t.log_by_args(words[Is]...); }) {
+                t.log_by_args(words[Is]...);
+            }
+        }(std::make_index_sequence<N>{});
+    }
+
+    template <typename Transport>
+    static auto emit(Transport &t, record const &r) -> void {
+        if (r.kind == record_kind::buf) {
+            t.log_by_buf(stdx::span<std::uint8_t const>{r.data.data(), r.size});
+            return;
+        }
+        constexpr auto max_words = MaxRecordBytes / sizeof(std::uint32_t);
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            auto const words = r.size / sizeof(std::uint32_t);
+            (void)(... or
+                   (words == Is + 1 and (emit_args<Is + 1>(t, r), true)));
+        }(std::make_index_sequence<max_words>{});
+    }
+
+    std::array<ring_t, NumRings> rings{};
+    std::atomic<std::size_t> dropped{};
+    // drainer state: the next record from each ring
+    std::array<std::optional<record>, NumRings> heads{};
+
+  public:
+    // A destination for logging::binary::config; it refers to these rings.
+    struct destination_t {
+        using concurrent_t = void;
+
+        template <typename... Args>
+        auto log_by_args(std::uint32_t header, Args... args) -> void {
+            static_assert(sizeof(std::uint32_t) * (1 + sizeof...(Args)) <=
+                              MaxRecordBytes,
+                          "Log message is too large for per_core_rings");
+            auto const words =
+                std::array{header, static_cast<std::uint32_t>(args)...};
+            rings->push(record_kind::args, words.data(), sizeof(words));
+        }
+
+        template <std::size_t N>
+        auto log_by_buf(stdx::span<std::uint8_t const, N> buf) -> void {
+            if constexpr (N == stdx::dynamic_extent) {
+                // variable-length messages that don't fit are dropped
+                if (buf.size() > MaxRecordBytes) {
+                    rings->dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+            } else {
+                static_assert(N <= MaxRecordBytes,
+                              "Log message is too large for per_core_rings");
+            }
+            rings->push(record_kind::buf, buf.data(), buf.size());
+        }
+
+        per_core_rings *rings;
+    };
+
+    [[nodiscard]] auto destination() -> destination_t {
+        return destination_t{this};
+    }
+
+    // Must be called from one context at a time. Writes at most the records
+    // present on entry, so it returns even while producers keep logging.
+    // Returns the number of records written to the transport.
+    template <typename Transport> auto drain(Transport &t) -> std::size_t {
+        // the records left to write from each ring, including its head
+        auto left = std::array<std::size_t, NumRings>{};
+        for (auto i = std::size_t{}; i < NumRings; ++i) {
+            if (not heads[i]) {
+                heads[i] = rings[i].try_pop();
+            }
+            left[i] = rings[i].size() + (heads[i] ? 1u : 0u);
+        }
+
+        auto n = std::size_t{};
+        while (true) {
+            auto next = NumRings;
+            for (auto i = std::size_t{}; i < NumRings; ++i) {
+                if (heads[i] and left[i] > 0 and
+                    (next == NumRings or
+                     heads[i]->timestamp < heads[next]->timestamp)) {
+                    next = i;
+                }
+            }
+            if (next == NumRings) {
+                return n;
+            }
+            emit(t, *heads[next]);
+            heads[next].reset();
+            if (--left[next] > 0) {
+                heads[next] = rings[next].try_pop();
+            }
+            ++n;
+        }
+    }
+
+    [[nodiscard]] auto num_dropped() const -> std::size_t {
+        return dropped.load(std::memory_order_relaxed);
+    }
+};
+} // namespace logging::binary
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <stdx/bit.hpp>
+#include <stdx/span.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace logging::binary {
+struct steady_timestamp {
+    auto operator()() const -> std::uint64_t {
+        return static_cast<std::uint64_t>(
+            std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+};
+
+/**
+ * A destination that adds a time delta to each catalog message.
+ *
+ * The delta is the time since the previous timestamped message, in ticks of
+ * TimeSource (e.g. a cycle counter), saturated to 32 bits. It is inserted
+ * after the header, and the header's catalog subtype is set to delta_subtype
+ * (or varint_delta_subtype, for a message with varint arguments) to say so.
+ * Other messages are passed through unchanged, as are
+ * variable-length messages that would grow beyond MaxRecordBytes.
+ *
+ * NOTE: The delta is not a Sys-T timestamp (which is 64 bits), so the
+ * header's timestamp bit stays clear. The delta subtypes are private to this
+ * library: only cib_log_decode understands them.
+ */
+template <typename Dest, typename TimeSource = steady_timestamp,
+          std::size_t MaxRecordBytes = 64>
+class timestamped {
+    constexpr static auto header_bytes = sizeof(std::uint32_t);
+    constexpr static auto delta_bytes = sizeof(std::uint32_t);
+
+    // see logging::mipi::defn
+    constexpr static auto type_mask = std::uint32_t{0xfu};
+    constexpr static auto catalog_type = std::uint32_t{3u};
+    constexpr static auto subtype_mask = std::uint32_t{0x3fu << 24u};
+    constexpr static auto varint_subtype = std::uint32_t{0x3eu};
+
+    Dest dest;
+    std::uint64_t last{};
+
+    [[nodiscard]] constexpr static auto is_catalog(std::uint32_t header)
+        -> bool {
+        return (header & type_mask) == catalog_type;
+    }
+
+    [[nodiscard]] constexpr static auto with_delta(std::uint32_t header)
+        -> std::uint32_t {
+        auto const subtype = (header & subtype_mask) >> 24u;
+        return (header & ~subtype_mask) |
+               ((subtype == varint_subtype ? varint_delta_subtype
+                                           : delta_subtype)
+                << 24u);
+    }
+
+    auto next_delta() -> std::uint32_t {
+        auto const now = TimeSource{}();
+        auto const delta = now - last;
+        last = now;
+        constexpr auto max = std::numeric_limits<std::uint32_t>::max();
+        return delta > max ? max : static_cast<std::uint32_t>(delta);
+    }
+
+    // Copies buf to dest with the delta after the header.
+    template <std::size_t N>
+    auto insert_delta(stdx::span<std::uint8_t const> buf, std::uint32_t header,
+                      std::array<std::uint8_t, N> &out) -> std::size_t {
+        auto const stamped = stdx::to_le(with_delta(header));
+        auto const delta = stdx::to_le(next_delta());
+        std::memcpy(out.data(), &stamped, header_bytes);
+        std::memcpy(out.data() + header_bytes, &delta, delta_bytes);
+        std::memcpy(out.data() + header_bytes + delta_bytes,
+                    buf.data() + header_bytes, buf.size() - header_bytes);
+        return buf.size() + delta_bytes;
+    }
+
+  public:
+    // the catalog subtypes of a message with a delta: Sys-T does not assign
+    // them, and other decoders will not read the message
+    constexpr static auto delta_subtype = std::uint32_t{0x3fu};
+    constexpr static auto varint_delta_subtype = std::uint32_t{0x3du};
+
+    constexpr explicit timestamped(Dest d) : dest{std::move(d)} {}
+
+    template <typename... Args>
+    auto log_by_args(std::uint32_t header, Args... args) -> void {
+        if (is_catalog(header)) {
+            dest.log_by_args(with_delta(header), next_delta(), args...);
+        } else {
+            dest.log_by_args(header, args...);
+        }
+    }
+
+    template <std::size_t N>
+    auto log_by_buf(stdx::span<std::uint8_t const, N> buf) -> void {
+        auto header = std::uint32_t{};
+        if (buf.size() < header_bytes) {
+            dest.log_by_buf(buf);
+            return;
+        }
+        std::memcpy(&header, buf.data(), header_bytes);
+        header = stdx::from_le(header);
+        if (not is_catalog(header)) {
+            dest.log_by_buf(buf);
+            return;
+        }
+
+        if constexpr (N == stdx::dynamic_extent) {
+            if (buf.size() + delta_bytes > MaxRecordBytes) {
+                dest.log_by_buf(buf);
+                return;
+            }
+            auto out = std::array<std::uint8_t, MaxRecordBytes>{};
+            auto const size = insert_delta(buf, header, out);
+            dest.log_by_buf(stdx::span<std::uint8_t const>{out.data(), size});
+        } else {
+            auto out = std::array<std::uint8_t, N + delta_bytes>{};
+            insert_delta(buf, header, out);
+            dest.log_by_buf(
+                stdx::span<std::uint8_t const, N + delta_bytes>{out});
+        }
+    }
+};
+} // namespace logging::binary
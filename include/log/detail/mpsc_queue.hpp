@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace logging::detail {
+constexpr inline auto cache_line_size = std::size_t{64};
+
+/**
+ * A bounded, lock-free, multi-producer single-consumer FIFO queue.
+ *
+ * This is the array-based queue with a sequence number per cell (after
+ * Vyukov). Sequence numbers are stored relative to the cell index so that the
+ * zero-initialized state is the empty queue, and a queue with static storage
+ * duration needs no runtime initialization.
+ */
+template <typename T, std::size_t Capacity> class mpsc_queue {
+    static_assert(std::has_single_bit(Capacity),
+                  "mpsc_queue capacity must be a power of two");
+    static_assert(std::is_nothrow_move_constructible_v<T>,
+                  "mpsc_queue elements must be nothrow move constructible");
+
+    constexpr static auto mask = Capacity - 1u;
+
+    struct cell {
+        std::atomic<std::size_t> seq{};
+        // NOLINTNEXTLINE(*-avoid-c-arrays)
+        alignas(T) std::byte storage[sizeof(T)];
+
+        auto value() -> T * {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            return std::launder(reinterpret_cast<T *>(storage));
+        }
+    };
+
+    alignas(cache_line_size) std::atomic<std::size_t> enqueue_pos{};
+    alignas(cache_line_size) std::size_t dequeue_pos{};
+    alignas(cache_line_size) std::array<cell, Capacity> cells{};
+
+    // the sequence number of the cell at idx, as if it had been initialized
+    // with its own index
+    [[nodiscard]] constexpr static auto relative(std::size_t pos)
+        -> std::size_t {
+        return pos - (pos & mask);
+    }
+
+  public:
+    constexpr static auto capacity() -> std::size_t { return Capacity; }
+
+    template <typename... Args> auto try_push(Args &&...args) -> bool {
+        auto pos = enqueue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            auto &c = cells[pos & mask];
+            auto const seq = c.seq.load(std::memory_order_acquire);
+            auto const diff = static_cast<std::ptrdiff_t>(seq - relative(pos));
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    std::construct_at(c.value(), std::forward<Args>(args)...);
+                    c.seq.store(relative(pos) + 1,
+                                std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // must only be called from the single consumer
+    auto try_pop() -> std::optional<T> {
+        auto &c = cells[dequeue_pos & mask];
+        auto const seq = c.seq.load(std::memory_order_acquire);
+        if (seq != relative(dequeue_pos) + 1) {
+            return {};
+        }
+        auto v = std::optional<T>{std::move(*c.value())};
+        std::destroy_at(c.value());
+        c.seq.store(relative(dequeue_pos) + Capacity,
+                    std::memory_order_release);
+        ++dequeue_pos;
+        return v;
+    }
+
+    // approximate: only exact when producers and consumer are quiescent
+    [[nodiscard]] auto size() const -> std::size_t {
+        return enqueue_pos.load(std::memory_order_relaxed) - dequeue_pos;
+    }
+    [[nodiscard]] auto empty() const -> bool { return size() == 0; }
+};
+} // namespace logging::detail
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <log/detail/mpsc_queue.hpp>
 #include <log/level.hpp>
 #include <log/log.hpp>
 #include <log/module.hpp>
+#include <log/thread_index.hpp>
 
 #include <stdx/bit.hpp>
 #include <stdx/ct_format.hpp>
@@ -11,10 +13,17 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
 #include <chrono>
+#include <cstddef>
+#include <cstring>
 #include <iterator>
+#include <optional>
 #include <string_view>
+#include <type_traits>
 #include <utility>
 
 namespace logging {
@@ -36,34 +45,44 @@ template <logging::level L>
 }
 
 namespace fmt {
+namespace detail {
+inline auto const start_time = std::chrono::steady_clock::now();
+
+template <typename Env, typename Str, typename TDestinations, typename... Args>
+auto write_line(TDestinations &dests,
+                std::chrono::steady_clock::time_point time,
+                Args const &...args) -> void {
+    auto const currentTime =
+        std::chrono::duration_cast<std::chrono::microseconds>(time -
+                                                              start_time)
+            .count();
+
+    stdx::for_each(
+        [&](auto &out) {
+            ::fmt::format_to(out, "{:>8}us {} [{}]: ", currentTime,
+                             level_wrapper<get_level(Env{})>{},
+                             get_module(Env{}));
+            constexpr auto fmtstr = std::string_view{Str::value};
+            ::fmt::format_to(out, fmtstr, args...);
+            *out = '\n';
+        },
+        dests);
+}
+} // namespace detail
+
 template <typename TDestinations> struct log_handler {
     constexpr explicit log_handler(TDestinations &&ds) : dests{std::move(ds)} {}
 
     template <typename Env, typename FilenameStringType,
               typename LineNumberType, typename FmtResult>
     auto log(FilenameStringType, LineNumberType, FmtResult const &fr) -> void {
-        auto const currentTime =
-            std::chrono::duration_cast<std::chrono::microseconds>(
-                std::chrono::steady_clock::now() - start_time)
-                .count();
-
-        stdx::for_each(
-            [&](auto &out) {
-                ::fmt::format_to(out, "{:>8}us {} [{}]: ", currentTime,
-                                 level_wrapper<get_level(Env{})>{},
-                                 get_module(Env{}));
-                constexpr auto fmtstr =
-                    std::string_view{decltype(fr.str)::value};
-                fr.args.apply([&](auto const &...args) {
-                    ::fmt::format_to(out, fmtstr, args...);
-                });
-                *out = '\n';
-            },
-            dests);
+        fr.args.apply([&](auto const &...args) {
+            detail::write_line<Env, decltype(fr.str)>(
+                dests, std::chrono::steady_clock::now(), args...);
+        });
     }
 
   private:
-    static inline auto const start_time = std::chrono::steady_clock::now();
     TDestinations dests;
 };
 
@@ -74,5 +93,181 @@ template <typename... TDestinations> struct config {
 
     log_handler<destinations_tuple_t> logger;
 };
+
+/**
+ * Sizes for deferred formatting.
+ *
+ * @tparam NumQueues     The number of queues; each thread uses one.
+ * @tparam QueueCapacity The number of log calls each queue holds (a power of
+ *                       two).
+ * @tparam MaxArgBytes   The maximum total size of a log call's arguments.
+ * @tparam MaxTextBytes  The maximum length of a message formatted at the log
+ *                       call; longer messages are truncated.
+ */
+template <std::size_t NumQueues = 8, std::size_t QueueCapacity = 1024,
+          std::size_t MaxArgBytes = 64, std::size_t MaxTextBytes = 128>
+struct deferred_params {
+    constexpr static auto num_queues = NumQueues;
+    constexpr static auto queue_capacity = QueueCapacity;
+    constexpr static auto max_arg_bytes = MaxArgBytes;
+    constexpr static auto max_text_bytes = MaxTextBytes;
+};
+
+/**
+ * A log handler that defers formatting to flush().
+ *
+ * A log call records a pointer to a function that knows the format string and
+ * argument types, a raw timestamp, and the argument bytes, in the calling
+ * thread's queue. flush() (called from a background thread, or explicitly)
+ * does the formatting, and is the only writer to the destinations. It merges
+ * the queues in timestamp order.
+ *
+ * Log calls with arguments that are not arithmetic or enumeration values (or
+ * that are too large) are formatted into text at the call, and the text is
+ * queued like any other call. When a queue is full, the call is dropped and
+ * counted.
+ */
+template <typename Params, typename TDestinations,
+          typename ThreadIndex = logging::thread_index>
+struct deferred_log_handler {
+    constexpr explicit deferred_log_handler(TDestinations &&ds)
+        : dests{std::move(ds)} {}
+
+    template <typename Env, typename FilenameStringType,
+              typename LineNumberType, typename FmtResult>
+    auto log(FilenameStringType, LineNumberType, FmtResult const &fr) -> void {
+        auto const now = std::chrono::steady_clock::now();
+        fr.args.apply([&]<typename... Args>(Args const &...args) {
+            auto r = record{nullptr, now.time_since_epoch().count(), {}, {}};
+            if constexpr (deferrable<Args...>) {
+                r.format = &format<Env, decltype(fr.str), Args...>;
+                auto p = r.data.data();
+                ((std::memcpy(p, &args, sizeof(Args)), p += sizeof(Args)),
+                 ...);
+            } else {
+                r.format = &format_text<Env>;
+                constexpr auto fmtstr =
+                    std::string_view{decltype(fr.str)::value};
+                auto const result = ::fmt::format_to_n(
+                    r.data.data(), Params::max_text_bytes, fmtstr, args...);
+                r.size = std::min(result.size, Params::max_text_bytes);
+            }
+            auto &q = queues[ThreadIndex{}() % Params::num_queues];
+            if (not q.try_push(r)) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    // Format the log calls queued on entry, merging the queues in timestamp
+    // order. Must be called from one thread at a time. Returns the number of
+    // log calls formatted.
+    auto flush() -> std::size_t {
+        // the next call from each queue, and the calls left to format from
+        // it, including that one
+        auto heads = std::array<std::optional<record>, Params::num_queues>{};
+        auto left = std::array<std::size_t, Params::num_queues>{};
+        for (auto i = std::size_t{}; i < Params::num_queues; ++i) {
+            left[i] = queues[i].size();
+            if (left[i] > 0) {
+                heads[i] = queues[i].try_pop();
+            }
+        }
+
+        auto n = std::size_t{};
+        while (true) {
+            auto next = Params::num_queues;
+            for (auto i = std::size_t{}; i < Params::num_queues; ++i) {
+                if (heads[i] and (next == Params::num_queues or
+                                  heads[i]->time < heads[next]->time)) {
+                    next = i;
+                }
+            }
+            if (next == Params::num_queues) {
+                return n;
+            }
+            auto const r = *std::exchange(heads[next], std::nullopt);
+            r.format(*this, r);
+            if (--left[next] > 0) {
+                heads[next] = queues[next].try_pop();
+            }
+            ++n;
+        }
+    }
+
+    [[nodiscard]] auto num_dropped() const -> std::size_t {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+  private:
+    using clock_type = std::chrono::steady_clock;
+
+    // only values are deferred: pointers and views might dangle by the time
+    // they are formatted
+    template <typename... Args>
+    constexpr static auto deferrable =
+        (... and (std::is_arithmetic_v<Args> or std::is_enum_v<Args>)) and
+        (0 + ... + sizeof(Args)) <= Params::max_arg_bytes;
+
+    struct record {
+        auto (*format)(deferred_log_handler &, record const &) -> void;
+        clock_type::rep time;
+        // the length of the text of a call formatted when it was logged
+        std::size_t size;
+        // the argument bytes, or the text
+        std::array<char, std::max(Params::max_arg_bytes,
+                                  Params::max_text_bytes)>
+            data;
+    };
+
+    // the format string of a call formatted when it was logged
+    struct text_format {
+        constexpr static auto value = std::string_view{"{}"};
+    };
+
+    [[nodiscard]] static auto time_of(record const &r)
+        -> clock_type::time_point {
+        return clock_type::time_point{clock_type::duration{r.time}};
+    }
+
+    template <typename T> static auto read_arg(char const *&p) -> T {
+        auto bytes = std::array<std::byte, sizeof(T)>{};
+        std::memcpy(bytes.data(), p, sizeof(T));
+        p += sizeof(T);
+        return std::bit_cast<T>(bytes);
+    }
+
+    template <typename Env, typename Str, typename... Args>
+    static auto format(deferred_log_handler &h, record const &r) -> void {
+        auto p = r.data.data();
+        auto const args = stdx::tuple<Args...>{read_arg<Args>(p)...};
+        args.apply([&](auto const &...as) {
+            detail::write_line<Env, Str>(h.dests, time_of(r), as...);
+        });
+    }
+
+    template <typename Env>
+    static auto format_text(deferred_log_handler &h, record const &r)
+        -> void {
+        detail::write_line<Env, text_format>(
+            h.dests, time_of(r), std::string_view{r.data.data(), r.size});
+    }
+
+    TDestinations dests;
+    std::array<logging::detail::mpsc_queue<record, Params::queue_capacity>,
+               Params::num_queues>
+        queues{};
+    std::atomic<std::size_t> dropped{};
+};
+
+template <typename Params, typename... TDestinations> struct deferred_config {
+    using destinations_tuple_t = stdx::tuple<TDestinations...>;
+    constexpr explicit deferred_config(Params, TDestinations... dests)
+        : logger{stdx::tuple{std::move(dests)...}} {}
+
+    deferred_log_handler<Params, destinations_tuple_t> logger;
+};
+template <typename Params, typename... Ts>
+deferred_config(Params, Ts...) -> deferred_config<Params, Ts...>;
 } // namespace fmt
 } // namespace logging
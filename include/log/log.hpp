@@ -4,6 +4,8 @@
 #include <log/flavor.hpp>
 #include <log/level.hpp>
 #include <log/module.hpp>
+#include <log/rate_limit.hpp>
+#include <log/string_id.hpp>
 
 #include <stdx/compiler.hpp>
 #include <stdx/ct_format.hpp>
@@ -16,7 +18,9 @@
 #include <stdx/type_traits.hpp>
 #include <stdx/utility.hpp>
 
+#include <concepts>
 #include <cstdint>
+#include <type_traits>
 #include <utility>
 
 namespace version {
@@ -51,10 +55,40 @@ constexpr static auto get_config() -> auto & {
     }
 }
 
+namespace detail {
+template <typename Env, typename Limit, typename Logger, typename F,
+          typename L, typename FmtResult>
+auto log_rate_limited(Logger &logger, F const &file, L line, FmtResult &&fr)
+    -> void {
+    auto &state = rate_limit::call_site_state<Limit, Env,
+                                              std::remove_cvref_t<FmtResult>>;
+    auto const admitted = Limit::admit(state);
+    if (not admitted.log) {
+        return;
+    }
+    logger.template log<Env>(file, line, std::forward<FmtResult>(fr));
+    if (admitted.suppressed != 0) {
+        using report_env_t =
+            stdx::extend_env_t<Env, get_rate_limit, rate_limit::unlimited{},
+                               get_string_id, -1>;
+        logger.template log<report_env_t>(
+            file, line,
+            stdx::ct_format<"{} records suppressed by rate limit">(
+                admitted.suppressed));
+    }
+}
+} // namespace detail
+
 template <typename Env, typename... Ts, typename... TArgs>
 static auto log(TArgs &&...args) -> void {
     auto &cfg = get_config<Env, Ts...>();
-    cfg.logger.template log<Env>(std::forward<TArgs>(args)...);
+    using limit_t = std::remove_cvref_t<decltype(get_rate_limit(Env{}))>;
+    if constexpr (std::same_as<limit_t, rate_limit::unlimited>) {
+        cfg.logger.template log<Env>(std::forward<TArgs>(args)...);
+    } else {
+        detail::log_rate_limited<Env, limit_t>(cfg.logger,
+                                               std::forward<TArgs>(args)...);
+    }
 }
 
 namespace detail {
@@ -102,8 +136,11 @@ template <stdx::ct_string Fmt, typename Env, typename F, typename L>
 
     constexpr auto N = stdx::num_fmt_specifiers<Fmt>;
     constexpr auto sz = sizeof...(args);
+    // a fatal message is never rate limited
     using env_t =
-        stdx::extend_env_t<Env, logging::get_level, logging::level::FATAL>;
+        stdx::extend_env_t<Env, logging::get_level, logging::level::FATAL,
+                           logging::get_rate_limit,
+                           logging::rate_limit::unlimited{}>;
 
 #if __cpp_pack_indexing >= 202311L
     auto s = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <stdx/bit.hpp>
+#include <stdx/ct_string.hpp>
+#include <stdx/panic.hpp>
+#include <stdx/span.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+namespace logging {
+/**
+ * A circular buffer of log records that survives the process.
+ *
+ * The buffer lives in memory provided by the caller: typically a shared
+ * memory-mapped file, so that records written before a crash remain in the
+ * file without a system call per record (or, on a microcontroller, RAM that
+ * is not cleared on reset). Any number of writers may log concurrently
+ * without a lock.
+ *
+ * The layout is read back by cib_log_decode --ring:
+ *
+ * - A 32-byte header: magic, version, number of slots, slot size, then the
+ *   head (the sequence number of the next record). The tail is the oldest
+ *   record still in the buffer: head - number of slots, or 0.
+ * - Fixed-size slots, each with the sequence number of its record (plus one;
+ *   zero while it is being written), the record size and kind (binary or
+ *   text), then the record bytes.
+ *
+ * If the memory already holds a buffer with the same geometry, logging
+ * carries on after its last record, so the records from before a crash are
+ * kept until they are overwritten.
+ *
+ * @tparam MaxRecordBytes The size of the largest record; longer records are
+ *                        dropped and counted, longer lines of text are cut.
+ */
+template <std::size_t MaxRecordBytes = 64> class persistent_ring {
+    static_assert(MaxRecordBytes <= 0xffff);
+
+  public:
+    constexpr static auto magic = std::uint32_t{0x4c42'4943}; // "CIBL"
+    constexpr static auto version = std::uint32_t{1};
+    constexpr static auto header_bytes = std::size_t{32};
+    constexpr static auto slot_header_bytes = std::size_t{16};
+    constexpr static auto slot_bytes =
+        (slot_header_bytes + MaxRecordBytes + 7u) / 8u * 8u;
+
+    enum struct record_kind : std::uint8_t { binary = 0, text = 1 };
+
+  private:
+    struct header_t {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t num_slots;
+        std::uint32_t slot_bytes;
+        alignas(8) std::uint64_t head;
+        std::uint64_t reserved;
+    };
+    static_assert(sizeof(header_t) == header_bytes);
+
+    struct slot_t {
+        alignas(8) std::uint64_t seq;
+        std::uint16_t size;
+        record_kind kind;
+        std::array<std::uint8_t, 5> reserved;
+        std::array<std::uint8_t, slot_bytes - slot_header_bytes> data;
+    };
+    static_assert(sizeof(slot_t) == slot_bytes);
+
+    header_t *header{};
+    slot_t *slots{};
+    std::size_t num_slots{};
+    std::atomic<std::size_t> dropped{};
+
+    auto push(record_kind kind, void const *data, std::size_t size) -> void {
+        if (size > MaxRecordBytes or num_slots == 0) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        auto const seq = std::atomic_ref{header->head}.fetch_add(
+            1, std::memory_order_relaxed);
+        auto &slot = slots[seq % num_slots];
+
+        // mark the slot as being written, so that recovery skips it if the
+        // process dies before the record is complete
+        std::atomic_ref{slot.seq}.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.size = static_cast<std::uint16_t>(size);
+        slot.kind = kind;
+        std::memcpy(slot.data.data(), data, size);
+        std::atomic_ref{slot.seq}.store(seq + 1, std::memory_order_release);
+    }
+
+  public:
+    // Memory must be 8-byte aligned, with room for the header and one slot.
+    // Otherwise this panics, and if the panic returns, the ring is unusable:
+    // every record is dropped.
+    persistent_ring(void *memory, std::size_t bytes) {
+        auto const address = reinterpret_cast<std::uintptr_t>(memory);
+        if (memory == nullptr or address % alignof(header_t) != 0 or
+            bytes < bytes_for(1)) {
+            using namespace stdx::literals;
+            stdx::panic<"Persistent ring memory is "_cts +
+                        "misaligned or too small"_cts>();
+            return;
+        }
+
+        header = static_cast<header_t *>(memory);
+        slots = reinterpret_cast<slot_t *>(static_cast<std::byte *>(memory) +
+                                           header_bytes);
+        num_slots = (bytes - header_bytes) / slot_bytes;
+        if (header->magic != magic or header->version != version or
+            header->num_slots != num_slots or
+            header->slot_bytes != slot_bytes) {
+            std::memset(memory, 0, header_bytes + num_slots * slot_bytes);
+            header->version = version;
+            header->num_slots = static_cast<std::uint32_t>(num_slots);
+            header->slot_bytes = static_cast<std::uint32_t>(slot_bytes);
+            std::atomic_ref{header->magic}.store(magic,
+                                                 std::memory_order_release);
+        }
+    }
+
+    // The memory needed for a buffer of num records.
+    [[nodiscard]] constexpr static auto bytes_for(std::size_t num)
+        -> std::size_t {
+        return header_bytes + num * slot_bytes;
+    }
+
+    // A destination for logging::binary::config.
+    struct destination_t {
+        using concurrent_t = void;
+
+        template <typename... Args>
+        auto log_by_args(std::uint32_t header, Args... args) -> void {
+            auto const words = std::array{
+                stdx::to_le(header),
+                stdx::to_le(static_cast<std::uint32_t>(args))...};
+            ring->push(record_kind::binary, words.data(), sizeof(words));
+        }
+
+        template <std::size_t N>
+        auto log_by_buf(stdx::span<std::uint8_t const, N> buf) -> void {
+            ring->push(record_kind::binary, buf.data(), buf.size());
+        }
+
+        persistent_ring *ring;
+    };
+
+    /**
+     * An output iterator for logging::fmt::config that stores each line as
+     * a text record.
+     *
+     * The line being formatted is kept by the iterator's owner, text_sink,
+     * which (like any fmt destination) must not be shared between threads.
+     */
+    class text_sink {
+        persistent_ring *ring;
+        std::array<char, MaxRecordBytes> line{};
+        std::size_t len{};
+
+      public:
+        explicit text_sink(persistent_ring &r) : ring{&r} {}
+
+        auto put(char c) -> void {
+            if (c == '\n') {
+                ring->push(record_kind::text, line.data(), len);
+                len = 0;
+            } else if (len < line.size()) {
+                line[len++] = c;
+            }
+        }
+
+        struct iterator {
+            using iterator_category = std::output_iterator_tag;
+            using value_type = void;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = void;
+
+            auto operator*() -> iterator & { return *this; }
+            auto operator++() -> iterator & { return *this; }
+            auto operator++(int) -> iterator { return *this; }
+            auto operator=(char c) -> iterator & {
+                sink->put(c);
+                return *this;
+            }
+
+            text_sink *sink;
+        };
+
+        [[nodiscard]] auto begin() -> iterator { return {this}; }
+    };
+
+    [[nodiscard]] auto destination() -> destination_t { return {this}; }
+
+    [[nodiscard]] auto head() const -> std::uint64_t {
+        if (header == nullptr) {
+            return 0;
+        }
+        return std::atomic_ref{header->head}.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto capacity() const -> std::size_t { return num_slots; }
+
+    [[nodiscard]] auto num_dropped() const -> std::size_t {
+        return dropped.load(std::memory_order_relaxed);
+    }
+};
+} // namespace logging
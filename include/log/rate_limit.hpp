@@ -0,0 +1,114 @@
+#pragma once
+
+#include <log/env.hpp>
+
+#include <stdx/compiler.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+
+namespace logging {
+namespace rate_limit {
+// Every record is logged.
+struct unlimited {};
+
+struct admission {
+    bool log;
+    std::uint32_t suppressed;
+};
+
+/**
+ * Log the first of every N records from a call site. Every ReportEvery logged
+ * records, a report of the records suppressed in between is also logged.
+ */
+template <std::uint32_t N, std::uint32_t ReportEvery = 64> struct one_in {
+    static_assert(N > 0, "one_in needs N > 0");
+    static_assert(ReportEvery > 0, "one_in needs ReportEvery > 0");
+
+    struct state_t {
+        std::atomic<std::uint32_t> count{};
+    };
+
+    static auto admit(state_t &s) -> admission {
+        auto const c = s.count.fetch_add(1, std::memory_order_relaxed);
+        if (c % N != 0) {
+            return {false, 0};
+        }
+        auto const logged = c / N;
+        auto const report = logged != 0 and logged % ReportEvery == 0;
+        return {true, report ? ReportEvery * (N - 1) : 0};
+    }
+};
+
+struct steady_ticks {
+    auto operator()() const -> std::uint64_t {
+        return static_cast<std::uint64_t>(
+            std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+};
+
+/**
+ * Allow bursts of up to Burst records from a call site, refilled at one
+ * record per Interval ticks of Clock. The first record logged after some were
+ * suppressed is followed by a report of how many.
+ *
+ * @tparam Clock  Returns a monotonic tick count; steady_clock by default.
+ */
+template <std::uint32_t Burst, std::uint64_t Interval,
+          typename Clock = steady_ticks>
+struct token_bucket {
+    static_assert(Burst > 0, "token_bucket needs Burst > 0");
+
+    // The bucket is kept as the time at which it will be full again (the
+    // generic cell rate algorithm), so that one atomic holds its state.
+    struct state_t {
+        std::atomic<std::uint64_t> full_at{};
+        std::atomic<std::uint32_t> suppressed{};
+    };
+
+    static auto admit(state_t &s) -> admission {
+        constexpr auto tolerance = std::uint64_t{Burst - 1} * Interval;
+        auto const now = Clock{}();
+        auto full_at = s.full_at.load(std::memory_order_relaxed);
+        while (true) {
+            auto const start = std::max(full_at, now);
+            if (start - now > tolerance) {
+                s.suppressed.fetch_add(1, std::memory_order_relaxed);
+                return {false, 0};
+            }
+            if (s.full_at.compare_exchange_weak(full_at, start + Interval,
+                                                std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        return {true, s.suppressed.exchange(0, std::memory_order_relaxed)};
+    }
+};
+
+// One state per call site: Site is the type of the compile-time formatted
+// message, so no lookup is needed.
+template <typename Limit, typename Env, typename Site>
+inline auto call_site_state = typename Limit::state_t{};
+} // namespace rate_limit
+
+[[maybe_unused]] constexpr inline struct get_rate_limit_t {
+    template <typename T>
+        requires true // more constrained
+    CONSTEVAL auto operator()(T &&t) const noexcept(
+        noexcept(std::forward<T>(t).query(std::declval<get_rate_limit_t>())))
+        -> decltype(std::forward<T>(t).query(*this)) {
+        return std::forward<T>(t).query(*this);
+    }
+
+    CONSTEVAL auto operator()(auto &&) const {
+        return rate_limit::unlimited{};
+    }
+} get_rate_limit;
+} // namespace logging
+
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define CIB_LOG_RATE_LIMIT(...)                                                \
+    CIB_LOG_ENV(logging::get_rate_limit, __VA_ARGS__)
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace logging {
+// A small index for the calling thread, assigned in order of first use. Used
+// to give each thread its own queue.
+struct thread_index {
+    auto operator()() const -> std::size_t {
+        static auto next = std::atomic<std::size_t>{};
+        thread_local auto const idx =
+            next.fetch_add(1, std::memory_order_relaxed);
+        return idx;
+    }
+};
+} // namespace logging
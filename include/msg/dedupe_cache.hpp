@@ -0,0 +1,100 @@
+#pragma once
+
+#include <msg/message.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+namespace msg {
+/**
+ * A fixed-size cache of recently seen messages, for dropping retransmissions.
+ *
+ * The cache is set-associative: a message's hash selects a set of Ways slots,
+ * and within a set, slots are replaced round-robin. A message is a duplicate
+ * if an equivalent message is still in its set. The cache is not thread-safe.
+ *
+ * @tparam Defn     The message definition.
+ * @tparam Capacity The total number of messages remembered.
+ * @tparam Ways     The number of slots per set.
+ */
+template <typename Defn, std::size_t Capacity, std::size_t Ways = 4>
+class dedupe_cache {
+    static_assert(Capacity % Ways == 0,
+                  "dedupe_cache capacity must be a multiple of its ways");
+    static_assert(std::has_single_bit(Capacity / Ways),
+                  "dedupe_cache must have a power-of-two number of sets");
+
+    constexpr static auto num_sets = Capacity / Ways;
+
+    using field_mask_t = typename Defn::field_mask_t;
+    static_assert(field_mask_t::bitwise_comparable,
+                  "dedupe_cache requires all fields to be of integral or "
+                  "enumeration type");
+
+    using msg_t = const_view<Defn>;
+    using storage_t = typename Defn::default_storage_t;
+
+    struct slot {
+        std::uint64_t hash{};
+        storage_t data{};
+        bool valid{};
+    };
+
+    struct set {
+        std::array<slot, Ways> slots{};
+        std::size_t next_victim{};
+    };
+
+    std::array<set, num_sets> sets{};
+
+    [[nodiscard]] constexpr static auto find(set const &s, std::uint64_t h,
+                                             msg_t m) -> bool {
+        for (auto const &sl : s.slots) {
+            if (sl.valid and sl.hash == h and
+                field_mask_t::equal(sl.data, m.data())) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] constexpr auto set_for(std::uint64_t h) -> set & {
+        return sets[h & (num_sets - 1u)];
+    }
+    [[nodiscard]] constexpr auto set_for(std::uint64_t h) const
+        -> set const & {
+        return sets[h & (num_sets - 1u)];
+    }
+
+  public:
+    constexpr static auto capacity() -> std::size_t { return Capacity; }
+
+    // Returns true if the message is new (and remembers it), or false if an
+    // equivalent message was seen recently.
+    constexpr auto insert(msg_t m) -> bool {
+        auto const h = msg::hash(m);
+        auto &s = set_for(h);
+        if (find(s, h, m)) {
+            return false;
+        }
+        auto &victim = s.slots[s.next_victim];
+        s.next_victim = (s.next_victim + 1u) % Ways;
+        victim.hash = h;
+        std::copy_n(std::cbegin(m.data()), victim.data.size(),
+                    std::begin(victim.data));
+        victim.valid = true;
+        return true;
+    }
+
+    [[nodiscard]] constexpr auto contains(msg_t m) const -> bool {
+        auto const h = msg::hash(m);
+        return find(set_for(h), h, m);
+    }
+
+    constexpr auto clear() -> void { sets = {}; }
+};
+} // namespace msg
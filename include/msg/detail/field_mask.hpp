@@ -0,0 +1,108 @@
+#pragma once
+
+#include <stdx/bit.hpp>
+#include <stdx/compiler.hpp>
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace msg::detail {
+/**
+ * Precomputed per-element masks of the bits covered by a set of fields.
+ *
+ * When every field is of integral or enumeration type, two messages are
+ * equivalent exactly when their masked storage is equal, so equivalence and
+ * hashing can work a storage element at a time instead of extracting each
+ * field.
+ */
+template <typename... Fields> struct field_mask_t {
+    constexpr static auto bitwise_comparable =
+        (... and (std::integral<typename Fields::value_type> or
+                  std::is_enum_v<typename Fields::value_type>));
+
+    template <typename T> CONSTEVAL static auto make_mask() {
+        constexpr auto elem_size = stdx::bit_size<T>();
+        constexpr auto size =
+            std::max({std::size_t{}, Fields::template extent_in<T>()...});
+
+        auto mask = std::array<T, size>{};
+        auto const add = [&]<typename F>() {
+            for (auto a : F::locations) {
+                for (auto b = a.index() * 32u + a.lsb(); b <= a.msb(); ++b) {
+                    auto &m = mask[b / elem_size];
+                    m = static_cast<T>(m | (T{1} << (b % elem_size)));
+                }
+            }
+        };
+        (add.template operator()<Fields>(), ...);
+        return mask;
+    }
+
+    template <typename T>
+    constexpr static auto mask = make_mask<std::remove_cv_t<T>>();
+
+    // the indices of the storage elements that hold any field bits
+    template <typename T> CONSTEVAL static auto make_live_elements() {
+        constexpr auto &m = mask<T>;
+        constexpr auto num_live = static_cast<std::size_t>(
+            std::count_if(std::cbegin(m), std::cend(m),
+                          [](auto x) { return x != 0; }));
+        auto live = std::array<std::size_t, num_live>{};
+        auto it = std::begin(live);
+        for (auto i = std::size_t{}; i < m.size(); ++i) {
+            if (m[i] != 0) {
+                *it++ = i;
+            }
+        }
+        return live;
+    }
+
+    template <typename T>
+    constexpr static auto live_elements =
+        make_live_elements<std::remove_cv_t<T>>();
+
+    // No early exit: the loop is a straight reduction that compilers vectorize
+    // for large messages.
+    template <typename L, typename R>
+    [[nodiscard]] constexpr static auto equal(L const &lhs, R const &rhs)
+        -> bool {
+        using T = std::remove_cv_t<typename L::value_type>;
+        static_assert(std::is_same_v<T, std::remove_cv_t<typename R::value_type>>,
+                      "Messages compared bitwise must use the same storage "
+                      "element type");
+        constexpr auto &m = mask<T>;
+        auto diff = T{};
+        for (auto i = std::size_t{}; i < m.size(); ++i) {
+            diff = static_cast<T>(diff | ((lhs[i] ^ rhs[i]) & m[i]));
+        }
+        return diff == 0;
+    }
+
+    template <typename R>
+    [[nodiscard]] constexpr static auto hash(R const &r) -> std::uint64_t {
+        using T = std::remove_cv_t<typename R::value_type>;
+        constexpr auto &m = mask<T>;
+        constexpr auto &live = live_elements<T>;
+
+        auto h = std::uint64_t{0xcbf2'9ce4'8422'2325ull};
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            ((h = (h ^ static_cast<std::uint64_t>(r[live[Is]] & m[live[Is]])) *
+                  0x100'0000'01b3ull),
+             ...);
+        }(std::make_index_sequence<live.size()>{});
+
+        // fmix64 finalizer so that the low bits are usable as a table index
+        h ^= h >> 33u;
+        h *= 0xff51'afd7'ed55'8ccdull;
+        h ^= h >> 33u;
+        h *= 0xc4ce'b9fe'1a85'ec53ull;
+        h ^= h >> 33u;
+        return h;
+    }
+};
+} // namespace msg::detail
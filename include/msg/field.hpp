@@ -14,6 +14,7 @@
 #include <stdx/type_traits.hpp>
 
 #include <algorithm>
+#include <array>
 #include <climits>
 #include <concepts>
 #include <cstdint>
@@ -424,6 +425,8 @@ class field_t : public field_spec_t<Name, T, detail::field_size<Ats...>>,
     using value_type = T;
     using matcher_t = M;
 
+    constexpr static auto locations = std::array<at, sizeof...(Ats)>{Ats...};
+
     template <stdx::range R>
     [[nodiscard]] constexpr static auto extract(R &&r) -> value_type {
         return locator_t::template extract<spec_t>(std::forward<R>(r));
@@ -2,6 +2,7 @@
 
 #include <log/log.hpp>
 #include <msg/handler_interface.hpp>
+#include <msg/mismatch_policy.hpp>
 
 #include <stdx/tuple_algorithms.hpp>
 #include <stdx/utility.hpp>
@@ -28,14 +29,26 @@ struct handler : handler_interface<MsgBase, ExtraCallbackArgs...> {
             },
             callbacks);
         if (!found_valid_callback) {
-            CIB_ERROR(
-                "None of the registered callbacks ({}) claimed this message:",
-                stdx::ct<stdx::tuple_size_v<Callbacks>>());
-            stdx::for_each([&](auto &callback) { callback.log_mismatch(msg); },
-                           callbacks);
+            on_mismatch(msg);
         }
         return found_valid_callback;
     }
+
+    // Describe why each callback did not match. The mismatch policy decides
+    // whether this happens at once or later.
+    auto log_mismatch(auto const &msg) const -> void {
+        CIB_ERROR("None of the registered callbacks ({}) claimed this message:",
+                  stdx::ct<stdx::tuple_size_v<Callbacks>>());
+        stdx::for_each([&](auto &callback) { callback.log_mismatch(msg); },
+                       callbacks);
+    }
+
+  private:
+    template <typename... Ts>
+        requires(sizeof...(Ts) == 0)
+    auto on_mismatch(MsgBase const &msg) const -> void {
+        mismatch_policy<Ts...>.on_mismatch(*this, msg);
+    }
 };
 
 } // namespace msg
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <msg/field.hpp>
+#include <msg/message.hpp>
+
+#include <stdx/compiler.hpp>
+#include <stdx/ct_string.hpp>
+#include <stdx/env.hpp>
+#include <stdx/type_traits.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace msg {
+struct field_layout {
+    std::string_view name{};
+    // the number of bits the field occupies in the message
+    std::size_t bits{};
+    // the number of separate locations the field is split across
+    std::size_t pieces{};
+    // the number of 32-bit words read to extract the field: each word beyond
+    // the first costs a shift and an or
+    std::size_t words_read{};
+    // whether the field reads more words than its size requires
+    bool straddles{};
+};
+
+template <std::size_t N> struct message_layout {
+    std::size_t storage_bits{};
+    std::size_t used_bits{};
+    std::size_t padding_bits{};
+    std::size_t num_straddles{};
+    std::size_t extraction_cost{};
+    std::array<field_layout, N> fields{};
+};
+
+namespace detail {
+constexpr auto abs_lsb(at a) -> std::uint32_t {
+    return a.index() * 32u + a.lsb();
+}
+
+template <typename F> CONSTEVAL auto layout_of_field() -> field_layout {
+    auto l = field_layout{std::string_view{F::name_t::value}};
+    for (auto a : F::locations) {
+        auto const words = a.msb() / 32u - a.index() + 1u;
+        auto const min_words = (a.size() + 31u) / 32u;
+        l.bits += a.size();
+        ++l.pieces;
+        l.words_read += words;
+        l.straddles = l.straddles or words > min_words;
+    }
+    return l;
+}
+
+template <typename... Fields>
+CONSTEVAL auto analyze_layout(stdx::type_list<Fields...>) {
+    constexpr auto storage_bits =
+        storage_size<Fields...>::template in<std::uint32_t> * 32u;
+
+    auto used = std::array<bool, storage_bits>{};
+    auto const mark = [&]<typename F>() {
+        for (auto a : F::locations) {
+            for (auto b = abs_lsb(a); b <= a.msb(); ++b) {
+                used[b] = true;
+            }
+        }
+    };
+    (mark.template operator()<Fields>(), ...);
+
+    auto layout = message_layout<sizeof...(Fields)>{
+        storage_bits, 0, 0, 0, 0, {layout_of_field<Fields>()...}};
+    layout.used_bits = static_cast<std::size_t>(
+        std::count(std::cbegin(used), std::cend(used), true));
+    layout.padding_bits = storage_bits - layout.used_bits;
+    for (auto const &f : layout.fields) {
+        layout.num_straddles += f.straddles ? 1u : 0u;
+        layout.extraction_cost += f.words_read;
+    }
+    return layout;
+}
+
+// enough bits for the located fields, plus a word-aligned slot for every
+// unlocated field
+template <typename... Fields> CONSTEVAL auto auto_layout_capacity() {
+    auto located_bits = std::uint32_t{};
+    auto unlocated_bits = std::uint32_t{};
+    auto const add = [&]<typename F>() {
+        if constexpr (F::locations.empty()) {
+            unlocated_bits += (static_cast<std::uint32_t>(F::bitsize) + 31u) /
+                              32u * 32u;
+        } else {
+            for (auto a : F::locations) {
+                located_bits = std::max(located_bits, a.msb() + 1u);
+            }
+        }
+    };
+    (add.template operator()<Fields>(), ...);
+    return (located_bits + 31u) / 32u * 32u + unlocated_bits;
+}
+
+template <typename... Fields> CONSTEVAL auto auto_lsbs() {
+    constexpr auto num_fields = sizeof...(Fields);
+    constexpr auto capacity = auto_layout_capacity<Fields...>();
+    auto const sizes = std::array<std::uint32_t, num_fields>{
+        static_cast<std::uint32_t>(Fields::bitsize)...};
+    auto const is_located =
+        std::array<bool, num_fields>{not Fields::locations.empty()...};
+
+    auto used = std::array<bool, capacity>{};
+    auto const mark = [&]<typename F>() {
+        for (auto a : F::locations) {
+            for (auto b = abs_lsb(a); b <= a.msb(); ++b) {
+                used[b] = true;
+            }
+        }
+    };
+    (mark.template operator()<Fields>(), ...);
+
+    // largest fields first; ties keep declaration order
+    auto order = std::array<std::size_t, num_fields>{};
+    for (auto i = std::size_t{}; i < num_fields; ++i) {
+        order[i] = i;
+    }
+    std::sort(std::begin(order), std::end(order), [&](auto x, auto y) {
+        return sizes[x] > sizes[y] or (sizes[x] == sizes[y] and x < y);
+    });
+
+    auto const fits_at = [&](std::uint32_t pos, std::uint32_t size) {
+        auto const aligned = size > 32u ? pos % 32u == 0
+                                        : pos / 32u == (pos + size - 1u) / 32u;
+        return aligned and std::none_of(std::cbegin(used) + pos,
+                                        std::cbegin(used) + pos + size,
+                                        [](auto b) { return b; });
+    };
+
+    auto lsbs = std::array<std::uint32_t, num_fields>{};
+    for (auto i : order) {
+        if (is_located[i]) {
+            continue;
+        }
+        auto pos = std::uint32_t{};
+        while (not fits_at(pos, sizes[i])) {
+            ++pos;
+        }
+        std::fill_n(std::begin(used) + pos, sizes[i], true);
+        lsbs[i] = pos;
+    }
+    return lsbs;
+}
+
+template <typename F, std::uint32_t Lsb> CONSTEVAL auto auto_locate() {
+    if constexpr (F::locations.empty()) {
+        return std::type_identity<typename F::template located<at{
+            msb_t{Lsb + static_cast<std::uint32_t>(F::bitsize) - 1u},
+            lsb_t{Lsb}}>>{};
+    } else {
+        return std::type_identity<F>{};
+    }
+}
+
+template <typename F, std::uint32_t Lsb>
+using auto_located_t = typename decltype(auto_locate<F, Lsb>())::type;
+
+template <stdx::ct_string Name, typename Env, typename Is, typename... Fields>
+struct auto_layout_impl;
+
+template <stdx::ct_string Name, typename Env, std::size_t... Is,
+          typename... Fields>
+struct auto_layout_impl<Name, Env, std::index_sequence<Is...>, Fields...> {
+    constexpr static auto lsbs = auto_lsbs<Fields...>();
+    using type = msg::message<Name, Env, auto_located_t<Fields, lsbs[Is]>...>;
+};
+
+template <stdx::ct_string Name, typename... Fields>
+struct auto_layout_q
+    : auto_layout_impl<Name, stdx::env<>,
+                       std::make_index_sequence<sizeof...(Fields)>, Fields...> {
+};
+
+template <stdx::ct_string Name, stdx::envlike Env, typename... Fields>
+struct auto_layout_q<Name, Env, Fields...>
+    : auto_layout_impl<Name, Env, std::make_index_sequence<sizeof...(Fields)>,
+                       Fields...> {};
+} // namespace detail
+
+/**
+ * Report how a message definition uses its storage.
+ *
+ * Storage is measured in 32-bit words. The report gives the padding (bits not
+ * covered by any field), and for each field (in definition order) the words it
+ * reads when extracted and whether it straddles a word boundary.
+ *
+ * static_assert(msg::analyze_layout<my_msg_defn>().num_straddles == 0);
+ */
+template <typename Msg> CONSTEVAL auto analyze_layout() {
+    return detail::analyze_layout(typename Msg::fields_t{});
+}
+
+/**
+ * A message whose unlocated fields are placed automatically.
+ *
+ * This is for internal messages whose wire format doesn't matter. Located
+ * fields keep their locations. The remaining fields are placed largest first,
+ * each at the lowest free position where it doesn't straddle a 32-bit word
+ * (fields larger than a word start on a word boundary), so gaps left by
+ * located fields are filled and extraction stays on the single-word path.
+ */
+template <stdx::ct_string Name, typename... Ts>
+using auto_layout = typename detail::auto_layout_q<Name, Ts...>::type;
+} // namespace msg
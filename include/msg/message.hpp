@@ -2,6 +2,7 @@
 
 #include <match/ops.hpp>
 #include <match/sum_of_products.hpp>
+#include <msg/detail/field_mask.hpp>
 #include <msg/field.hpp>
 #include <msg/field_matchers.hpp>
 
@@ -373,6 +374,8 @@ struct message {
     using shifted_by =
         message<Name, Env, typename Fields::template shifted_by<N, Unit>...>;
 
+    using field_mask_t = detail::field_mask_t<Fields...>;
+
     template <typename S>
     constexpr static auto fits_inside =
         (... and Fields::template fits_inside<S>());
@@ -445,7 +448,11 @@ struct message {
 
         friend constexpr auto equiv(view_t lhs, view_t<const_span_t> rhs)
             -> bool {
-            return (... and (lhs.get(Fields{}) == rhs.get(Fields{})));
+            if constexpr (field_mask_t::bitwise_comparable) {
+                return field_mask_t::equal(lhs.data(), rhs.data());
+            } else {
+                return (... and (lhs.get(Fields{}) == rhs.get(Fields{})));
+            }
         }
 
         friend constexpr auto equiv(view_t lhs, view_t<mutable_span_t> rhs)
@@ -510,10 +517,12 @@ struct message {
             : owner_t{s.data(), vs...} {}
 
         [[nodiscard]] constexpr auto data() LIFETIMEBOUND {
-            return stdx::span{storage};
+            return mutable_span_t{std::data(storage),
+                                  stdx::ct_capacity_v<Storage>};
         }
         [[nodiscard]] constexpr auto data() const LIFETIMEBOUND {
-            return stdx::span{storage};
+            return const_span_t{std::data(storage),
+                                stdx::ct_capacity_v<Storage>};
         }
 
         [[nodiscard]] constexpr auto as_mutable_view() LIFETIMEBOUND {
@@ -547,7 +556,11 @@ struct message {
 
         friend constexpr auto equiv(owner_t const &lhs,
                                     view_t<const_span_t> rhs) -> bool {
-            return (... and (lhs.get(Fields{}) == rhs.get(Fields{})));
+            if constexpr (field_mask_t::bitwise_comparable) {
+                return field_mask_t::equal(lhs.data(), rhs.data());
+            } else {
+                return (... and (lhs.get(Fields{}) == rhs.get(Fields{})));
+            }
         }
 
         friend constexpr auto equiv(owner_t const &lhs,
@@ -651,6 +664,16 @@ constexpr auto equivalent(O1 const &lhs, O2 const &rhs) {
     return equiv(lhs, rhs.as_const_view());
 }
 
+// A hash of the field bits of a message: equivalent messages hash equally.
+template <messagelike M> constexpr auto hash(M const &m) -> std::uint64_t {
+    using field_mask_t =
+        typename std::remove_cvref_t<M>::definition_t::field_mask_t;
+    static_assert(field_mask_t::bitwise_comparable,
+                  "msg::hash requires all fields to be of integral or "
+                  "enumeration type");
+    return field_mask_t::hash(m.data());
+}
+
 template <typename Msg, typename F, typename S, typename... Args>
 __attribute__((flatten, always_inline)) constexpr auto
 call_with_message(F &&f, S &&s, Args &&...args) -> decltype(auto) {
@@ -0,0 +1,416 @@
+#pragma once
+
+#include <cib/detail/nexus_details.hpp>
+#include <msg/message.hpp>
+
+#include <stdx/compiler.hpp>
+#include <stdx/ct_string.hpp>
+#include <stdx/iterator.hpp>
+#include <stdx/panic.hpp>
+#include <stdx/span.hpp>
+#include <stdx/type_traits.hpp>
+
+#include <boost/mp11/algorithm.hpp>
+#include <boost/mp11/list.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace msg {
+namespace detail {
+template <typename T, std::size_t MaxSize, typename... Msgs>
+CONSTEVAL auto pool_size_classes() {
+    // the size of each definition, then doublings of the largest up to
+    // MaxSize, for messages whose payload length is only known at runtime
+    constexpr auto classes = [] {
+        auto s = std::array<std::size_t, sizeof...(Msgs) + 64>{};
+        auto n = std::size_t{};
+        for (auto sz : std::array{Msgs::template size<T>::value...}) {
+            s[n++] = sz;
+        }
+        auto const first = std::begin(s);
+        auto const last = std::next(first, static_cast<std::ptrdiff_t>(n));
+        std::sort(first, last);
+        n = static_cast<std::size_t>(std::unique(first, last) - first);
+        for (auto c = s[n - 1]; c < MaxSize;) {
+            c = std::min(std::max(2 * c, std::size_t{1}), MaxSize);
+            s[n++] = c;
+        }
+        return std::pair{s, n};
+    }();
+
+    std::array<std::size_t, classes.second> r{};
+    std::copy_n(std::begin(classes.first), classes.second, std::begin(r));
+    return r;
+}
+
+/**
+ * A fixed number of fixed-size blocks with a lock-free free list.
+ *
+ * Blocks are handed out in order until the slab is exhausted; released
+ * blocks are kept on a Treiber stack whose head carries a generation count to
+ * avoid ABA. The zero-initialized state is valid, so a slab with static
+ * storage duration needs no runtime initialization.
+ */
+template <typename T, std::size_t BlockSize, std::size_t NumBlocks>
+struct slab {
+    static_assert(NumBlocks < std::numeric_limits<std::uint32_t>::max(),
+                  "Too many blocks in a message pool slab");
+
+    using block_t = std::array<T, BlockSize>;
+
+    [[nodiscard]] auto allocate() -> T * {
+        auto head = free_head.load(std::memory_order_acquire);
+        while (index_of(head) != 0) {
+            auto const idx = index_of(head) - 1;
+            auto const next = next_free[idx].load(std::memory_order_relaxed);
+            auto const new_head = make_head(generation_of(head) + 1, next);
+            if (free_head.compare_exchange_weak(head, new_head,
+                                                std::memory_order_acquire)) {
+                return blocks[idx].data();
+            }
+        }
+
+        auto const idx = watermark.fetch_add(1, std::memory_order_relaxed);
+        if (idx < NumBlocks) {
+            return blocks[idx].data();
+        }
+        watermark.fetch_sub(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    auto release(T *p) -> void {
+        auto const offset = p - blocks.front().data();
+        auto const idx = static_cast<std::uint32_t>(
+            offset / static_cast<std::ptrdiff_t>(BlockSize));
+        auto head = free_head.load(std::memory_order_relaxed);
+        do {
+            next_free[idx].store(index_of(head), std::memory_order_relaxed);
+        } while (not free_head.compare_exchange_weak(
+            head, make_head(generation_of(head) + 1, idx + 1),
+            std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    [[nodiscard]] auto owns(T const *p) const -> bool {
+        return std::less_equal{}(blocks.front().data(), p) and
+               std::less{}(p, blocks.back().data() + BlockSize);
+    }
+
+  private:
+    // free list indices are 1-based so that 0 means "empty"
+    [[nodiscard]] constexpr static auto index_of(std::uint64_t head)
+        -> std::uint32_t {
+        return static_cast<std::uint32_t>(head);
+    }
+    [[nodiscard]] constexpr static auto generation_of(std::uint64_t head)
+        -> std::uint32_t {
+        return static_cast<std::uint32_t>(head >> 32u);
+    }
+    [[nodiscard]] constexpr static auto make_head(std::uint32_t gen,
+                                                  std::uint32_t idx)
+        -> std::uint64_t {
+        return (std::uint64_t{gen} << 32u) | idx;
+    }
+
+    std::atomic<std::uint64_t> free_head{};
+    std::atomic<std::uint32_t> watermark{};
+    std::array<std::atomic<std::uint32_t>, NumBlocks> next_free{};
+    std::array<block_t, NumBlocks> blocks{};
+};
+
+template <typename Callback> using callback_msg_t = typename Callback::msg_t;
+
+template <typename Config, typename Service>
+using service_msgs_t = boost::mp11::mp_transform<
+    callback_msg_t,
+    boost::mp11::mp_rename<std::remove_cvref_t<decltype(cib::initialized<
+                               Config, Service>::value.callbacks)>,
+                           stdx::type_list>>;
+} // namespace detail
+
+/**
+ * The message definitions of the callbacks that extend Services in the cib
+ * configuration Config, for a message_pool.
+ */
+template <typename Config, typename... Services>
+using nexus_messages_t =
+    boost::mp11::mp_append<stdx::type_list<>,
+                           detail::service_msgs_t<Config, Services>...>;
+
+template <stdx::ct_string Name, typename T, std::size_t BlocksPerClass,
+          typename Msgs, std::size_t MaxSize = 0>
+struct message_pool;
+
+/**
+ * A static pool of message storage.
+ *
+ * The size classes are the storage sizes (in units of T) of the given message
+ * definitions -- for instance, those registered in a nexus (see
+ * nexus_messages_t). Messages with a runtime payload may be up to MaxSize:
+ * above the largest definition, the classes double up to it. Each size class
+ * has its own slab of BlocksPerClass blocks, and a message takes a block of
+ * the smallest class that holds it, so that it never takes more than twice
+ * its length.
+ */
+template <stdx::ct_string Name, typename T, std::size_t BlocksPerClass,
+          typename... Msgs, std::size_t MaxSize>
+struct message_pool<Name, T, BlocksPerClass, stdx::type_list<Msgs...>,
+                    MaxSize> {
+    static_assert(sizeof...(Msgs) > 0,
+                  "A message pool needs at least one message definition");
+
+    using value_type = T;
+    constexpr static auto name = Name;
+    constexpr static auto size_classes =
+        detail::pool_size_classes<T, MaxSize, Msgs...>();
+    constexpr static auto max_size = size_classes.back();
+
+    // the index of the smallest size class that holds n elements, or
+    // size_classes.size() if none does
+    [[nodiscard]] constexpr static auto class_index(std::size_t n)
+        -> std::size_t {
+        return static_cast<std::size_t>(
+            std::find_if(std::begin(size_classes), std::end(size_classes),
+                         [&](auto sz) { return sz >= n; }) -
+            std::begin(size_classes));
+    }
+
+    template <std::size_t I>
+    using slab_t = detail::slab<T, size_classes[I], BlocksPerClass>;
+
+    template <std::size_t I> CONSTINIT static inline slab_t<I> slab_at{};
+
+    // a block of the smallest size class that holds n elements, or nullptr if
+    // there is none or it is exhausted
+    [[nodiscard]] static auto allocate(std::size_t n) -> T * {
+        T *p{};
+        with_slab(class_index(n), [&](auto &s) { p = s.allocate(); });
+        return p;
+    }
+
+    // n is the size the block was allocated for
+    static auto release(T *p, std::size_t n) -> void {
+        with_slab(class_index(n), [&](auto &s) { s.release(p); });
+    }
+
+  private:
+    template <typename F> static auto with_slab(std::size_t i, F &&f) -> void {
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            static_cast<void>(((i == Is and (f(slab_at<Is>), true)) or ...));
+        }(std::make_index_sequence<size_classes.size()>{});
+    }
+};
+
+/**
+ * Owning message storage whose elements live in a message_pool.
+ *
+ * It has the compile-time capacity N of an equivalent std::array, so it can be
+ * used with owner_t; the object itself is just a pointer. Copying allocates a
+ * new block from the pool; moving transfers the block.
+ */
+template <typename Pool, std::size_t N> class pooled_storage {
+    using T = typename Pool::value_type;
+    static_assert(N <= Pool::max_size,
+                  "No size class in the message pool is large enough");
+
+    T *block;
+
+    // a block may have held another message: clear it, as a value-initialized
+    // std::array would be, so that no stale bytes go out in reserved bits
+    [[nodiscard]] static auto allocate() -> T * {
+        auto p = Pool::allocate(N);
+        if (p == nullptr) {
+            using namespace stdx::literals;
+            stdx::panic<"Message pool ("_cts + Pool::name +
+                        ") exhausted"_cts>();
+        }
+        std::fill_n(p, N, T{});
+        return p;
+    }
+
+    auto release() -> void {
+        if (block != nullptr) {
+            Pool::release(block, N);
+        }
+    }
+
+  public:
+    using value_type = T;
+
+    pooled_storage() : block{allocate()} {}
+
+    pooled_storage(pooled_storage const &rhs) : pooled_storage{} {
+        std::copy_n(rhs.begin(), N, begin());
+    }
+    pooled_storage(pooled_storage &&rhs) noexcept
+        : block{std::exchange(rhs.block, nullptr)} {}
+
+    auto operator=(pooled_storage const &rhs) -> pooled_storage & {
+        if (this != &rhs) {
+            if (block == nullptr) {
+                block = allocate();
+            }
+            std::copy_n(rhs.begin(), N, begin());
+        }
+        return *this;
+    }
+    auto operator=(pooled_storage &&rhs) noexcept -> pooled_storage & {
+        std::swap(block, rhs.block);
+        return *this;
+    }
+
+    ~pooled_storage() { release(); }
+
+    [[nodiscard]] constexpr static auto size() -> std::size_t { return N; }
+
+    [[nodiscard]] auto data() LIFETIMEBOUND -> T * { return block; }
+    [[nodiscard]] auto data() const LIFETIMEBOUND -> T const * {
+        return block;
+    }
+
+    [[nodiscard]] auto begin() LIFETIMEBOUND -> T * { return block; }
+    [[nodiscard]] auto begin() const LIFETIMEBOUND -> T const * {
+        return block;
+    }
+    [[nodiscard]] auto end() LIFETIMEBOUND -> T * { return block + N; }
+    [[nodiscard]] auto end() const LIFETIMEBOUND -> T const * {
+        return block + N;
+    }
+
+    [[nodiscard]] auto operator[](std::size_t i) LIFETIMEBOUND -> T & {
+        return block[i];
+    }
+    [[nodiscard]] auto operator[](std::size_t i) const LIFETIMEBOUND
+        -> T const & {
+        return block[i];
+    }
+};
+
+/**
+ * A message whose length is only known at runtime: the fields of Def, then a
+ * payload. It takes a block of the smallest size class that holds both, so a
+ * message with a payload length field (like a MIPI Sys-T long build message)
+ * takes the memory its payload needs rather than a worst-case array.
+ *
+ * Fields are accessed through view(), or get() and set(); data() spans the
+ * whole message. Copying allocates a new block; moving transfers the block.
+ */
+template <typename Pool, typename Def> class pooled_message {
+    using T = typename Pool::value_type;
+    constexpr static auto header_size = Def::template size<T>::value;
+    using header_t = typename Def::template owner_t<std::array<T, header_size>>;
+
+    T *block{};
+    std::size_t length{};
+
+    // a block may have held another message: clear it, so that no stale
+    // bytes go out in reserved bits or the payload
+    [[nodiscard]] static auto allocate(std::size_t n) -> T * {
+        using namespace stdx::literals;
+        if (n > Pool::max_size) {
+            stdx::panic<"Message too long for message pool ("_cts +
+                        Pool::name + ")"_cts>();
+            return nullptr;
+        }
+        auto p = Pool::allocate(n);
+        if (p == nullptr) {
+            stdx::panic<"Message pool ("_cts + Pool::name +
+                        ") exhausted"_cts>();
+            return nullptr;
+        }
+        std::fill_n(p, n, T{});
+        return p;
+    }
+
+    auto release() -> void {
+        if (block != nullptr) {
+            Pool::release(block, length);
+        }
+    }
+
+  public:
+    using definition_t = Def;
+    using value_type = T;
+    using view_t = typename Def::template view_t<stdx::span<T, header_size>>;
+    using const_view_t =
+        typename Def::template view_t<stdx::span<T const, header_size>>;
+
+    // payload_size is in units of T, and follows the fields
+    template <detail::some_field_value... Vs>
+    explicit pooled_message(std::size_t payload_size, Vs... vs)
+        : block{allocate(header_size + payload_size)} {
+        if (block != nullptr) {
+            length = header_size + payload_size;
+            auto const header = header_t{vs...};
+            std::copy_n(std::begin(header.data()), header_size, block);
+        }
+    }
+
+    pooled_message(pooled_message const &rhs)
+        : block{allocate(rhs.length)}, length{rhs.length} {
+        std::copy_n(rhs.block, length, block);
+    }
+    pooled_message(pooled_message &&rhs) noexcept
+        : block{std::exchange(rhs.block, nullptr)},
+          length{std::exchange(rhs.length, 0)} {}
+
+    auto operator=(pooled_message const &rhs) -> pooled_message & {
+        if (this != &rhs) {
+            auto copy = rhs;
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+    auto operator=(pooled_message &&rhs) noexcept -> pooled_message & {
+        std::swap(block, rhs.block);
+        std::swap(length, rhs.length);
+        return *this;
+    }
+
+    ~pooled_message() { release(); }
+
+    [[nodiscard]] auto view() LIFETIMEBOUND -> view_t {
+        return view_t{stdx::span<T, header_size>{block, header_size}};
+    }
+    [[nodiscard]] auto view() const LIFETIMEBOUND -> const_view_t {
+        return const_view_t{
+            stdx::span<T const, header_size>{block, header_size}};
+    }
+
+    [[nodiscard]] auto get(auto f) const { return view().get(f); }
+    auto set(auto... fs) -> void { view().set(fs...); }
+
+    [[nodiscard]] auto size() const -> std::size_t { return length; }
+
+    [[nodiscard]] auto data() LIFETIMEBOUND -> stdx::span<T> {
+        return stdx::span<T>{block, length};
+    }
+    [[nodiscard]] auto data() const LIFETIMEBOUND -> stdx::span<T const> {
+        return stdx::span<T const>{block, length};
+    }
+
+    [[nodiscard]] auto payload() LIFETIMEBOUND -> stdx::span<T> {
+        return stdx::span<T>{block + header_size, length - header_size};
+    }
+    [[nodiscard]] auto payload() const LIFETIMEBOUND -> stdx::span<T const> {
+        return stdx::span<T const>{block + header_size, length - header_size};
+    }
+};
+
+template <typename Pool, typename Def>
+using pooled_owning = typename Def::template owner_t<pooled_storage<
+    Pool, Def::template size<typename Pool::value_type>::value>>;
+} // namespace msg
+
+namespace stdx {
+template <typename Pool, std::size_t N>
+constexpr inline auto ct_capacity_v<msg::pooled_storage<Pool, N>> = N;
+} // namespace stdx
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <log/detail/mpsc_queue.hpp>
+#include <log/log.hpp>
+
+#include <stdx/iterator.hpp>
+#include <stdx/ranges.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
+namespace msg {
+namespace detail {
+template <typename Msg> constexpr auto raw_copy(Msg const &msg) {
+    if constexpr (stdx::range<Msg>) {
+        using T = std::remove_cv_t<typename Msg::value_type>;
+        std::array<T, stdx::ct_capacity_v<Msg>> raw{};
+        std::copy_n(std::begin(msg), raw.size(), std::begin(raw));
+        return raw;
+    } else {
+        return raw_copy(msg.data());
+    }
+}
+
+template <typename Msg>
+using raw_copy_t = decltype(raw_copy(std::declval<Msg const &>()));
+} // namespace detail
+
+// Log the mismatch on the handling thread, describing why each callback did
+// not match. This is the default.
+struct log_mismatch_immediately {
+    template <typename Handler, typename Msg>
+    auto on_mismatch(Handler const &h, Msg const &msg) -> void {
+        h.log_mismatch(msg);
+    }
+};
+
+/**
+ * Record mismatched messages and defer describing them.
+ *
+ * On the handling thread, a mismatch costs a copy of the raw message into a
+ * bounded lock-free queue. At most MaxPerDrain mismatches are recorded between
+ * calls to drain(); the rest are only counted. drain() (called from a
+ * background context, or on demand) logs each recorded message the same way
+ * log_mismatch_immediately would, and reports how many were dropped.
+ *
+ * @tparam Capacity    The number of mismatched messages that can be queued.
+ * @tparam MaxBytes    The maximum size of a recorded message.
+ * @tparam MaxPerDrain The number of messages recorded between drains.
+ */
+template <std::size_t Capacity, std::size_t MaxBytes = 64,
+          std::size_t MaxPerDrain = Capacity>
+class deferred_mismatch_log {
+    using describe_fn_t = auto (*)(void const *, std::byte const *) -> void;
+
+    struct entry {
+        describe_fn_t describe;
+        void const *handler;
+        std::uint32_t seq;
+        std::array<std::byte, MaxBytes> raw;
+    };
+
+    template <typename Handler, typename Raw>
+    static auto describe(void const *h, std::byte const *bytes) -> void {
+        Raw raw{};
+        std::memcpy(&raw, bytes, sizeof(Raw));
+        static_cast<Handler const *>(h)->log_mismatch(raw);
+    }
+
+    logging::detail::mpsc_queue<entry, Capacity> entries{};
+    std::atomic<std::size_t> recorded{};
+    std::atomic<std::size_t> dropped{};
+    std::atomic<std::uint32_t> seq{};
+
+  public:
+    template <typename Handler, typename Msg>
+    auto on_mismatch(Handler const &h, Msg const &msg) -> void {
+        using raw_t = detail::raw_copy_t<Msg>;
+        static_assert(std::is_trivially_copyable_v<raw_t>);
+        static_assert(sizeof(raw_t) <= MaxBytes,
+                      "Message is too large for deferred_mismatch_log");
+
+        auto const n = seq.fetch_add(1, std::memory_order_relaxed);
+        if (recorded.fetch_add(1, std::memory_order_relaxed) >= MaxPerDrain) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        entry e{&describe<Handler, raw_t>, &h, n, {}};
+        auto const raw = detail::raw_copy(msg);
+        std::memcpy(e.raw.data(), &raw, sizeof(raw_t));
+        if (not entries.try_push(e)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Must be called from one context at a time. Returns the number of
+    // recorded mismatches that were logged.
+    auto drain() -> std::size_t {
+        auto n = std::size_t{};
+        while (auto e = entries.try_pop()) {
+            CIB_INFO("Deferred mismatch report #{}:", e->seq);
+            e->describe(e->handler, e->raw.data());
+            ++n;
+        }
+        recorded.store(0, std::memory_order_relaxed);
+
+        auto const d = dropped.exchange(0, std::memory_order_relaxed);
+        if (d != 0) {
+            CIB_WARN("{} mismatched messages were not recorded", d);
+        }
+        return n;
+    }
+
+    [[nodiscard]] auto pending() const -> std::size_t {
+        return entries.size();
+    }
+    [[nodiscard]] auto num_dropped() const -> std::size_t {
+        return dropped.load(std::memory_order_relaxed);
+    }
+};
+
+// Inject a different policy by specializing this variable template, in the
+// same way as logging::config:
+//
+// template <> inline auto msg::mismatch_policy<> =
+//     msg::deferred_mismatch_log<32>{};
+template <typename...> inline auto mismatch_policy = log_mismatch_immediately{};
+} // namespace msg
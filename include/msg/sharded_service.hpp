@@ -0,0 +1,210 @@
+#pragma once
+
+#include <log/detail/mpsc_queue.hpp>
+#include <msg/handler.hpp>
+#include <msg/handler_interface.hpp>
+#include <msg/message.hpp>
+#include <msg/mismatch_policy.hpp>
+
+#include <stdx/compiler.hpp>
+#include <stdx/panic.hpp>
+#include <stdx/ranges.hpp>
+#include <stdx/tuple.hpp>
+#include <stdx/tuple_algorithms.hpp>
+#include <stdx/utility.hpp>
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace msg {
+struct fibonacci_shard_hash {
+    template <typename T>
+    [[nodiscard]] constexpr auto operator()(T const &key) const
+        -> std::uint32_t {
+        auto const k = static_cast<std::uint64_t>(stdx::to_underlying(key));
+        return static_cast<std::uint32_t>((k * 0x9e37'79b9'7f4a'7c15ull) >>
+                                          32u);
+    }
+};
+
+/**
+ * Describes how a sharded service partitions messages.
+ *
+ * @tparam Field     The field whose value selects the shard. All messages with
+ *                   the same value for this field go to the same shard, so
+ *                   their relative order is preserved.
+ * @tparam NumShards The number of shards (usually the number of workers).
+ * @tparam QueueCapacity The capacity of each shard's queue (a power of two).
+ * @tparam Hash      The hash applied to the field value.
+ */
+template <typename Field, std::size_t NumShards,
+          std::size_t QueueCapacity = 256,
+          typename Hash = fibonacci_shard_hash>
+struct shard_spec {
+    static_assert(NumShards > 0, "A sharded service needs at least one shard");
+
+    constexpr static auto num_shards = NumShards;
+    constexpr static auto queue_capacity = QueueCapacity;
+
+    template <typename Msg>
+    [[nodiscard]] constexpr static auto shard_for(Msg const &msg)
+        -> std::size_t {
+        auto const key = [&] {
+            if constexpr (stdx::range<Msg>) {
+                return Field::extract(msg);
+            } else {
+                return Field::extract(std::data(msg));
+            }
+        }();
+        return Hash{}(key) % NumShards;
+    }
+};
+
+template <typename MsgBase, typename... ExtraCallbackArgs>
+struct sharded_handler_interface
+    : handler_interface<MsgBase, ExtraCallbackArgs...> {
+    // Handle the messages queued for a shard, returning how many were
+    // processed. Each shard must only be processed by one thread at a time.
+    virtual auto process(std::size_t shard) const -> std::size_t = 0;
+
+    [[nodiscard]] virtual auto num_shards() const -> std::size_t = 0;
+
+    // The number of matching messages dropped because their shard's queue
+    // was full.
+    [[nodiscard]] virtual auto dropped() const -> std::size_t = 0;
+};
+
+template <typename Id, typename ShardSpec, typename Callbacks,
+          typename MsgBase, typename... ExtraCallbackArgs>
+struct sharded_handler
+    : sharded_handler_interface<MsgBase, ExtraCallbackArgs...> {
+    static_assert(not viewlike<MsgBase>,
+                  "Messages are queued by a sharded service: the message base "
+                  "type must own its storage");
+
+    using handler_t = handler<Callbacks, MsgBase, ExtraCallbackArgs...>;
+    using entry_t =
+        stdx::tuple<MsgBase, std::remove_cvref_t<ExtraCallbackArgs>...>;
+    using queue_t =
+        logging::detail::mpsc_queue<entry_t, ShardSpec::queue_capacity>;
+
+    handler_t shard_handler;
+
+    constexpr explicit sharded_handler(Callbacks new_callbacks)
+        : shard_handler{new_callbacks} {}
+
+    auto is_match(MsgBase const &msg) const -> bool final {
+        return shard_handler.is_match(msg);
+    }
+
+    // Queue the message on its shard if any callback matches it. Returns
+    // whether one did; a matching message that does not fit in its shard's
+    // queue is dropped and counted.
+    auto handle(MsgBase const &msg, ExtraCallbackArgs... args) const
+        -> bool final {
+        if (not shard_handler.is_match(msg)) {
+            on_mismatch(msg);
+            return false;
+        }
+        auto &q = queues[ShardSpec::shard_for(msg)];
+        if (not q.try_push(entry_t{msg, args...})) {
+            dropped_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    auto process(std::size_t shard) const -> std::size_t final {
+        auto &q = queues[shard];
+        auto n = std::size_t{};
+        while (auto entry = q.try_pop()) {
+            entry->apply([&](auto const &msg, auto const &...args) {
+                shard_handler.handle(msg, args...);
+            });
+            ++n;
+        }
+        return n;
+    }
+
+    [[nodiscard]] auto num_shards() const -> std::size_t final {
+        return ShardSpec::num_shards;
+    }
+
+    [[nodiscard]] auto dropped() const -> std::size_t final {
+        return dropped_count.load(std::memory_order_relaxed);
+    }
+
+  private:
+    // queue state is per service: Id is unique to the service being built
+    CONSTINIT static inline std::array<queue_t, ShardSpec::num_shards>
+        queues{};
+    CONSTINIT static inline std::atomic<std::size_t> dropped_count{};
+
+    template <typename... Ts>
+        requires(sizeof...(Ts) == 0)
+    auto on_mismatch(MsgBase const &msg) const -> void {
+        mismatch_policy<Ts...>.on_mismatch(shard_handler, msg);
+    }
+};
+
+template <typename ShardSpec, typename Callbacks, typename MsgBase,
+          typename... ExtraCallbackArgs>
+struct sharded_builder {
+    Callbacks callbacks;
+
+    template <typename... Ts> [[nodiscard]] constexpr auto add(Ts... ts) {
+        auto new_callbacks =
+            stdx::tuple_cat(callbacks, stdx::make_tuple(ts...));
+        using new_callbacks_t = decltype(new_callbacks);
+        return sharded_builder<ShardSpec, new_callbacks_t, MsgBase,
+                               ExtraCallbackArgs...>{new_callbacks};
+    }
+
+    template <typename BuilderValue> constexpr static auto build() {
+        return sharded_handler<BuilderValue, ShardSpec, Callbacks, MsgBase,
+                               ExtraCallbackArgs...>{
+            BuilderValue::value.callbacks};
+    }
+};
+
+template <typename MsgBase, typename... ExtraCallbackArgs>
+struct uninitialized_sharded_handler_t
+    : sharded_handler_interface<MsgBase, ExtraCallbackArgs...> {
+    auto is_match(MsgBase const &) const -> bool override { return false; }
+
+    auto handle(MsgBase const &, ExtraCallbackArgs...) const -> bool override {
+        using namespace stdx::literals;
+        stdx::panic<"Attempting to handle msg ("_cts +
+                    detail::name_for_msg<MsgBase>() +
+                    ") before service is initialized"_cts>();
+        return false;
+    }
+
+    auto process(std::size_t) const -> std::size_t override { return 0; }
+
+    [[nodiscard]] auto num_shards() const -> std::size_t override {
+        return 0;
+    }
+
+    [[nodiscard]] auto dropped() const -> std::size_t override { return 0; }
+};
+
+template <typename ShardSpec, typename MsgBase, typename... ExtraCallbackArgs>
+struct sharded_service {
+    using builder_t = sharded_builder<ShardSpec, stdx::tuple<>, MsgBase,
+                                      ExtraCallbackArgs...>;
+    using interface_t =
+        sharded_handler_interface<MsgBase, ExtraCallbackArgs...> const *;
+
+    constexpr static auto uninitialized_v =
+        uninitialized_sharded_handler_t<MsgBase, ExtraCallbackArgs...>{};
+    CONSTEVAL static auto uninitialized() -> interface_t {
+        return &uninitialized_v;
+    }
+};
+} // namespace msg
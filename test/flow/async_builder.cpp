@@ -0,0 +1,125 @@
+#include <flow/async_builder.hpp>
+#include <flow/flow.hpp>
+
+#include <async/just.hpp>
+#include <async/just_result_of.hpp>
+#include <async/schedulers/trigger_manager.hpp>
+#include <async/schedulers/trigger_scheduler.hpp>
+#include <async/start_detached.hpp>
+#include <async/sync_wait.hpp>
+#include <async/then.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <utility>
+
+namespace {
+auto actual = std::string{};
+
+constexpr auto milestone0 = flow::milestone<"milestone0">();
+
+constexpr auto a = flow::action<"a">([] { actual += "a"; });
+constexpr auto b = flow::action<"b">(
+    [] { return async::just_result_of([] { actual += "b"; }); });
+constexpr auto c = flow::action<"c">(
+    [] { return async::just_result_of([] { actual += "c"; }); });
+constexpr auto d = flow::action<"d">([] { actual += "d"; });
+
+// a step whose sender completes with a value, which the flow drops
+constexpr auto e = flow::action<"e">([] {
+    return async::just_result_of([] {
+        actual += "e";
+        return 42;
+    });
+});
+
+// a step whose sender completes only when the test runs its trigger
+constexpr auto waiting_b = flow::action<"waiting_b">([] {
+    actual += "b";
+    return async::trigger_scheduler<"async_builder_b">{}.schedule() |
+           async::then([] { actual += "B"; });
+});
+
+using builder = flow::async_graph_builder<"test_flow", flow::impl>;
+} // namespace
+
+template <auto... Vs> struct wrapper_t {
+    constexpr static auto value = flow::graph<>{}.add(Vs...);
+};
+
+template <auto... Vs> auto run_flow() -> std::string {
+    actual.clear();
+    builder::render<wrapper_t<Vs...>>()();
+    return actual;
+}
+
+#if defined(__GNUC__) && __GNUC__ == 12
+#else
+
+TEST_CASE("build and run empty async flow", "[async_builder]") {
+    STATIC_REQUIRE(not decltype(builder::render<wrapper_t<>>())::active);
+    CHECK(run_flow<>().empty());
+}
+
+TEST_CASE("async flow runs a void step", "[async_builder]") {
+    CHECK(run_flow<*a>() == "a");
+}
+
+TEST_CASE("async flow runs a sender step", "[async_builder]") {
+    CHECK(run_flow<*b>() == "b");
+}
+
+TEST_CASE("async flow drops the values of a step", "[async_builder]") {
+    CHECK(run_flow<*e>() == "e");
+}
+
+TEST_CASE("async flow runs steps in order", "[async_builder]") {
+    CHECK(run_flow<(*a >> *b >> *c >> *d)>() == "abcd");
+    CHECK(run_flow<(*d >> *c), (*b >> *a >> d)>() == "badc");
+}
+
+TEST_CASE("async flow runs each step once", "[async_builder]") {
+    CHECK(run_flow<(*a >> *milestone0), (a >> *b), (milestone0 >> b)>() ==
+          "ab");
+}
+
+TEST_CASE("async flow runs parallel steps", "[async_builder]") {
+    auto const result = run_flow<(*a >> (*b && *c) >> *d)>();
+
+    REQUIRE(result.size() == 4);
+    CHECK(result.find('a') < result.find('b'));
+    CHECK(result.find('a') < result.find('c'));
+    CHECK(result.find('b') < result.find('d'));
+    CHECK(result.find('c') < result.find('d'));
+}
+
+TEST_CASE("an async flow is a sender that runs when started",
+          "[async_builder]") {
+    actual.clear();
+    auto s = builder::render<wrapper_t<(*a >> *b)>>().sender();
+    CHECK(actual.empty());
+
+    static_cast<void>(async::sync_wait(std::move(s)));
+    CHECK(actual == "ab");
+}
+
+TEST_CASE("a waiting step does not hold up the steps beside it",
+          "[async_builder]") {
+    actual.clear();
+    auto done = false;
+    auto s = builder::render<wrapper_t<(*a >> (*waiting_b && *c) >> *d)>>()
+                 .sender() |
+             async::then([&] { done = true; });
+    static_cast<void>(async::start_detached(std::move(s)));
+
+    // b has started and is waiting; c has run meanwhile; d waits for both
+    CHECK(actual == "abc");
+    CHECK(not done);
+
+    async::run_triggers<"async_builder_b">();
+    CHECK(actual == "abcBd");
+    CHECK(done);
+}
+
+#endif
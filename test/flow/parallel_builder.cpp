@@ -0,0 +1,123 @@
+#include <flow/flow.hpp>
+#include <flow/parallel_builder.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <iterator>
+#include <mutex>
+#include <string>
+
+namespace {
+std::mutex actual_mutex{};
+auto actual = std::string{};
+
+auto record(char c) -> void {
+    auto const lock = std::lock_guard{actual_mutex};
+    actual += c;
+}
+
+constexpr auto milestone0 = flow::milestone<"milestone0">();
+
+constexpr auto a = flow::action<"a">([] { record('a'); });
+constexpr auto b = flow::action<"b">([] { record('b'); });
+constexpr auto c = flow::action<"c">([] { record('c'); });
+constexpr auto d = flow::action<"d">([] { record('d'); });
+
+using builder = flow::parallel_graph_builder<"test_flow", flow::impl, 2>;
+} // namespace
+
+template <auto... Vs> struct wrapper_t {
+    constexpr static auto value = flow::graph<>{}.add(Vs...);
+};
+
+template <auto... Vs> auto run_flow() -> std::string {
+    actual.clear();
+    builder::render<wrapper_t<Vs...>>()();
+    return actual;
+}
+
+#if defined(__GNUC__) && __GNUC__ == 12
+#else
+
+TEST_CASE("build and run empty parallel flow", "[parallel_builder]") {
+    STATIC_REQUIRE(not decltype(builder::render<wrapper_t<>>())::active);
+    CHECK(run_flow<>().empty());
+}
+
+TEST_CASE("parallel flow runs a single action", "[parallel_builder]") {
+    STATIC_REQUIRE(decltype(builder::render<wrapper_t<*a>>())::active);
+    CHECK(run_flow<*a>() == "a");
+}
+
+TEST_CASE("parallel flow runs a sequence in order", "[parallel_builder]") {
+    CHECK(run_flow<(*a >> *b >> *c)>() == "abc");
+}
+
+TEST_CASE("parallel flow runs each action once", "[parallel_builder]") {
+    auto const result =
+        run_flow<(*a >> *milestone0), (a >> *b), (milestone0 >> b)>();
+    CHECK(result == "ab");
+}
+
+TEST_CASE("parallel flow runs parallel actions", "[parallel_builder]") {
+    auto const result = run_flow<*a && *b && *c>();
+
+    CHECK(result.find('a') != std::string::npos);
+    CHECK(result.find('b') != std::string::npos);
+    CHECK(result.find('c') != std::string::npos);
+    CHECK(result.size() == 3);
+}
+
+TEST_CASE("parallel flow respects dependencies", "[parallel_builder]") {
+    for (auto i = 0; i < 100; ++i) {
+        auto const result = run_flow<(*a >> (*b && *c) >> *d)>();
+
+        REQUIRE(result.size() == 4);
+        CHECK(result.find('a') < result.find('b'));
+        CHECK(result.find('a') < result.find('c'));
+        CHECK(result.find('b') < result.find('d'));
+        CHECK(result.find('c') < result.find('d'));
+    }
+}
+
+TEST_CASE("the DAG counts predecessors and lists successors",
+          "[parallel_builder]") {
+    constexpr auto dag =
+        builder::build_dag<wrapper_t<(*a >> (*b && *c) >> *d)>>();
+    STATIC_REQUIRE(std::size(dag.nodes) == 4);
+    STATIC_REQUIRE(dag.num_edges() == 4);
+    STATIC_REQUIRE(std::size(dag.successors) == 4);
+
+    // in topological order, a is first and d is last
+    STATIC_REQUIRE(dag.predecessor_counts[0] == 0);
+    STATIC_REQUIRE(dag.predecessor_counts[1] == 1);
+    STATIC_REQUIRE(dag.predecessor_counts[2] == 1);
+    STATIC_REQUIRE(dag.predecessor_counts[3] == 2);
+    STATIC_REQUIRE(dag.successor_offsets[1] - dag.successor_offsets[0] == 2);
+    STATIC_REQUIRE(dag.successor_offsets[4] - dag.successor_offsets[3] == 0);
+}
+
+namespace {
+std::atomic<int> inner_runs{};
+
+constexpr auto inner = flow::action<"inner">([] { ++inner_runs; });
+
+struct inner_flow_t {
+    constexpr static auto value = flow::graph<>{}.add(*inner);
+};
+
+constexpr auto nested = flow::action<"nested">(
+    [] { builder::render<inner_flow_t>()(); });
+} // namespace
+
+TEST_CASE("a parallel flow step may run another parallel flow",
+          "[parallel_builder]") {
+    inner_runs = 0;
+    for (auto i = 0; i < 10; ++i) {
+        run_flow<(*nested && *a)>();
+    }
+    CHECK(inner_runs == 10);
+}
+
+#endif
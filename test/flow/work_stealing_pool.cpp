@@ -0,0 +1,81 @@
+#include <flow/work_stealing_pool.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstddef>
+
+namespace {
+struct counter {
+    flow::work_stealing_pool *pool;
+    std::atomic<std::size_t> count{};
+    std::atomic<std::size_t> left{};
+};
+
+auto count_task(void *context, std::size_t n) -> void {
+    auto &c = *static_cast<counter *>(context);
+    c.count += n;
+    auto &pool = *c.pool;
+    if (c.left.fetch_sub(1) == 1) {
+        pool.notify();
+    }
+}
+
+// submits two more tasks until the depth is used up
+auto fork_task(void *context, std::size_t depth) -> void {
+    auto &c = *static_cast<counter *>(context);
+    c.count += 1;
+    if (depth > 0) {
+        c.left += 2;
+        c.pool->submit({&fork_task, &c, depth - 1});
+        c.pool->submit({&fork_task, &c, depth - 1});
+    }
+    auto &pool = *c.pool;
+    if (c.left.fetch_sub(1) == 1) {
+        pool.notify();
+    }
+}
+} // namespace
+
+TEST_CASE("a pool has a fixed number of threads", "[work_stealing_pool]") {
+    auto pool = flow::work_stealing_pool{3};
+    CHECK(pool.size() == 3);
+    CHECK(flow::work_stealing_pool{0}.size() == 1);
+}
+
+TEST_CASE("a pool runs submitted tasks", "[work_stealing_pool]") {
+    auto pool = flow::work_stealing_pool{2};
+    auto c = counter{&pool};
+    c.left = 100;
+    for (auto i = std::size_t{1}; i <= 100; ++i) {
+        pool.submit({&count_task, &c, i});
+    }
+    pool.wait_until([&] { return c.left == 0; });
+    CHECK(c.count == 5050);
+}
+
+TEST_CASE("tasks may submit more tasks", "[work_stealing_pool]") {
+    auto pool = flow::work_stealing_pool{4};
+    auto c = counter{&pool};
+    c.left = 1;
+    pool.submit({&fork_task, &c, 9});
+    pool.wait_until([&] { return c.left == 0; });
+    CHECK(c.count == (1u << 10u) - 1);
+}
+
+TEST_CASE("pools of the same size are shared", "[work_stealing_pool]") {
+    CHECK(&flow::thread_pool<2>() == &flow::thread_pool<2>());
+    CHECK(&flow::thread_pool<2>() != &flow::thread_pool<3>());
+    CHECK(flow::thread_pool<3>().size() == 3);
+}
+
+TEST_CASE("a pool may be destroyed as its threads go to sleep",
+          "[work_stealing_pool]") {
+    // each destruction races the threads' first wait: a lost wakeup hangs
+    auto ran = std::size_t{};
+    for (auto i = 0; i < 200; ++i) {
+        auto pool = flow::work_stealing_pool{4};
+        ++ran;
+    }
+    CHECK(ran == 200);
+}
@@ -0,0 +1,238 @@
+#include <interrupt/config.hpp>
+#include <interrupt/dispatch.hpp>
+#include <interrupt/fwd.hpp>
+#include <interrupt/hal.hpp>
+#include <interrupt/impl.hpp>
+#include <interrupt/policies.hpp>
+
+#include <stdx/concepts.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+using interrupt::operator""_irq;
+
+namespace {
+struct test_hal {
+    static auto init() -> void {}
+
+    template <bool, interrupt::irq_num_t, std::size_t>
+    static auto irq_init() -> void {}
+
+    template <interrupt::status_policy P>
+    static auto run(interrupt::irq_num_t, stdx::invocable auto const &isr)
+        -> void {
+        P::run([] {}, [&] { isr(); });
+    }
+};
+} // namespace
+template <> inline auto interrupt::injected_hal<> = test_hal{};
+
+namespace {
+template <typename Field> struct field_value_t {
+    std::uint32_t value;
+};
+
+template <typename Reg, std::uint32_t Mask> struct mock_field_t {
+    using RegisterType = Reg;
+
+    constexpr static auto get_register() -> Reg { return {}; }
+    constexpr static auto get_mask() -> typename Reg::DataType { return Mask; }
+
+    constexpr auto operator()(std::uint32_t value) const {
+        return field_value_t<mock_field_t>{value};
+    }
+};
+
+template <int Id> struct mock_register_t {
+    using DataType = std::uint32_t;
+    constexpr static mock_field_t<mock_register_t, 0xffff'ffffu> raw{};
+
+    static inline DataType value{};
+    static inline int reads{};
+    static inline int writes{};
+
+    static auto reset(DataType v) -> void {
+        value = v;
+        reads = 0;
+        writes = 0;
+    }
+};
+
+template <typename Reg, std::uint32_t Bit>
+using bit_t = mock_field_t<Reg, 1u << Bit>;
+
+template <typename... Ops> constexpr auto apply(Ops... ops) {
+    return (ops(), ...);
+}
+
+template <typename Field> constexpr auto read(Field) {
+    return [] {
+        using R = typename Field::RegisterType;
+        ++R::reads;
+        return R::value & Field::get_mask();
+    };
+}
+
+template <typename Field> constexpr auto clear(Field) {
+    return [] {
+        using R = typename Field::RegisterType;
+        ++R::writes;
+        R::value &= ~Field::get_mask();
+    };
+}
+
+// status registers are write-one-to-clear
+template <typename Field> constexpr auto write(field_value_t<Field> v) {
+    return [=] {
+        using R = typename Field::RegisterType;
+        ++R::writes;
+        R::value &= ~v.value;
+    };
+}
+
+using enable_reg_t = mock_register_t<0>;
+using status_reg_t = mock_register_t<1>;
+using status2_reg_t = mock_register_t<2>;
+
+std::vector<int> isrs_run{};
+std::uint32_t status_seen{};
+
+template <int N> struct flow_t {
+    auto operator()() const -> void {
+        isrs_run.push_back(N);
+        status_seen = status_reg_t::value;
+    }
+    constexpr static bool active = true;
+};
+
+struct test_nexus {
+    template <typename T> constexpr static auto service = T{};
+};
+
+template <typename EnableField, typename StatusField, int N,
+          typename... Policies>
+using sub_t = interrupt::sub_irq_impl<
+    interrupt::sub_irq<EnableField, StatusField,
+                       interrupt::policies<Policies...>, flow_t<N>>,
+    test_nexus>;
+
+template <typename Dispatch, typename... Subs>
+using shared_t = interrupt::shared_irq_impl<
+    interrupt::shared_irq<17_irq, 1, interrupt::policies<Dispatch>>, Subs...>;
+
+auto reset(std::uint32_t enables, std::uint32_t status) -> void {
+    enable_reg_t::reset(enables);
+    status_reg_t::reset(status);
+    isrs_run.clear();
+}
+
+using sub0_t = sub_t<bit_t<enable_reg_t, 0>, bit_t<status_reg_t, 0>, 0>;
+using sub1_t = sub_t<bit_t<enable_reg_t, 1>, bit_t<status_reg_t, 1>, 1>;
+using sub2_t = sub_t<bit_t<enable_reg_t, 2>, bit_t<status_reg_t, 2>, 2>;
+} // namespace
+
+TEST_CASE("sub-interrupts are dispatched sequentially by default",
+          "[coalesced_dispatch]") {
+    using config_t = interrupt::shared_irq<17_irq, 1, interrupt::policies<>>;
+    STATIC_REQUIRE(std::is_same_v<config_t::dispatch_policy_t,
+                                  interrupt::sequential_dispatch>);
+}
+
+TEST_CASE("each register is read once", "[coalesced_dispatch]") {
+    using impl_t = shared_t<interrupt::coalesced_dispatch<>, sub0_t, sub1_t,
+                            sub2_t>;
+    reset(0b111, 0b101);
+    impl_t::run();
+    CHECK(isrs_run == std::vector{0, 2});
+    CHECK(enable_reg_t::reads == 1);
+    CHECK(status_reg_t::reads == 1);
+    CHECK(status_reg_t::value == 0);
+}
+
+TEST_CASE("disabled sub-interrupts are not run", "[coalesced_dispatch]") {
+    using impl_t = shared_t<interrupt::coalesced_dispatch<>, sub0_t, sub1_t,
+                            sub2_t>;
+    reset(0b001, 0b011);
+    impl_t::run();
+    CHECK(isrs_run == std::vector{0});
+    CHECK(status_reg_t::value == 0b010);
+}
+
+TEST_CASE("enable bits need not match status bits", "[coalesced_dispatch]") {
+    using a_t = sub_t<bit_t<enable_reg_t, 4>, bit_t<status_reg_t, 0>, 0>;
+    using b_t = sub_t<bit_t<enable_reg_t, 0>, bit_t<status_reg_t, 1>, 1>;
+    using impl_t = shared_t<interrupt::coalesced_dispatch<>, a_t, b_t>;
+    reset(0b1'0000, 0b11);
+    impl_t::run();
+    CHECK(isrs_run == std::vector{0});
+    CHECK(enable_reg_t::reads == 1);
+}
+
+TEST_CASE("status is cleared according to each status policy",
+          "[coalesced_dispatch]") {
+    using first_t = sub_t<bit_t<enable_reg_t, 0>, bit_t<status_reg_t, 0>, 0>;
+    using last_t = sub_t<bit_t<enable_reg_t, 1>, bit_t<status_reg_t, 1>, 1,
+                         interrupt::clear_status_last>;
+    using never_t = sub_t<bit_t<enable_reg_t, 2>, bit_t<status_reg_t, 2>, 2,
+                          interrupt::dont_clear_status>;
+    using impl_t = shared_t<interrupt::coalesced_dispatch<>, first_t, last_t,
+                            never_t>;
+    reset(0b111, 0b111);
+    impl_t::run();
+    CHECK(isrs_run == std::vector{0, 1, 2});
+    CHECK(status_seen == 0b110);
+    CHECK(status_reg_t::value == 0b100);
+}
+
+TEST_CASE("write-one-to-clear status is cleared with one write",
+          "[coalesced_dispatch]") {
+    using impl_t =
+        shared_t<interrupt::coalesced_dispatch<interrupt::write_one_to_clear>,
+                 sub0_t, sub1_t, sub2_t>;
+    reset(0b111, 0b111);
+    impl_t::run();
+    CHECK(isrs_run == std::vector{0, 1, 2});
+    CHECK(status_reg_t::writes == 1);
+    CHECK(status_reg_t::value == 0);
+}
+
+TEST_CASE("sub-interrupts are grouped by status register",
+          "[coalesced_dispatch]") {
+    using other_t = sub_t<bit_t<enable_reg_t, 3>, bit_t<status2_reg_t, 0>, 3>;
+    using impl_t = shared_t<interrupt::coalesced_dispatch<>, sub0_t, other_t,
+                            sub1_t>;
+    reset(0b1011, 0b10);
+    status2_reg_t::reset(0b1);
+    impl_t::run();
+    CHECK(isrs_run == std::vector{1, 3});
+    CHECK(enable_reg_t::reads == 1);
+    CHECK(status_reg_t::reads == 1);
+    CHECK(status2_reg_t::reads == 1);
+}
+
+namespace {
+struct custom_status_policy {
+    using policy_type = interrupt::status_clear_policy;
+
+    static void run(stdx::invocable auto const &clear_status,
+                    stdx::invocable auto const &run) {
+        clear_status();
+        run();
+    }
+};
+} // namespace
+
+TEST_CASE("other sub-interrupts are run after the coalesced ones",
+          "[coalesced_dispatch]") {
+    using custom_t = sub_t<bit_t<enable_reg_t, 0>, bit_t<status_reg_t, 0>, 0,
+                           custom_status_policy>;
+    using impl_t = shared_t<interrupt::coalesced_dispatch<>, custom_t, sub1_t>;
+    reset(0b11, 0b11);
+    impl_t::run();
+    CHECK(isrs_run == std::vector{1, 0});
+    CHECK(status_reg_t::value == 0);
+}
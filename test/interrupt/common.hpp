@@ -8,6 +8,7 @@
 #include <stdx/concepts.hpp>
 
 #include <cstddef>
+#include <cstdint>
 
 using interrupt::operator""_irq;
 
@@ -15,6 +16,7 @@ namespace {
 template <typename interrupt::irq_num_t> bool enabled{};
 template <typename interrupt::irq_num_t> std::size_t priority{};
 bool inited{};
+std::uint32_t cycles{};
 
 struct test_hal {
     static auto init() -> void { inited = true; }
@@ -30,6 +32,8 @@ struct test_hal {
         -> void {
         P::run([] {}, [&] { isr(); });
     }
+
+    static auto cycle_count() -> std::uint32_t { return cycles; }
 };
 } // namespace
 template <> inline auto interrupt::injected_hal<> = test_hal{};
@@ -0,0 +1,154 @@
+#include "common.hpp"
+
+#include <interrupt/config.hpp>
+#include <interrupt/deferred.hpp>
+#include <interrupt/instrumentation.hpp>
+#include <interrupt/policies.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <type_traits>
+#include <vector>
+
+namespace {
+std::vector<int> runs{};
+
+template <int N> auto record() -> void { runs.push_back(N); }
+
+using queue_t = interrupt::deferred_queue<2>;
+
+template <int N, std::size_t Priority = 0>
+constinit auto work = queue_t::work{&record<N>, Priority};
+} // namespace
+
+TEST_CASE("queue runs posted work", "[deferred]") {
+    auto q = queue_t{};
+    runs.clear();
+    CHECK(q.empty());
+
+    q.post(work<0>);
+    q.post(work<1>);
+    CHECK(not q.empty());
+    CHECK(runs.empty());
+
+    CHECK(q.run_pending() == 2);
+    CHECK(runs == std::vector{0, 1});
+    CHECK(q.empty());
+}
+
+TEST_CASE("pending work is queued only once", "[deferred]") {
+    auto q = queue_t{};
+    runs.clear();
+
+    q.post(work<0>);
+    q.post(work<0>);
+
+    CHECK(q.run_pending() == 1);
+    CHECK(runs == std::vector{0});
+}
+
+TEST_CASE("work can be posted again once it has run", "[deferred]") {
+    auto q = queue_t{};
+    runs.clear();
+
+    q.post(work<0>);
+    q.run_pending();
+    q.post(work<0>);
+    q.run_pending();
+
+    CHECK(runs == std::vector{0, 0});
+}
+
+TEST_CASE("more urgent work runs first", "[deferred]") {
+    auto q = queue_t{};
+    runs.clear();
+
+    q.post(work<1, 1>);
+    q.post(work<2, 1>);
+    q.post(work<0, 0>);
+
+    CHECK(q.run_one());
+    CHECK(runs == std::vector{0});
+    q.post(work<3, 0>);
+    q.run_pending();
+    CHECK(runs == std::vector{0, 3, 1, 2});
+}
+
+namespace {
+queue_t queue{};
+
+struct flow_a : std::true_type {};
+struct flow_b : std::true_type {};
+
+using deferred_irq_t = interrupt::irq<
+    17_irq, 1, interrupt::policies<interrupt::defer_flows<queue, 1>>, flow_a,
+    flow_b>;
+using deferred_impl_t = deferred_irq_t::built_t<test_nexus>;
+} // namespace
+
+TEST_CASE("config default execution policy runs flows in the isr",
+          "[deferred]") {
+    using config_t = interrupt::irq<17_irq, 1, interrupt::policies<>>;
+    STATIC_REQUIRE(std::is_same_v<config_t::execution_policy_t,
+                                  interrupt::run_flows_in_isr>);
+}
+
+TEST_CASE("deferred flows run when the queue is drained", "[deferred]") {
+    flow_run<flow_a> = false;
+    flow_run<flow_b> = false;
+
+    deferred_impl_t::run();
+    CHECK(not flow_run<flow_a>);
+    CHECK(not flow_run<flow_b>);
+
+    CHECK(queue.run_pending() == 1);
+    CHECK(flow_run<flow_a>);
+    CHECK(flow_run<flow_b>);
+}
+
+TEST_CASE("deferred sub_irq status is cleared in the isr", "[deferred]") {
+    using sub_t = interrupt::sub_irq<
+        enable_field_t<0>, status_field_t<0>,
+        interrupt::policies<interrupt::defer_flows<queue>>, flow_a>;
+    using shared_impl_t =
+        interrupt::shared_irq<33_irq, 1, interrupt::policies<>,
+                              sub_t>::built_t<test_nexus>;
+    enable_field_t<0>::value = true;
+    status_field_t<0>::value = true;
+    flow_run<flow_a> = false;
+
+    shared_impl_t::run();
+    CHECK(not status_field_t<0>::value);
+    CHECK(not flow_run<flow_a>);
+
+    queue.run_pending();
+    CHECK(flow_run<flow_a>);
+}
+
+namespace {
+struct slow_nexus {
+    template <typename T> struct service_t {
+        constexpr static bool active = true;
+        auto operator()() const -> void { cycles += 100; }
+    };
+    template <typename T> constexpr static auto service = service_t<T>{};
+};
+
+using measured_irq_t = interrupt::irq<
+    18_irq, 1,
+    interrupt::policies<interrupt::defer_flows<queue>,
+                        interrupt::measure_latency>,
+    flow_a>;
+} // namespace
+
+TEST_CASE("instrumentation measures only the top half", "[deferred]") {
+    interrupt::reset_stats<measured_irq_t>();
+    cycles = 0;
+
+    measured_irq_t::built_t<slow_nexus>::run();
+    CHECK(interrupt::snapshot_stats<measured_irq_t>().max_cycles == 0);
+
+    queue.run_pending();
+    CHECK(cycles == 100);
+    CHECK(interrupt::snapshot_stats<measured_irq_t>().count == 1);
+}
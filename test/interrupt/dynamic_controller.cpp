@@ -7,6 +7,9 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <cstdint>
+#include <type_traits>
+
 namespace {
 struct with_enable_field {
     constexpr static auto enable_field = 0;
@@ -50,8 +53,26 @@ template <typename... Ops> constexpr auto apply(Ops... ops) {
 using interrupt::operator""_irq;
 
 std::uint32_t register_value{};
+int register_writes{};
+std::uint32_t register_2_value{};
+int register_2_writes{};
+
+struct mock_register_2_t {
+    using DataType = std::uint32_t;
+    constexpr static mock_field_t<-1, mock_register_2_t, 31, 0> raw{};
+};
+
 template <typename F> constexpr auto write(field_value_t<F> v) {
-    return [=] { register_value = v.value; };
+    return [=] {
+        if constexpr (std::is_same_v<typename F::RegisterType,
+                                     mock_register_2_t>) {
+            register_2_value = v.value;
+            ++register_2_writes;
+        } else {
+            register_value = v.value;
+            ++register_writes;
+        }
+    };
 }
 
 struct test_flow_1_t : public flow::service<"1"> {};
@@ -155,3 +176,132 @@ TEST_CASE("disable resource that multiple irqs require",
     dynamic_t::turn_on_resource<test_resource_1>();
     CHECK(register_value == 0b1011);
 }
+
+TEST_CASE("resource change only writes registers whose value changes",
+          "[dynamic controller]") {
+    reset_dynamic_state();
+
+    dynamic_t::enable<test_flow_1_t>();
+    CHECK(register_value == 0b11);
+
+    // test_flow_2_t is disabled, so test_resource_2 changes nothing
+    register_writes = 0;
+    dynamic_t::turn_off_resource<test_resource_2>();
+    dynamic_t::turn_on_resource<test_resource_2>();
+    CHECK(register_writes == 0);
+
+    dynamic_t::turn_off_resource<test_resource_1>();
+    CHECK(register_value == 0b1);
+    CHECK(register_writes == 1);
+}
+
+TEST_CASE("turning a resource off twice writes once", "[dynamic controller]") {
+    reset_dynamic_state();
+    dynamic_t::enable<test_flow_1_t>();
+
+    register_writes = 0;
+    dynamic_t::turn_off_resource<test_resource_1>();
+    dynamic_t::turn_off_resource<test_resource_1>();
+    CHECK(register_writes == 1);
+    dynamic_t::turn_on_resource<test_resource_1>();
+    CHECK(register_value == 0b11);
+}
+
+namespace {
+struct test_flow_3_t : public flow::service<"3"> {};
+using en_field_2_0_t = mock_field_t<4, mock_register_2_t, 0, 0>;
+
+using two_reg_config_t = interrupt::root<interrupt::shared_irq<
+    0_irq, 0, interrupt::policies<>,
+    interrupt::sub_irq<
+        en_field_1_t, sts_field_t,
+        interrupt::policies<interrupt::required_resources<test_resource_1>>,
+        test_flow_1_t>,
+    interrupt::sub_irq<
+        en_field_2_0_t, sts_field_t,
+        interrupt::policies<interrupt::required_resources<test_resource_2>>,
+        test_flow_3_t>>>;
+
+using two_reg_dynamic_t = interrupt::dynamic_controller<two_reg_config_t>;
+} // namespace
+
+TEST_CASE("resource change only touches registers that depend on it",
+          "[dynamic controller]") {
+    two_reg_dynamic_t::enable<test_flow_1_t, test_flow_3_t>();
+    CHECK(register_value == 0b10);
+    CHECK(register_2_value == 0b1);
+
+    register_writes = 0;
+    register_2_writes = 0;
+    two_reg_dynamic_t::turn_off_resource<test_resource_2>();
+    CHECK(register_2_value == 0);
+    CHECK(register_2_writes == 1);
+    CHECK(register_writes == 0);
+
+    two_reg_dynamic_t::turn_on_resource<test_resource_2>();
+    CHECK(register_2_value == 0b1);
+    CHECK(register_writes == 0);
+}
+
+TEST_CASE("transaction changes nothing until committed",
+          "[dynamic controller]") {
+    reset_dynamic_state();
+
+    register_writes = 0;
+    auto tx = dynamic_t::begin();
+    tx.enable<test_flow_1_t>();
+    CHECK(register_writes == 0);
+    CHECK(register_value == 0b1);
+
+    tx.commit();
+    CHECK(register_value == 0b11);
+    CHECK(register_writes == 1);
+}
+
+TEST_CASE("transaction writes each register once", "[dynamic controller]") {
+    reset_dynamic_state();
+
+    register_writes = 0;
+    dynamic_t::begin()
+        .enable<test_flow_1_t>()
+        .enable<test_flow_2_t>()
+        .disable<test_flow_1_t>()
+        .enable_by_field<false, en_field_0_t>()
+        .commit();
+    CHECK(register_value == 0b1000);
+    CHECK(register_writes == 1);
+}
+
+TEST_CASE("later transaction changes override earlier ones",
+          "[dynamic controller]") {
+    reset_dynamic_state();
+
+    dynamic_t::begin()
+        .disable<test_flow_1_t>()
+        .enable<test_flow_1_t>()
+        .commit();
+    CHECK(register_value == 0b11);
+}
+
+TEST_CASE("transaction respects resources", "[dynamic controller]") {
+    reset_dynamic_state();
+    dynamic_t::turn_off_resource<test_resource_2>();
+
+    dynamic_t::begin().enable<test_flow_1_t, test_flow_2_t>().commit();
+    CHECK(register_value == 0b11);
+
+    dynamic_t::turn_on_resource<test_resource_2>();
+    CHECK(register_value == 0b1011);
+}
+
+TEST_CASE("transaction only writes registers it touches",
+          "[dynamic controller]") {
+    two_reg_dynamic_t::begin().disable<test_flow_1_t, test_flow_3_t>().commit();
+
+    register_writes = 0;
+    register_2_writes = 0;
+    two_reg_dynamic_t::begin().enable<test_flow_3_t>().commit();
+    CHECK(register_2_value == 0b1);
+    CHECK(register_2_writes == 1);
+    CHECK(register_writes == 0);
+}
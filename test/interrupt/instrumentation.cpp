@@ -0,0 +1,115 @@
+#include "common.hpp"
+
+#include <interrupt/config.hpp>
+#include <interrupt/instrumentation.hpp>
+#include <interrupt/policies.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <type_traits>
+
+namespace {
+struct timed_nexus {
+    template <typename T> struct service_t {
+        constexpr static bool active = T::value;
+        auto operator()() const -> void {
+            flow_run<T> = true;
+            if constexpr (requires { T::cycles; }) {
+                cycles += T::cycles;
+            }
+        }
+    };
+    template <typename T> constexpr static auto service = service_t<T>{};
+};
+
+template <std::uint32_t Cycles> struct slow_flow : std::true_type {
+    constexpr static auto cycles = Cycles;
+};
+
+using irq_t =
+    interrupt::irq<17_irq, 1, interrupt::policies<interrupt::measure_latency>,
+                   slow_flow<5>>;
+using irq_impl_t = irq_t::built_t<timed_nexus>;
+} // namespace
+
+TEST_CASE("config default instrumentation policy is none",
+          "[instrumentation]") {
+    using config_t = interrupt::irq<17_irq, 1, interrupt::policies<>>;
+    STATIC_REQUIRE(std::is_same_v<config_t::instrumentation_policy_t,
+                                  interrupt::no_instrumentation>);
+}
+
+TEST_CASE("instrumented irq records its runs", "[instrumentation]") {
+    interrupt::reset_stats<irq_t>();
+    flow_run<slow_flow<5>> = false;
+
+    irq_impl_t::run();
+    irq_impl_t::run();
+
+    CHECK(flow_run<slow_flow<5>>);
+    auto const stats = interrupt::snapshot_stats<irq_t>();
+    CHECK(stats.count == 2);
+    CHECK(stats.max_cycles == 5);
+    CHECK(stats.histogram[3] == 2);
+}
+
+TEST_CASE("histogram buckets are powers of 2", "[instrumentation]") {
+    auto stats = interrupt::irq_stats{};
+    stats.record(0);
+    stats.record(1);
+    stats.record(2);
+    stats.record(3);
+    stats.record(4);
+    stats.record(0xffff'ffffu);
+
+    CHECK(stats.count == 6);
+    CHECK(stats.max_cycles == 0xffff'ffffu);
+    CHECK(stats.histogram[0] == 1);
+    CHECK(stats.histogram[1] == 1);
+    CHECK(stats.histogram[2] == 2);
+    CHECK(stats.histogram[3] == 1);
+    CHECK(stats.histogram.back() == 1);
+}
+
+TEST_CASE("cycle counter may wrap during an isr", "[instrumentation]") {
+    interrupt::reset_stats<irq_t>();
+    cycles = 0xffff'fffeu;
+
+    irq_impl_t::run();
+
+    CHECK(interrupt::snapshot_stats<irq_t>().max_cycles == 5);
+}
+
+TEST_CASE("stats can be reset", "[instrumentation]") {
+    irq_impl_t::run();
+    interrupt::reset_stats<irq_t>();
+    CHECK(interrupt::snapshot_stats<irq_t>() == interrupt::irq_stats{});
+}
+
+namespace {
+using sub_a_t = interrupt::sub_irq<
+    enable_field_t<0>, status_field_t<0>,
+    interrupt::policies<interrupt::measure_latency>, slow_flow<3>>;
+using sub_b_t = interrupt::sub_irq<enable_field_t<1>, status_field_t<1>,
+                                   interrupt::policies<>, slow_flow<100>>;
+using shared_t = interrupt::shared_irq<
+    33_irq, 1, interrupt::policies<interrupt::measure_latency>, sub_a_t,
+    sub_b_t>;
+using shared_impl_t = shared_t::built_t<timed_nexus>;
+} // namespace
+
+TEST_CASE("each config is measured separately", "[instrumentation]") {
+    interrupt::reset_stats<sub_a_t>();
+    interrupt::reset_stats<shared_t>();
+    enable_field_t<0>::value = true;
+    status_field_t<0>::value = true;
+    enable_field_t<1>::value = true;
+    status_field_t<1>::value = true;
+
+    shared_impl_t::run();
+
+    CHECK(interrupt::snapshot_stats<sub_a_t>().max_cycles == 3);
+    CHECK(interrupt::snapshot_stats<shared_t>().max_cycles == 103);
+    CHECK(interrupt::snapshot_stats<sub_b_t>().count == 0);
+}
@@ -259,3 +259,42 @@ TEST_CASE("init enables id interrupts", "[manager]") {
     m.init();
     CHECK(enable_field_t<33'0>::value);
 }
+
+TEST_CASE("run flow by runtime irq number", "[manager]") {
+    auto m = interrupt::manager<config_shared, test_nexus>{};
+    flow_run<flow_38> = false;
+
+    m.run(38_irq);
+
+    CHECK(flow_run<flow_38>);
+}
+
+TEST_CASE("running an unconfigured irq number does nothing", "[manager]") {
+    auto m = interrupt::manager<config_shared, test_nexus>{};
+    flow_run<flow_33_1> = false;
+    flow_run<flow_33_2> = false;
+    flow_run<flow_38> = false;
+
+    m.run(0_irq);
+    m.run(37_irq);
+    m.run(39_irq);
+    m.run(1'000_irq);
+
+    CHECK(not flow_run<flow_33_1>);
+    CHECK(not flow_run<flow_33_2>);
+    CHECK(not flow_run<flow_38>);
+}
+
+TEST_CASE("vector table covers every irq number", "[manager]") {
+    using manager_t = interrupt::manager<config_shared, test_nexus>;
+    constexpr auto const &table = manager_t::vector_table();
+    STATIC_REQUIRE(table.size() == 39);
+    STATIC_REQUIRE(table[0] == table[37]);
+    STATIC_REQUIRE(table[33] != table[0]);
+    STATIC_REQUIRE(table[38] != table[0]);
+    STATIC_REQUIRE(table[33] != table[38]);
+
+    flow_run<flow_38> = false;
+    table[38]();
+    CHECK(flow_run<flow_38>);
+}
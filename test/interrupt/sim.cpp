@@ -0,0 +1,217 @@
+#include <interrupt/config.hpp>
+#include <interrupt/fwd.hpp>
+#include <interrupt/hal.hpp>
+#include <interrupt/manager.hpp>
+#include <interrupt/policies.hpp>
+#include <interrupt/sim/generator.hpp>
+#include <interrupt/sim/hal.hpp>
+#include <interrupt/sim/registers.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+using interrupt::operator""_irq;
+
+namespace {
+constinit auto sim_irqs = interrupt::sim::controller<16>{};
+} // namespace
+template <> inline auto interrupt::injected_hal<> =
+    interrupt::sim::hal<sim_irqs>{};
+
+namespace {
+std::vector<int> isr_log{};
+auto (*during_isr)(int) -> void = [](int) {};
+
+template <int Id> struct flow {
+    auto operator()() const -> void {
+        isr_log.push_back(Id);
+        during_isr(Id);
+    }
+    constexpr static bool active = true;
+};
+
+struct sim_nexus {
+    template <typename T> constexpr static auto service = T{};
+};
+
+using enable_reg_t = interrupt::sim::reg<0>;
+using status_reg_t = interrupt::sim::reg<1>;
+using enable_field_t = enable_reg_t::field_t<0>;
+using status_field_t = status_reg_t::field_t<0>;
+
+// IRQ 5 is the most urgent, then IRQ 3, then IRQ 7
+using config_t = interrupt::root<
+    interrupt::irq<3_irq, 2, interrupt::policies<>, flow<3>>,
+    interrupt::irq<5_irq, 1, interrupt::policies<>, flow<5>>,
+    interrupt::shared_irq<
+        7_irq, 3, interrupt::policies<>,
+        interrupt::sub_irq<enable_field_t, status_field_t,
+                           interrupt::policies<>, flow<7>>>>;
+
+constexpr auto manager = interrupt::manager<config_t, sim_nexus>{};
+
+auto reset() -> void {
+    sim_irqs.service();
+    sim_irqs.reset_stats();
+    sim_irqs.attach(manager);
+    manager.init();
+    isr_log.clear();
+    during_isr = [](int) {};
+}
+} // namespace
+
+TEST_CASE("register fields read, write, set and clear",
+          "[interrupt_sim]") {
+    using reg_t = interrupt::sim::reg<42, std::uint8_t>;
+    using field_t = reg_t::field_t<5, 4>;
+    static_assert(field_t::get_mask() == 0b11'0000);
+
+    apply(write(reg_t::raw(0b1000'0001)));
+    CHECK(apply(read(field_t{})) == 0);
+
+    apply(set(field_t{}));
+    CHECK(apply(read(field_t{})) == 0b11);
+    CHECK(apply(read(reg_t::raw)) == 0b1011'0001);
+
+    apply(write(field_t{}(0b01)));
+    CHECK(apply(read(reg_t::raw)) == 0b1001'0001);
+
+    apply(clear(field_t{}));
+    CHECK(apply(read(reg_t::raw)) == 0b1000'0001);
+}
+
+TEST_CASE("init enables interrupts and sub_irqs", "[interrupt_sim]") {
+    apply(write(enable_reg_t::raw(0)));
+    reset();
+
+    CHECK(apply(read(enable_field_t{})) == 1);
+
+    sim_irqs.raise(3_irq);
+    CHECK(sim_irqs.is_pending(3_irq));
+    CHECK(sim_irqs.service() == 1);
+    CHECK(not sim_irqs.is_pending(3_irq));
+    CHECK(isr_log == std::vector{3});
+}
+
+TEST_CASE("an interrupt raised several times runs once", "[interrupt_sim]") {
+    reset();
+
+    sim_irqs.raise(3_irq);
+    sim_irqs.raise(3_irq);
+    sim_irqs.service();
+
+    CHECK(isr_log == std::vector{3});
+    CHECK(sim_irqs.raised() == 2);
+    CHECK(sim_irqs.serviced() == 1);
+    CHECK(sim_irqs.latency(3_irq).count == 1);
+}
+
+TEST_CASE("the most urgent pending interrupt runs first", "[interrupt_sim]") {
+    reset();
+
+    sim_irqs.raise(3_irq);
+    sim_irqs.raise(5_irq);
+    sim_irqs.service();
+
+    CHECK(isr_log == std::vector{5, 3});
+    CHECK(sim_irqs.preemptions() == 0);
+}
+
+TEST_CASE("a disabled interrupt stays pending", "[interrupt_sim]") {
+    reset();
+
+    sim_irqs.configure(3_irq, false, 2);
+    sim_irqs.raise(3_irq);
+    CHECK(sim_irqs.service() == 0);
+    CHECK(sim_irqs.is_pending(3_irq));
+
+    sim_irqs.configure(3_irq, true, 2);
+    CHECK(sim_irqs.service() == 1);
+    CHECK(isr_log == std::vector{3});
+}
+
+TEST_CASE("a more urgent interrupt preempts at a preemption point",
+          "[interrupt_sim]") {
+    reset();
+    during_isr = [](int id) {
+        if (id == 3) {
+            sim_irqs.raise(5_irq);
+            sim_irqs.service();
+            isr_log.push_back(-3);
+        }
+    };
+
+    sim_irqs.raise(3_irq);
+    sim_irqs.service();
+
+    CHECK(isr_log == std::vector{3, 5, -3});
+    CHECK(sim_irqs.preemptions() == 1);
+}
+
+TEST_CASE("a less urgent interrupt waits for the running one",
+          "[interrupt_sim]") {
+    reset();
+    during_isr = [](int id) {
+        if (id == 5) {
+            sim_irqs.raise(3_irq);
+            sim_irqs.service();
+            isr_log.push_back(-5);
+        }
+    };
+
+    sim_irqs.raise(5_irq);
+    sim_irqs.service();
+
+    CHECK(isr_log == std::vector{5, -5, 3});
+    CHECK(sim_irqs.preemptions() == 0);
+}
+
+TEST_CASE("a sub_irq runs when its status field is set", "[interrupt_sim]") {
+    reset();
+
+    sim_irqs.raise(7_irq);
+    sim_irqs.service();
+    CHECK(isr_log.empty());
+
+    apply(set(status_field_t{}));
+    sim_irqs.raise(7_irq);
+    sim_irqs.service();
+    CHECK(isr_log == std::vector{7});
+    CHECK(apply(read(status_field_t{})) == 0);
+}
+
+TEST_CASE("a generator raises interrupts for the core to service",
+          "[interrupt_sim]") {
+    reset();
+    constexpr auto limit = 200u;
+    {
+        auto core = std::jthread{
+            [](std::stop_token stop) { sim_irqs.run(stop); }};
+        auto g = interrupt::sim::generator{
+            sim_irqs,
+            {{.irq = 3_irq, .rate = 100'000},
+             {.irq = 7_irq,
+              .rate = 100'000,
+              .pattern = interrupt::sim::arrival::bursty,
+              .burst_size = 4,
+              .before_raise = [] { apply(set(status_field_t{})); }}},
+            limit};
+        g.wait();
+        CHECK(g.raised() == limit);
+        while (sim_irqs.is_pending(3_irq) or sim_irqs.is_pending(7_irq)) {
+            std::this_thread::yield();
+        }
+    }
+
+    CHECK(sim_irqs.raised() == limit);
+    CHECK(sim_irqs.serviced() > 0);
+    CHECK(sim_irqs.serviced() <= limit);
+    CHECK(isr_log.size() <= sim_irqs.serviced());
+    CHECK(sim_irqs.latency(3_irq).count + sim_irqs.latency(7_irq).count ==
+          sim_irqs.serviced());
+}
@@ -0,0 +1,241 @@
+#include <interrupt/config.hpp>
+#include <interrupt/dynamic_controller.hpp>
+#include <interrupt/fwd.hpp>
+#include <interrupt/hal.hpp>
+#include <interrupt/manager.hpp>
+#include <interrupt/policies.hpp>
+#include <interrupt/sim/registers.hpp>
+#include <interrupt/storm.hpp>
+
+#include <stdx/concepts.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+using interrupt::operator""_irq;
+
+namespace {
+std::uint32_t cycles{};
+
+struct test_hal {
+    static auto init() -> void {}
+
+    template <bool, interrupt::irq_num_t, std::size_t>
+    static auto irq_init() -> void {}
+
+    template <interrupt::status_policy P>
+    static auto run(interrupt::irq_num_t, stdx::invocable auto const &isr)
+        -> void {
+        P::run([] {}, [&] { isr(); });
+    }
+
+    static auto cycle_count() -> std::uint32_t { return cycles; }
+};
+} // namespace
+template <> inline auto interrupt::injected_hal<> = test_hal{};
+
+namespace {
+template <int Id> int flow_runs{};
+
+template <int Id> struct flow {
+    auto operator()() const -> void { ++flow_runs<Id>; }
+    constexpr static bool active = true;
+};
+
+struct test_nexus {
+    template <typename T> constexpr static auto service = T{};
+};
+
+using enable_reg_t = interrupt::sim::reg<0>;
+using status_reg_t = interrupt::sim::reg<1>;
+using enable_a_t = enable_reg_t::field_t<0>;
+using status_a_t = status_reg_t::field_t<0>;
+using enable_b_t = enable_reg_t::field_t<1>;
+using status_b_t = status_reg_t::field_t<1>;
+
+constinit auto storms = interrupt::storm_monitor{};
+
+// more than 3 interrupts in 100 cycles is a storm
+struct dynamic_t;
+using guard_t = interrupt::storm_guard<storms, dynamic_t, 3, 100>;
+
+using sub_a_t = interrupt::sub_irq<enable_a_t, status_a_t,
+                                   interrupt::policies<guard_t>, flow<0>>;
+using sub_b_t =
+    interrupt::sub_irq<enable_b_t, status_b_t, interrupt::policies<>, flow<1>>;
+using config_t = interrupt::root<
+    interrupt::shared_irq<17_irq, 4, interrupt::policies<>, sub_a_t, sub_b_t>>;
+
+struct dynamic_t : interrupt::dynamic_controller<config_t> {};
+
+constexpr auto manager = interrupt::manager<config_t, test_nexus>{};
+
+auto reset() -> void {
+    while (not storms.empty()) {
+        apply(write(status_reg_t::raw(0)));
+        cycles += 1000;
+        storms.poll();
+    }
+    cycles += 1000;
+    manager.init();
+    flow_runs<0> = 0;
+    flow_runs<1> = 0;
+}
+
+auto fire_a() -> void {
+    apply(set(status_a_t{}));
+    manager.run<17_irq>();
+}
+
+auto a_enabled() -> bool { return apply(read(enable_a_t{})) != 0; }
+} // namespace
+
+TEST_CASE("interrupts up to the threshold are serviced as usual",
+          "[storm]") {
+    reset();
+    auto const storms_before = interrupt::storm_count<sub_a_t>();
+
+    for (auto i = 0; i < 3; ++i) {
+        fire_a();
+        cycles += 10;
+    }
+
+    CHECK(flow_runs<0> == 3);
+    CHECK(a_enabled());
+    CHECK(storms.empty());
+    CHECK(interrupt::storm_count<sub_a_t>() == storms_before);
+}
+
+TEST_CASE("the count starts again in each window", "[storm]") {
+    reset();
+
+    for (auto i = 0; i < 3; ++i) {
+        fire_a();
+    }
+    cycles += 100;
+    for (auto i = 0; i < 3; ++i) {
+        fire_a();
+    }
+
+    CHECK(flow_runs<0> == 6);
+    CHECK(a_enabled());
+}
+
+TEST_CASE("a storm masks the interrupt", "[storm]") {
+    reset();
+    auto const storms_before = interrupt::storm_count<sub_a_t>();
+
+    for (auto i = 0; i < 4; ++i) {
+        fire_a();
+    }
+
+    CHECK(flow_runs<0> == 4);
+    CHECK(not a_enabled());
+    CHECK(interrupt::storm_count<sub_a_t>() == storms_before + 1);
+
+    // masked, so the shared interrupt no longer runs it
+    fire_a();
+    CHECK(flow_runs<0> == 4);
+}
+
+TEST_CASE("an occurrence pending as the mask takes effect is the same storm",
+          "[storm]") {
+    reset();
+    auto const storms_before = interrupt::storm_count<sub_a_t>();
+
+    for (auto i = 0; i < 4; ++i) {
+        fire_a();
+    }
+    // as if it had passed the enable check just before the mask
+    using impl_a_t = interrupt::sub_irq_impl<sub_a_t, test_nexus>;
+    apply(set(status_a_t{}));
+    guard_t::run<sub_a_t, &impl_a_t::service>();
+
+    CHECK(flow_runs<0> == 5);
+    CHECK(not a_enabled());
+    CHECK(interrupt::storm_count<sub_a_t>() == storms_before + 1);
+}
+
+TEST_CASE("a masked interrupt is serviced by polling", "[storm]") {
+    reset();
+    for (auto i = 0; i < 4; ++i) {
+        fire_a();
+    }
+
+    // several occurrences between polls run the flows once
+    apply(set(status_a_t{}));
+    apply(set(status_a_t{}));
+    CHECK(storms.poll() == 1);
+    CHECK(flow_runs<0> == 5);
+    CHECK(apply(read(status_a_t{})) == 0);
+    CHECK(not a_enabled());
+}
+
+TEST_CASE("a storm ends after a quiet poll once a window has passed",
+          "[storm]") {
+    reset();
+    for (auto i = 0; i < 4; ++i) {
+        fire_a();
+    }
+
+    cycles += 50;
+    CHECK(storms.poll() == 1);
+    CHECK(not a_enabled());
+
+    cycles += 50;
+    apply(set(status_a_t{}));
+    CHECK(storms.poll() == 1);
+    CHECK(not a_enabled());
+
+    CHECK(storms.poll() == 0);
+    CHECK(a_enabled());
+    CHECK(storms.empty());
+
+    fire_a();
+    CHECK(flow_runs<0> == 6);
+}
+
+TEST_CASE("an interrupt disabled while storming stays disabled after",
+          "[storm]") {
+    reset();
+    for (auto i = 0; i < 4; ++i) {
+        fire_a();
+    }
+    dynamic_t::enable_by_field<false, enable_a_t>();
+    CHECK(not a_enabled());
+
+    cycles += 100;
+    CHECK(storms.poll() == 0);
+    CHECK(not a_enabled());
+
+    dynamic_t::enable_by_field<true, enable_a_t>();
+    CHECK(a_enabled());
+}
+
+TEST_CASE("enabling a storming interrupt leaves it masked", "[storm]") {
+    reset();
+    for (auto i = 0; i < 4; ++i) {
+        fire_a();
+    }
+    dynamic_t::enable_by_field<true, enable_a_t>();
+    CHECK(not a_enabled());
+
+    cycles += 100;
+    CHECK(storms.poll() == 0);
+    CHECK(a_enabled());
+}
+
+TEST_CASE("an unguarded interrupt is never masked", "[storm]") {
+    reset();
+
+    for (auto i = 0; i < 100; ++i) {
+        apply(set(status_b_t{}));
+        manager.run<17_irq>();
+    }
+
+    CHECK(flow_runs<1> == 100);
+    CHECK(apply(read(enable_b_t{})) != 0);
+    CHECK(storms.empty());
+}
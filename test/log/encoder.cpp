@@ -3,6 +3,7 @@
 #include <stdx/concepts.hpp>
 #include <stdx/ct_format.hpp>
 #include <stdx/span.hpp>
+#include <stdx/utility.hpp>
 
 #include <conc/concurrency.hpp>
 
@@ -11,7 +12,10 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <initializer_list>
+#include <limits>
 #include <utility>
+#include <vector>
 
 namespace {
 constexpr string_id test_string_id = 42u;
@@ -58,6 +62,13 @@ struct test_conc_policy {
            (static_cast<std::uint32_t>(level) << 4u) | 0x3u;
 }
 
+[[maybe_unused]] constexpr auto expected_varint_header(logging::level level,
+                                                       module_id m)
+    -> std::uint32_t {
+    return (0x3eu << 24u) | (m << 16u) |
+           (static_cast<std::uint32_t>(level) << 4u) | 0x3u;
+}
+
 [[maybe_unused]] constexpr auto expected_msg_header(logging::level level,
                                                     module_id m, std::size_t sz)
     -> std::uint32_t {
@@ -182,6 +193,40 @@ TEST_CASE("argument encoding", "[mipi]") {
     STATIC_REQUIRE(std::same_as<P::encode_as_t<double>, encode_u64<double>>);
 }
 
+TEST_CASE("varint argument encoding", "[mipi]") {
+    using P = logging::varint_arg_packer;
+    STATIC_REQUIRE(
+        std::same_as<P::encode_as_t<std::int32_t>, encode_z32<std::int32_t>>);
+    STATIC_REQUIRE(
+        std::same_as<P::encode_as_t<std::uint32_t>, encode_v32<std::uint32_t>>);
+    STATIC_REQUIRE(
+        std::same_as<P::encode_as_t<std::int64_t>, encode_z64<std::int64_t>>);
+    STATIC_REQUIRE(
+        std::same_as<P::encode_as_t<std::uint64_t>, encode_v64<std::uint64_t>>);
+    STATIC_REQUIRE(std::same_as<P::encode_as_t<float>, encode_u32<float>>);
+    STATIC_REQUIRE(std::same_as<P::encode_as_t<double>, encode_u64<double>>);
+    STATIC_REQUIRE(P::max_packed_size<std::uint32_t> == 5);
+    STATIC_REQUIRE(P::max_packed_size<std::int64_t> == 10);
+    STATIC_REQUIRE(P::max_packed_size<float> == 4);
+}
+
+TEST_CASE("varint argument packing", "[mipi]") {
+    using P = logging::varint_arg_packer;
+    auto const packed = [](auto arg) {
+        auto buf = std::array<std::uint8_t, 10>{};
+        auto const end = P::pack(buf.data(), arg);
+        return std::vector<std::uint8_t>(buf.data(), end);
+    };
+    CHECK(packed(0) == std::vector<std::uint8_t>{0x00});
+    CHECK(packed(-1) == std::vector<std::uint8_t>{0x01});
+    CHECK(packed(1) == std::vector<std::uint8_t>{0x02});
+    CHECK(packed(300u) == std::vector<std::uint8_t>{0xac, 0x02});
+    CHECK(packed(std::numeric_limits<std::int32_t>::min()) ==
+          std::vector<std::uint8_t>{0xff, 0xff, 0xff, 0xff, 0x0f});
+    CHECK(packed(std::numeric_limits<std::uint64_t>::max()).size() == 10);
+    CHECK(packed(1.5f) == std::vector<std::uint8_t>{0x00, 0x00, 0xc0, 0x3f});
+}
+
 TEST_CASE("log zero arguments", "[mipi]") {
     CIB_LOG_ENV(logging::get_level, logging::level::TRACE);
     test_critical_section::count = 0;
@@ -406,3 +451,74 @@ TEST_CASE("log with overridden builder", "[mipi]") {
     cfg.logger.log_msg<catalog_env>(stdx::ct_format<"Hello">());
     CHECK(num_catalog_args_calls == 1);
 }
+
+namespace {
+std::vector<std::uint8_t> varint_bytes{};
+
+struct test_varint_destination {
+    template <std::size_t N>
+    auto log_by_buf(stdx::span<std::uint8_t const, N> data) {
+        varint_bytes.assign(data.begin(), data.end());
+    }
+};
+} // namespace
+
+TEST_CASE("log with varint packer", "[mipi]") {
+    using varint_env =
+        stdx::make_env_t<logging::get_level, logging::level::TRACE,
+                         logging::binary::get_builder,
+                         logging::mipi::default_builder<
+                             logging::varint_arg_packer>{}>;
+
+    varint_bytes.clear();
+    auto cfg = logging::binary::config{test_varint_destination{}};
+    cfg.logger.log_msg<varint_env>(stdx::ct_format<"{} {}">(-2, 300u));
+
+    REQUIRE(varint_bytes.size() == 11);
+    auto const data = stdx::span<std::uint8_t const>{varint_bytes};
+    check_at(data, 0,
+             expected_varint_header(logging::level::TRACE, test_module_id));
+    check_at(data, 1, test_string_id);
+    CHECK(std::vector<std::uint8_t>(varint_bytes.begin() + 8,
+                                    varint_bytes.end()) ==
+          std::vector<std::uint8_t>{0x03, 0xac, 0x02});
+}
+
+namespace {
+enum struct test_state : std::uint8_t { idle, running, done };
+
+// The bytes taken by a mix of records like that of a typical application.
+template <typename P> auto mix_bytes() -> std::size_t {
+    using builder_t = logging::mipi::default_builder<P>;
+    constexpr auto L = stdx::to_underlying(logging::level::TRACE);
+    auto const size = [](auto const &msg) {
+        auto const data = msg.as_const_view().data();
+        return data.size() * sizeof(data[0]);
+    };
+    auto const build = [&](auto... args) {
+        return size(builder_t::template build<L>(test_string_id,
+                                                 test_module_id, args...));
+    };
+
+    auto total = std::size_t{};
+    // 30%: no arguments
+    for (auto i = 0; i < 3; ++i) {
+        total += build();
+    }
+    // 40%: a counter
+    for (auto n : {7u, 42u, 100u, 1000u}) {
+        total += build(n);
+    }
+    // 20%: a state and a counter
+    total += build(test_state::running, 5u);
+    total += build(test_state::done, 300u);
+    // 10%: a 40-bit value
+    total += build(std::uint64_t{0x12'3456'7890});
+    return total;
+}
+} // namespace
+
+TEST_CASE("varint packing shrinks a typical mix of records", "[mipi]") {
+    CHECK(mix_bytes<logging::default_arg_packer>() == 108);
+    CHECK(mix_bytes<logging::varint_arg_packer>() == 84);
+}
@@ -0,0 +1,145 @@
+#include <log/fmt/logger.hpp>
+#include <log/level.hpp>
+
+#include <stdx/ct_format.hpp>
+#include <stdx/ct_string.hpp>
+#include <stdx/env.hpp>
+#include <stdx/tuple.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+namespace {
+std::string buffer{};
+
+struct small_queues {
+    constexpr static auto num_queues = std::size_t{2};
+    constexpr static auto queue_capacity = std::size_t{4};
+    constexpr static auto max_arg_bytes = std::size_t{16};
+    constexpr static auto max_text_bytes = std::size_t{16};
+};
+} // namespace
+
+template <>
+inline auto logging::config<> =
+    logging::fmt::deferred_config{small_queues{}, std::back_inserter(buffer)};
+
+namespace {
+auto flush() { return logging::config<>.logger.flush(); }
+} // namespace
+
+TEST_CASE("deferred log calls are not formatted until flush",
+          "[fmt_deferred]") {
+    buffer.clear();
+    CIB_INFO("Hello {} {}", 17, 3.5);
+    CHECK(buffer.empty());
+
+    CHECK(flush() == 1);
+    CAPTURE(buffer);
+    CHECK(buffer.find("INFO [default]: Hello 17 3.5\n") != std::string::npos);
+    CHECK(flush() == 0);
+}
+
+TEST_CASE("deferred log calls keep their order", "[fmt_deferred]") {
+    buffer.clear();
+    CIB_INFO("first {}", 1);
+    CIB_INFO("second {}", 2);
+    CHECK(flush() == 2);
+    CAPTURE(buffer);
+    CHECK(buffer.find("first 1") < buffer.find("second 2"));
+}
+
+TEST_CASE("non-value arguments are formatted at the log call",
+          "[fmt_deferred]") {
+    buffer.clear();
+    auto s = std::string{"world"};
+    CIB_INFO("Hello {}", std::string_view{s});
+    s = "changed";
+    CHECK(buffer.empty());
+
+    CHECK(flush() == 1);
+    CAPTURE(buffer);
+    CHECK(buffer.find("Hello world\n") != std::string::npos);
+}
+
+TEST_CASE("arguments that are too large are formatted at the log call",
+          "[fmt_deferred]") {
+    buffer.clear();
+    CIB_INFO("{} {} {}", 1.0, 2.0, 3.0);
+    CHECK(buffer.empty());
+
+    CHECK(flush() == 1);
+    CAPTURE(buffer);
+    CHECK(buffer.find("1 2 3\n") != std::string::npos);
+}
+
+TEST_CASE("text formatted at the log call is truncated", "[fmt_deferred]") {
+    buffer.clear();
+    CIB_INFO("{}", std::string_view{"0123456789abcdefXYZ"});
+    CHECK(flush() == 1);
+    CAPTURE(buffer);
+    CHECK(buffer.find(": 0123456789abcdef\n") != std::string::npos);
+}
+
+TEST_CASE("text and deferred log calls keep their order", "[fmt_deferred]") {
+    buffer.clear();
+    CIB_INFO("first {}", std::string_view{"text"});
+    CIB_INFO("second {}", 2);
+    CHECK(flush() == 2);
+    CAPTURE(buffer);
+    CHECK(buffer.find("first text") < buffer.find("second 2"));
+}
+
+TEST_CASE("log calls are dropped when a queue is full", "[fmt_deferred]") {
+    buffer.clear();
+    auto const dropped = logging::config<>.logger.num_dropped();
+    for (auto i = 0; i < 6; ++i) {
+        CIB_INFO("{}", i);
+    }
+    CHECK(logging::config<>.logger.num_dropped() == dropped + 2);
+    CHECK(flush() == 4);
+}
+
+namespace {
+std::size_t current_queue{};
+struct test_queue_index {
+    auto operator()() const -> std::size_t { return current_queue; }
+};
+
+using log_env = stdx::make_env_t<logging::get_level, logging::level::INFO>;
+using destinations_t = stdx::tuple<std::back_insert_iterator<std::string>>;
+using handler_t =
+    logging::fmt::deferred_log_handler<small_queues, destinations_t,
+                                       test_queue_index>;
+
+// so that successive log calls have distinct timestamps
+auto next_tick() -> void {
+    auto const now = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() == now) {
+    }
+}
+} // namespace
+
+TEST_CASE("flush merges the queues in timestamp order", "[fmt_deferred]") {
+    auto out = std::string{};
+    auto h = handler_t{destinations_t{std::back_inserter(out)}};
+
+    current_queue = 1;
+    h.log<log_env>("", 0, stdx::ct_format<"first {}">(1));
+    next_tick();
+    current_queue = 0;
+    h.log<log_env>("", 0, stdx::ct_format<"second {}">(2));
+    next_tick();
+    current_queue = 1;
+    h.log<log_env>("", 0, stdx::ct_format<"third {}">(3));
+
+    CHECK(h.flush() == 3);
+    CAPTURE(out);
+    CHECK(out.find("first 1") < out.find("second 2"));
+    CHECK(out.find("second 2") < out.find("third 3"));
+}
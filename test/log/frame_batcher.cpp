@@ -0,0 +1,106 @@
+#include <log/catalog/frame_batcher.hpp>
+
+#include <stdx/concepts.hpp>
+#include <stdx/span.hpp>
+
+#include <conc/concurrency.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace {
+int num_critical_sections{};
+
+struct test_conc_policy {
+    template <typename = void, stdx::invocable F, stdx::predicate... Pred>
+        requires(sizeof...(Pred) < 2)
+    static inline auto call_in_critical_section(F &&f, Pred &&...)
+        -> decltype(std::forward<F>(f)()) {
+        ++num_critical_sections;
+        return std::forward<F>(f)();
+    }
+};
+
+struct test_transport {
+    std::vector<std::vector<std::uint8_t>> frames{};
+
+    auto log_by_buf(stdx::span<std::uint8_t const> data) -> void {
+        frames.emplace_back(data.begin(), data.end());
+    }
+};
+
+using batcher_t = logging::binary::frame_batcher<test_transport, 16>;
+} // namespace
+
+template <> inline auto conc::injected_policy<> = test_conc_policy{};
+
+TEST_CASE("records are batched into frames", "[frame_batcher]") {
+    auto b = batcher_t{};
+    auto d = b.destination();
+    d.log_by_args(0x0403'0201u, 0x0807'0605u);
+    d.log_by_args(0x0c0b'0a09u);
+    CHECK(b.transport().frames.empty());
+
+    d.log_by_args(0x100f'0e0du, 0x1413'1211u);
+    REQUIRE(b.transport().frames.size() == 1);
+    CHECK(b.transport().frames[0] ==
+          std::vector<std::uint8_t>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12});
+    CHECK(b.num_frames() == 1);
+
+    b.flush();
+    REQUIRE(b.transport().frames.size() == 2);
+    CHECK(b.transport().frames[1] ==
+          std::vector<std::uint8_t>{13, 14, 15, 16, 17, 18, 19, 20});
+}
+
+TEST_CASE("a full frame is written on the next record", "[frame_batcher]") {
+    auto b = batcher_t{};
+    auto d = b.destination();
+    d.log_by_args(1u, 2u, 3u, 4u);
+    CHECK(b.transport().frames.empty());
+    d.log_by_args(5u);
+    REQUIRE(b.transport().frames.size() == 1);
+    CHECK(b.transport().frames[0].size() == 16);
+}
+
+TEST_CASE("buffers are batched", "[frame_batcher]") {
+    auto b = batcher_t{};
+    auto d = b.destination();
+    auto const buf = std::array<std::uint8_t, 5>{1, 2, 3, 4, 5};
+    d.log_by_buf(stdx::span<std::uint8_t const, 5>{buf});
+    d.log_by_buf(stdx::span<std::uint8_t const>{buf});
+    b.flush();
+    REQUIRE(b.transport().frames.size() == 1);
+    CHECK(b.transport().frames[0] ==
+          std::vector<std::uint8_t>{1, 2, 3, 4, 5, 1, 2, 3, 4, 5});
+}
+
+TEST_CASE("large records are written alone", "[frame_batcher]") {
+    auto b = batcher_t{};
+    auto d = b.destination();
+    auto const buf = std::array<std::uint8_t, 20>{};
+    d.log_by_args(1u);
+    d.log_by_buf(stdx::span<std::uint8_t const>{buf});
+    REQUIRE(b.transport().frames.size() == 2);
+    CHECK(b.transport().frames[0].size() == 4);
+    CHECK(b.transport().frames[1].size() == 20);
+}
+
+TEST_CASE("flushing an empty batcher writes nothing", "[frame_batcher]") {
+    auto b = batcher_t{};
+    b.flush();
+    CHECK(b.transport().frames.empty());
+}
+
+TEST_CASE("the batcher takes its own critical section", "[frame_batcher]") {
+    auto b = batcher_t{};
+    num_critical_sections = 0;
+    b.destination().log_by_args(1u);
+    b.flush();
+    CHECK(num_critical_sections == 2);
+}
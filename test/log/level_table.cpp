@@ -0,0 +1,139 @@
+#include <log/catalog/encoder.hpp>
+#include <log/catalog/level_table.hpp>
+
+#include <stdx/concepts.hpp>
+#include <stdx/ct_format.hpp>
+
+#include <conc/concurrency.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr module_id test_module_id = 5u;
+} // namespace
+
+template <typename StringType> auto catalog() -> string_id { return 42u; }
+
+template <typename StringType> auto module() -> module_id {
+    return test_module_id;
+}
+
+namespace {
+struct test_conc_policy {
+    template <typename = void, stdx::invocable F, stdx::predicate... Pred>
+        requires(sizeof...(Pred) < 2)
+    static inline auto call_in_critical_section(F &&f, Pred &&...)
+        -> decltype(std::forward<F>(f)()) {
+        return std::forward<F>(f)();
+    }
+};
+
+std::vector<std::uint32_t> logged_headers{};
+
+struct test_destination {
+    template <typename... Args>
+    auto log_by_args(std::uint32_t header, Args...) -> void {
+        logged_headers.push_back(header);
+    }
+};
+
+struct runtime_flavor_t;
+struct floor_flavor_t;
+
+using table_t = logging::binary::level_table<8>;
+
+template <logging::level L, typename Flavor>
+using log_env =
+    stdx::make_env_t<logging::get_level, L, logging::get_flavor,
+                     stdx::type_identity<Flavor>{}>;
+} // namespace
+
+template <> inline auto conc::injected_policy<> = test_conc_policy{};
+
+template <> inline auto logging::binary::levels<runtime_flavor_t> = table_t{};
+template <>
+inline auto logging::binary::levels<floor_flavor_t> =
+    logging::binary::level_table<8, logging::level::INFO>{};
+
+TEST_CASE("level table defaults to its floor", "[level_table]") {
+    auto const t = logging::binary::level_table<8, logging::level::WARN>{};
+    CHECK(t.get(0) == logging::level::WARN);
+    CHECK(t.enabled(0, logging::level::ERROR));
+    CHECK(t.enabled(0, logging::level::WARN));
+    CHECK(not t.enabled(0, logging::level::INFO));
+}
+
+TEST_CASE("levels are set per module", "[level_table]") {
+    auto t = table_t{};
+    t.set(3, logging::level::ERROR);
+    CHECK(t.get(3) == logging::level::ERROR);
+    CHECK(t.get(2) == logging::level::TRACE);
+    CHECK(not t.enabled(3, logging::level::INFO));
+
+    t.set_all(logging::level::INFO);
+    CHECK(t.get(3) == logging::level::INFO);
+    CHECK(t.get(2) == logging::level::INFO);
+}
+
+TEST_CASE("modules beyond the table share a level", "[level_table]") {
+    auto t = table_t{};
+    t.set(100, logging::level::WARN);
+    CHECK(t.get(8) == logging::level::WARN);
+    CHECK(t.get(200) == logging::level::WARN);
+    CHECK(t.get(7) == logging::level::TRACE);
+}
+
+TEST_CASE("levels are set from a control message", "[level_table]") {
+    using namespace msg;
+    using control_t = owning<logging::binary::defn::level_control_msg_t>;
+    auto t = table_t{};
+
+    t.handle(control_t{"module_id"_field = 3,
+                       "level"_field = logging::level::ERROR}
+                 .as_const_view());
+    CHECK(t.get(3) == logging::level::ERROR);
+    CHECK(t.get(2) == logging::level::TRACE);
+
+    t.handle(control_t{"all_modules"_field = true,
+                       "level"_field = logging::level::WARN}
+                 .as_const_view());
+    CHECK(t.get(3) == logging::level::WARN);
+    CHECK(t.get(2) == logging::level::WARN);
+}
+
+TEST_CASE("runtime levels filter log calls", "[level_table]") {
+    auto &t = logging::binary::levels<runtime_flavor_t>;
+    auto cfg = logging::binary::config{test_destination{}};
+    logged_headers.clear();
+
+    t.set(test_module_id, logging::level::WARN);
+    cfg.logger.log_msg<log_env<logging::level::INFO, runtime_flavor_t>>(
+        stdx::ct_format<"Hello {}">(17));
+    CHECK(logged_headers.empty());
+    cfg.logger.log_msg<log_env<logging::level::ERROR, runtime_flavor_t>>(
+        stdx::ct_format<"Hello {}">(17));
+    CHECK(logged_headers.size() == 1);
+
+    t.set(test_module_id, logging::level::TRACE);
+    cfg.logger.log_msg<log_env<logging::level::INFO, runtime_flavor_t>>(
+        stdx::ct_format<"Hello {}">(17));
+    CHECK(logged_headers.size() == 2);
+}
+
+TEST_CASE("calls below the floor are not logged", "[level_table]") {
+    auto &t = logging::binary::levels<floor_flavor_t>;
+    auto cfg = logging::binary::config{test_destination{}};
+    logged_headers.clear();
+
+    t.set_all(logging::level::TRACE);
+    cfg.logger.log_msg<log_env<logging::level::TRACE, floor_flavor_t>>(
+        stdx::ct_format<"Hello {}">(17));
+    CHECK(logged_headers.empty());
+    cfg.logger.log_msg<log_env<logging::level::INFO, floor_flavor_t>>(
+        stdx::ct_format<"Hello {}">(17));
+    CHECK(logged_headers.size() == 1);
+}
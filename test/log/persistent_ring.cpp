@@ -0,0 +1,192 @@
+#include <log/persistent_ring.hpp>
+
+#include <stdx/ct_string.hpp>
+#include <stdx/panic.hpp>
+#include <stdx/span.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+using ring_t = logging::persistent_ring<16>;
+constexpr auto num_slots = std::size_t{4};
+
+struct memory_t {
+    alignas(8) std::array<std::byte, ring_t::bytes_for(num_slots)> bytes{};
+};
+
+struct slot_view {
+    std::uint64_t seq;
+    std::uint16_t size;
+    std::uint8_t kind;
+    std::vector<std::uint8_t> data;
+};
+
+auto read_slot(memory_t const &m, std::size_t i) -> slot_view {
+    auto const p =
+        m.bytes.data() + ring_t::header_bytes + i * ring_t::slot_bytes;
+    auto v = slot_view{};
+    std::memcpy(&v.seq, p, sizeof(v.seq));
+    std::memcpy(&v.size, p + 8, sizeof(v.size));
+    std::memcpy(&v.kind, p + 10, sizeof(v.kind));
+    auto const data =
+        reinterpret_cast<std::uint8_t const *>(p + ring_t::slot_header_bytes);
+    v.data.assign(data, data + v.size);
+    return v;
+}
+
+template <typename T> auto read_header(memory_t const &m, std::size_t offset) {
+    auto v = T{};
+    std::memcpy(&v, m.bytes.data() + offset, sizeof(T));
+    return v;
+}
+
+int panics{};
+
+struct test_panic_handler {
+    template <stdx::ct_string, typename... Ts>
+    static auto panic(Ts &&...) -> void {
+        ++panics;
+    }
+};
+} // namespace
+
+template <> inline auto stdx::panic_handler<> = test_panic_handler{};
+
+TEST_CASE("a new buffer is formatted", "[persistent_ring]") {
+    auto m = memory_t{};
+    auto r = ring_t{m.bytes.data(), m.bytes.size()};
+    CHECK(r.capacity() == num_slots);
+    CHECK(r.head() == 0);
+    CHECK(read_header<std::uint32_t>(m, 0) == ring_t::magic);
+    CHECK(read_header<std::uint32_t>(m, 8) == num_slots);
+    CHECK(read_header<std::uint32_t>(m, 12) == ring_t::slot_bytes);
+}
+
+TEST_CASE("records are written to slots", "[persistent_ring]") {
+    auto m = memory_t{};
+    auto r = ring_t{m.bytes.data(), m.bytes.size()};
+    r.destination().log_by_args(0x0403'0201u, 0x0807'0605u);
+
+    auto const s = read_slot(m, 0);
+    CHECK(s.seq == 1);
+    CHECK(s.kind == 0);
+    CHECK(s.data == std::vector<std::uint8_t>{1, 2, 3, 4, 5, 6, 7, 8});
+    CHECK(r.head() == 1);
+}
+
+TEST_CASE("the buffer wraps", "[persistent_ring]") {
+    auto m = memory_t{};
+    auto r = ring_t{m.bytes.data(), m.bytes.size()};
+    for (auto i = 0u; i < 6; ++i) {
+        r.destination().log_by_args(i);
+    }
+    CHECK(read_slot(m, 0).seq == 5);
+    CHECK(read_slot(m, 0).data == std::vector<std::uint8_t>{4, 0, 0, 0});
+    CHECK(read_slot(m, 1).seq == 6);
+    CHECK(read_slot(m, 2).seq == 3);
+}
+
+TEST_CASE("logging carries on in an existing buffer", "[persistent_ring]") {
+    auto m = memory_t{};
+    {
+        auto r = ring_t{m.bytes.data(), m.bytes.size()};
+        r.destination().log_by_args(1u);
+        r.destination().log_by_args(2u);
+    }
+    auto r = ring_t{m.bytes.data(), m.bytes.size()};
+    CHECK(r.head() == 2);
+    r.destination().log_by_args(3u);
+    CHECK(read_slot(m, 0).data == std::vector<std::uint8_t>{1, 0, 0, 0});
+    CHECK(read_slot(m, 2).seq == 3);
+}
+
+TEST_CASE("records that are too large are dropped", "[persistent_ring]") {
+    auto m = memory_t{};
+    auto r = ring_t{m.bytes.data(), m.bytes.size()};
+    auto const buf = std::array<std::uint8_t, 17>{};
+    r.destination().log_by_buf(stdx::span<std::uint8_t const>{buf});
+    CHECK(r.num_dropped() == 1);
+    CHECK(r.head() == 0);
+}
+
+TEST_CASE("memory too small for one slot is rejected", "[persistent_ring]") {
+    panics = 0;
+    auto m = memory_t{};
+    m.bytes[0] = std::byte{0xa5};
+    auto r = ring_t{m.bytes.data(), ring_t::bytes_for(1) - 1};
+    CHECK(panics == 1);
+    CHECK(r.capacity() == 0);
+    CHECK(m.bytes[0] == std::byte{0xa5});
+
+    r.destination().log_by_args(1u);
+    CHECK(r.num_dropped() == 1);
+    CHECK(r.head() == 0);
+}
+
+TEST_CASE("misaligned memory is rejected", "[persistent_ring]") {
+    panics = 0;
+    auto m = memory_t{};
+    auto r = ring_t{m.bytes.data() + 4, m.bytes.size() - 4};
+    CHECK(panics == 1);
+    CHECK(r.capacity() == 0);
+}
+
+TEST_CASE("text is stored a line at a time", "[persistent_ring]") {
+    auto m = memory_t{};
+    auto r = ring_t{m.bytes.data(), m.bytes.size()};
+    auto sink = ring_t::text_sink{r};
+    constexpr auto text =
+        std::string_view{"hello\nthis line is too long\n"};
+    std::copy(std::cbegin(text), std::cend(text), sink.begin());
+
+    auto const s0 = read_slot(m, 0);
+    CHECK(s0.kind == 1);
+    CHECK(std::string_view{reinterpret_cast<char const *>(s0.data.data()),
+                           s0.data.size()} == "hello");
+    auto const s1 = read_slot(m, 1);
+    CHECK(std::string_view{reinterpret_cast<char const *>(s1.data.data()),
+                           s1.data.size()} == "this line is too");
+}
+
+TEST_CASE("concurrent writers use distinct slots", "[persistent_ring]") {
+    using big_ring_t = logging::persistent_ring<8>;
+    constexpr auto per_thread = 1000u;
+    auto memory = std::vector<std::uint64_t>(
+        big_ring_t::bytes_for(4 * per_thread) / sizeof(std::uint64_t));
+    auto r = big_ring_t{memory.data(), memory.size() * sizeof(std::uint64_t)};
+
+    auto threads = std::vector<std::thread>{};
+    for (auto t = 0u; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (auto i = 0u; i < per_thread; ++i) {
+                r.destination().log_by_args(t, i);
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+    CHECK(r.head() == 4 * per_thread);
+
+    auto seen = std::vector<bool>(4 * per_thread);
+    auto const base = reinterpret_cast<std::byte const *>(memory.data());
+    for (auto i = 0u; i < 4 * per_thread; ++i) {
+        auto seq = std::uint64_t{};
+        std::memcpy(&seq,
+                    base + big_ring_t::header_bytes +
+                        i * big_ring_t::slot_bytes,
+                    sizeof(seq));
+        REQUIRE(seq == i + 1);
+        seen[seq - 1] = true;
+    }
+    CHECK(std::all_of(seen.begin(), seen.end(), [](bool b) { return b; }));
+}
@@ -0,0 +1,115 @@
+#include <log/level.hpp>
+#include <log/log.hpp>
+#include <log/rate_limit.hpp>
+
+#include <stdx/ct_string.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace {
+struct logged_record {
+    std::string msg;
+    logging::level level;
+    std::uint32_t suppressed;
+};
+
+auto records = std::vector<logged_record>{};
+
+struct log_handler {
+    template <typename Env, typename FilenameStringType,
+              typename LineNumberType, typename MsgType>
+    auto log(FilenameStringType, LineNumberType, MsgType const &m) -> void {
+        auto suppressed = std::uint32_t{};
+        m.args.apply([&](auto... args) {
+            ((suppressed = static_cast<std::uint32_t>(args)), ...);
+        });
+        records.push_back({std::string{std::string_view{
+                               decltype(m.str)::value}},
+                           logging::get_level(Env{}), suppressed});
+    }
+};
+
+struct log_config {
+    log_handler logger;
+};
+
+std::uint64_t fake_time{};
+struct test_clock {
+    auto operator()() const -> std::uint64_t { return fake_time; }
+};
+
+auto count(std::string_view msg) {
+    return std::count_if(std::cbegin(records), std::cend(records),
+                         [&](auto const &r) { return r.msg == msg; });
+}
+} // namespace
+
+template <> inline auto logging::config<> = log_config{};
+
+TEST_CASE("log calls are not rate limited by default", "[rate_limit]") {
+    STATIC_REQUIRE(std::is_same_v<decltype(logging::get_rate_limit(
+                                      cib_log_env_t{})),
+                                  logging::rate_limit::unlimited>);
+    records.clear();
+    for (auto i = 0; i < 10; ++i) {
+        CIB_INFO("tick");
+    }
+    CHECK(records.size() == 10);
+}
+
+TEST_CASE("one_in samples a call site", "[rate_limit]") {
+    CIB_LOG_RATE_LIMIT(logging::rate_limit::one_in<4, 2>{});
+    records.clear();
+    for (auto i = 0; i < 20; ++i) {
+        CIB_INFO("tick");
+    }
+    CHECK(count("tick") == 5);
+    REQUIRE(count("{} records suppressed by rate limit") == 2);
+    CHECK(records[3].suppressed == 6);
+    CHECK(records[3].level == logging::level::INFO);
+}
+
+TEST_CASE("call sites are limited separately", "[rate_limit]") {
+    CIB_LOG_RATE_LIMIT(logging::rate_limit::one_in<2>{});
+    records.clear();
+    for (auto i = 0; i < 4; ++i) {
+        CIB_INFO("tick");
+        CIB_INFO("tock");
+    }
+    CHECK(count("tick") == 2);
+    CHECK(count("tock") == 2);
+}
+
+TEST_CASE("token_bucket allows bursts then refills", "[rate_limit]") {
+    CIB_LOG_RATE_LIMIT(logging::rate_limit::token_bucket<2, 10, test_clock>{});
+    records.clear();
+    fake_time = 0;
+
+    auto const log_n = [](int n) {
+        for (auto i = 0; i < n; ++i) {
+            CIB_INFO("tick");
+        }
+    };
+
+    log_n(5);
+    CHECK(records.size() == 2);
+
+    fake_time = 10;
+    log_n(2);
+    REQUIRE(records.size() == 4);
+    CHECK(records[2].msg == "tick");
+    CHECK(records[3].msg == "{} records suppressed by rate limit");
+    CHECK(records[3].suppressed == 3);
+
+    fake_time = 100;
+    log_n(1);
+    REQUIRE(records.size() == 6);
+    CHECK(records[5].suppressed == 1);
+}
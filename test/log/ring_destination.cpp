@@ -0,0 +1,176 @@
+#include <log/catalog/encoder.hpp>
+#include <log/catalog/ring_destination.hpp>
+
+#include <stdx/concepts.hpp>
+#include <stdx/ct_format.hpp>
+#include <stdx/span.hpp>
+
+#include <conc/concurrency.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr string_id test_string_id = 42u;
+constexpr module_id test_module_id = 17u;
+} // namespace
+
+template <typename StringType> auto catalog() -> string_id {
+    return test_string_id;
+}
+
+template <typename StringType> auto module() -> module_id {
+    return test_module_id;
+}
+
+namespace {
+int num_critical_sections{};
+
+struct test_conc_policy {
+    template <typename = void, stdx::invocable F, stdx::predicate... Pred>
+        requires(sizeof...(Pred) < 2)
+    static inline auto call_in_critical_section(F &&f, Pred &&...)
+        -> decltype(std::forward<F>(f)()) {
+        ++num_critical_sections;
+        return std::forward<F>(f)();
+    }
+};
+
+std::uint64_t fake_time{};
+struct test_timestamp {
+    auto operator()() const -> std::uint64_t { return fake_time; }
+};
+
+std::size_t current_core{};
+struct test_ring_index {
+    auto operator()() const -> std::size_t { return current_core; }
+};
+
+using rings_t =
+    logging::binary::per_core_rings<4, 8, 32, test_ring_index, test_timestamp>;
+
+struct test_transport {
+    std::vector<std::uint32_t> headers{};
+    std::vector<std::size_t> buf_sizes{};
+
+    template <typename... Args>
+    auto log_by_args(std::uint32_t header, Args...) -> void {
+        headers.push_back(header);
+    }
+    auto log_by_buf(stdx::span<std::uint8_t const> data) -> void {
+        buf_sizes.push_back(data.size());
+    }
+};
+
+auto log_at(rings_t &rings, std::size_t core, std::uint64_t time,
+            std::uint32_t header) -> void {
+    current_core = core;
+    fake_time = time;
+    rings.destination().log_by_args(header, 0u);
+}
+
+using log_env = stdx::make_env_t<logging::get_level, logging::level::TRACE>;
+} // namespace
+
+template <> inline auto conc::injected_policy<> = test_conc_policy{};
+
+TEST_CASE("records are drained to the transport", "[ring_destination]") {
+    static auto rings = rings_t{};
+    log_at(rings, 0, 1, 17);
+
+    auto t = test_transport{};
+    CHECK(rings.drain(t) == 1);
+    CHECK(t.headers == std::vector<std::uint32_t>{17});
+    CHECK(rings.drain(t) == 0);
+}
+
+TEST_CASE("rings are merged in timestamp order", "[ring_destination]") {
+    static auto rings = rings_t{};
+    log_at(rings, 1, 5, 5);
+    log_at(rings, 0, 7, 7);
+    log_at(rings, 2, 1, 1);
+    log_at(rings, 1, 6, 6);
+
+    auto t = test_transport{};
+    CHECK(rings.drain(t) == 4);
+    CHECK(t.headers == std::vector<std::uint32_t>{1, 5, 6, 7});
+}
+
+TEST_CASE("buffer records are drained as buffers", "[ring_destination]") {
+    static auto rings = rings_t{};
+    auto const buf = std::array<std::uint8_t, 5>{1, 2, 3, 4, 5};
+    rings.destination().log_by_buf(stdx::span<std::uint8_t const, 5>{buf});
+
+    auto t = test_transport{};
+    CHECK(rings.drain(t) == 1);
+    CHECK(t.buf_sizes == std::vector<std::size_t>{5});
+}
+
+TEST_CASE("oversized variable-length records are dropped",
+          "[ring_destination]") {
+    static auto rings = rings_t{};
+    auto const buf = std::array<std::uint8_t, 40>{};
+    rings.destination().log_by_buf(stdx::span<std::uint8_t const>{buf});
+    rings.destination().log_by_buf(
+        stdx::span<std::uint8_t const>{buf.data(), 9});
+    CHECK(rings.num_dropped() == 1);
+
+    auto t = test_transport{};
+    CHECK(rings.drain(t) == 1);
+    CHECK(t.buf_sizes == std::vector<std::size_t>{9});
+}
+
+TEST_CASE("full rings drop records", "[ring_destination]") {
+    static auto rings = rings_t{};
+    for (auto i = 0u; i < 10; ++i) {
+        log_at(rings, 3, i, i);
+    }
+    CHECK(rings.num_dropped() == 2);
+
+    auto t = test_transport{};
+    CHECK(rings.drain(t) == 8);
+}
+
+namespace {
+// logs another record each time it is written to, as a busy producer would
+struct refilling_transport {
+    rings_t *rings;
+    std::size_t written{};
+
+    template <typename... Args>
+    auto log_by_args(std::uint32_t header, Args...) -> void {
+        ++written;
+        log_at(*rings, 0, 100 + written, header);
+    }
+    auto log_by_buf(stdx::span<std::uint8_t const>) -> void {}
+};
+} // namespace
+
+TEST_CASE("drain writes only the records present on entry",
+          "[ring_destination]") {
+    static auto rings = rings_t{};
+    log_at(rings, 0, 1, 1);
+    log_at(rings, 1, 2, 2);
+
+    auto t = refilling_transport{&rings};
+    CHECK(rings.drain(t) == 2);
+    CHECK(rings.drain(t) == 2);
+}
+
+TEST_CASE("logging to rings takes no critical section", "[ring_destination]") {
+    CIB_LOG_ENV(logging::get_level, logging::level::TRACE);
+    static auto rings = rings_t{};
+    num_critical_sections = 0;
+
+    auto cfg = logging::binary::config{rings.destination()};
+    cfg.logger.log_msg<log_env>(stdx::ct_format<"{}">(17u));
+    CHECK(num_critical_sections == 0);
+
+    auto t = test_transport{};
+    CHECK(rings.drain(t) == 1);
+}
@@ -0,0 +1,114 @@
+#include <log/catalog/timestamp.hpp>
+
+#include <stdx/span.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+std::uint64_t fake_time{};
+struct test_timestamp {
+    auto operator()() const -> std::uint64_t { return fake_time; }
+};
+
+std::vector<std::uint32_t> logged_args{};
+std::vector<std::uint8_t> logged_buf{};
+
+struct test_transport {
+    template <typename... Args>
+    auto log_by_args(std::uint32_t header, Args... args) -> void {
+        logged_args = {header, static_cast<std::uint32_t>(args)...};
+    }
+
+    template <std::size_t N>
+    auto log_by_buf(stdx::span<std::uint8_t const, N> data) -> void {
+        logged_buf.assign(data.begin(), data.end());
+    }
+};
+
+using timestamped_t =
+    logging::binary::timestamped<test_transport, test_timestamp, 16>;
+
+// catalog, module 0x11, severity 4
+constexpr auto catalog_header = std::uint32_t{0x0111'0043u};
+// short32
+constexpr auto short32_header = std::uint32_t{0x0000'0421u};
+// the same header, with the delta subtype in place of subtype 1
+constexpr auto delta_header = std::uint32_t{0x3f11'0043u};
+} // namespace
+
+TEST_CASE("catalog messages get a time delta", "[timestamp]") {
+    auto d = timestamped_t{test_transport{}};
+    fake_time = 100;
+    d.log_by_args(catalog_header, 42u, 17u);
+    CHECK(logged_args ==
+          std::vector<std::uint32_t>{delta_header, 100, 42, 17});
+
+    fake_time = 130;
+    d.log_by_args(catalog_header, 42u);
+    CHECK(logged_args == std::vector<std::uint32_t>{delta_header, 30, 42});
+}
+
+TEST_CASE("large deltas saturate", "[timestamp]") {
+    auto d = timestamped_t{test_transport{}};
+    fake_time = std::uint64_t{1} << 40u;
+    d.log_by_args(catalog_header, 42u);
+    CHECK(logged_args ==
+          std::vector<std::uint32_t>{delta_header, 0xffff'ffffu, 42});
+}
+
+TEST_CASE("other messages are not timestamped", "[timestamp]") {
+    auto d = timestamped_t{test_transport{}};
+    d.log_by_args(short32_header);
+    CHECK(logged_args == std::vector<std::uint32_t>{short32_header});
+}
+
+TEST_CASE("buffers get a time delta after the header", "[timestamp]") {
+    auto d = timestamped_t{test_transport{}};
+    fake_time = 0;
+    d.log_by_args(catalog_header, 1u);
+    fake_time = 7;
+
+    auto const buf =
+        std::array<std::uint8_t, 9>{0x43, 0x00, 0x11, 0x01, 42, 0, 0, 0, 5};
+    d.log_by_buf(stdx::span<std::uint8_t const, 9>{buf});
+    CHECK(logged_buf == std::vector<std::uint8_t>{0x43, 0x00, 0x11, 0x3f, 7, 0,
+                                                  0, 0, 42, 0, 0, 0, 5});
+
+    fake_time = 9;
+    d.log_by_buf(stdx::span<std::uint8_t const>{buf});
+    CHECK(logged_buf == std::vector<std::uint8_t>{0x43, 0x00, 0x11, 0x3f, 2, 0,
+                                                  0, 0, 42, 0, 0, 0, 5});
+}
+
+TEST_CASE("varint messages keep their subtype's meaning", "[timestamp]") {
+    auto d = timestamped_t{test_transport{}};
+    fake_time = 0;
+    d.log_by_args(catalog_header, 1u);
+    fake_time = 3;
+
+    auto const buf =
+        std::array<std::uint8_t, 9>{0x43, 0x00, 0x11, 0x3e, 42, 0, 0, 0, 5};
+    d.log_by_buf(stdx::span<std::uint8_t const>{buf});
+    CHECK(logged_buf == std::vector<std::uint8_t>{0x43, 0x00, 0x11, 0x3d, 3, 0,
+                                                  0, 0, 42, 0, 0, 0, 5});
+}
+
+TEST_CASE("variable-length buffers that would be too large are passed through",
+          "[timestamp]") {
+    auto d = timestamped_t{test_transport{}};
+    auto buf = std::array<std::uint8_t, 14>{0x43, 0x00, 0x11, 0x01};
+    d.log_by_buf(stdx::span<std::uint8_t const>{buf});
+    CHECK(logged_buf == std::vector<std::uint8_t>(buf.begin(), buf.end()));
+}
+
+TEST_CASE("the header's Sys-T timestamp bit stays clear", "[timestamp]") {
+    auto d = timestamped_t{test_transport{}};
+    d.log_by_args(catalog_header, 42u);
+    REQUIRE(not logged_args.empty());
+    CHECK((logged_args[0] & (1u << 11u)) == 0);
+}
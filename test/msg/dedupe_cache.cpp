@@ -0,0 +1,64 @@
+#include <msg/dedupe_cache.hpp>
+#include <msg/field.hpp>
+#include <msg/message.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace {
+using namespace msg;
+
+using conn_f = field<"conn", std::uint32_t>::located<at{0_dw, 15_msb, 0_lsb}>;
+using seq_f = field<"seq", std::uint32_t>::located<at{1_dw, 31_msb, 0_lsb}>;
+
+using msg_defn = message<"msg", conn_f, seq_f>;
+using msg_t = owning<msg_defn>;
+} // namespace
+
+TEST_CASE("first sighting of a message is new", "[dedupe_cache]") {
+    auto cache = dedupe_cache<msg_defn, 16>{};
+    CHECK(cache.insert(msg_t{"conn"_f = 1, "seq"_f = 2}));
+    CHECK(cache.contains(msg_t{"conn"_f = 1, "seq"_f = 2}));
+}
+
+TEST_CASE("repeated message is a duplicate", "[dedupe_cache]") {
+    auto cache = dedupe_cache<msg_defn, 16>{};
+    CHECK(cache.insert(msg_t{"conn"_f = 1, "seq"_f = 2}));
+    CHECK(not cache.insert(msg_t{"conn"_f = 1, "seq"_f = 2}));
+    CHECK(cache.insert(msg_t{"conn"_f = 1, "seq"_f = 3}));
+}
+
+TEST_CASE("equivalent messages are duplicates", "[dedupe_cache]") {
+    auto cache = dedupe_cache<msg_defn, 16>{};
+    auto const a1 = std::array{0x0000'0001u, 0x0000'0002u};
+    auto const a2 = std::array{0xffff'0001u, 0x0000'0002u};
+    CHECK(cache.insert(const_view<msg_defn>{a1}));
+    CHECK(not cache.insert(const_view<msg_defn>{a2}));
+}
+
+TEST_CASE("oldest messages are forgotten", "[dedupe_cache]") {
+    auto cache = dedupe_cache<msg_defn, 1, 1>{};
+    CHECK(cache.insert(msg_t{"conn"_f = 1, "seq"_f = 1}));
+    CHECK(cache.insert(msg_t{"conn"_f = 1, "seq"_f = 2}));
+    CHECK(not cache.contains(msg_t{"conn"_f = 1, "seq"_f = 1}));
+    CHECK(cache.insert(msg_t{"conn"_f = 1, "seq"_f = 1}));
+}
+
+TEST_CASE("clear forgets all messages", "[dedupe_cache]") {
+    auto cache = dedupe_cache<msg_defn, 16>{};
+    CHECK(cache.insert(msg_t{"conn"_f = 1, "seq"_f = 2}));
+    cache.clear();
+    CHECK(not cache.contains(msg_t{"conn"_f = 1, "seq"_f = 2}));
+}
+
+TEST_CASE("dedupe cache is usable at compile time", "[dedupe_cache]") {
+    constexpr auto result = [] {
+        auto cache = dedupe_cache<msg_defn, 4>{};
+        auto const first = cache.insert(msg_t{"conn"_f = 1, "seq"_f = 2});
+        auto const second = cache.insert(msg_t{"conn"_f = 1, "seq"_f = 2});
+        return first and not second;
+    }();
+    STATIC_REQUIRE(result);
+}
@@ -0,0 +1,107 @@
+#include <msg/field.hpp>
+#include <msg/layout.hpp>
+#include <msg/message.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace {
+using namespace msg;
+
+using id_field = field<"id", std::uint32_t>::located<at{0_dw, 31_msb, 24_lsb}>;
+using field1 = field<"f1", std::uint32_t>::located<at{0_dw, 15_msb, 0_lsb}>;
+using straddler =
+    field<"s", std::uint32_t>::located<at{1_dw, 7_msb, 0_lsb},
+                                       at{0_dw, 31_msb, 28_lsb}>;
+using wide = field<"w", std::uint64_t>::located<at{1_dw, 47_msb, 16_lsb}>;
+
+using auto_f32 = field<"a32", std::uint32_t>;
+using auto_f16 = field<"a16", std::uint16_t>;
+using auto_f8 = field<"a8", std::uint8_t>;
+using auto_f64 = field<"a64", std::uint64_t>;
+} // namespace
+
+TEST_CASE("layout of a message without padding", "[layout]") {
+    using defn = message<"msg", field1,
+                         field<"f2", std::uint32_t>::located<at{
+                             0_dw, 31_msb, 16_lsb}>>;
+    constexpr auto l = analyze_layout<defn>();
+    STATIC_REQUIRE(l.storage_bits == 32);
+    STATIC_REQUIRE(l.used_bits == 32);
+    STATIC_REQUIRE(l.padding_bits == 0);
+    STATIC_REQUIRE(l.num_straddles == 0);
+    STATIC_REQUIRE(l.extraction_cost == 2);
+}
+
+TEST_CASE("layout reports padding", "[layout]") {
+    using defn = message<"msg", id_field, field1>;
+    constexpr auto l = analyze_layout<defn>();
+    STATIC_REQUIRE(l.storage_bits == 32);
+    STATIC_REQUIRE(l.used_bits == 24);
+    STATIC_REQUIRE(l.padding_bits == 8);
+}
+
+TEST_CASE("layout reports fields in definition order", "[layout]") {
+    using defn = message<"msg", id_field, field1>;
+    constexpr auto l = analyze_layout<defn>();
+    STATIC_REQUIRE(l.fields[0].name == std::string_view{"f1"});
+    STATIC_REQUIRE(l.fields[0].bits == 16);
+    STATIC_REQUIRE(l.fields[1].name == std::string_view{"id"});
+    STATIC_REQUIRE(l.fields[1].bits == 8);
+}
+
+TEST_CASE("layout reports straddling fields", "[layout]") {
+    using defn = message<"msg", straddler, wide>;
+    constexpr auto l = analyze_layout<defn>();
+    STATIC_REQUIRE(l.num_straddles == 1);
+    STATIC_REQUIRE(l.fields[0].name == std::string_view{"s"});
+    STATIC_REQUIRE(l.fields[0].pieces == 2);
+    STATIC_REQUIRE(l.fields[0].words_read == 2);
+    STATIC_REQUIRE(not l.fields[0].straddles);
+    STATIC_REQUIRE(l.fields[1].name == std::string_view{"w"});
+    STATIC_REQUIRE(l.fields[1].words_read == 2);
+    STATIC_REQUIRE(l.fields[1].straddles);
+}
+
+TEST_CASE("auto layout packs fields largest first", "[layout]") {
+    using defn = auto_layout<"msg", auto_f8, auto_f32, auto_f16>;
+    using expected_defn =
+        message<"msg", auto_f32::located<at{0_dw, 31_msb, 0_lsb}>,
+                auto_f16::located<at{1_dw, 15_msb, 0_lsb}>,
+                auto_f8::located<at{1_dw, 23_msb, 16_lsb}>>;
+    STATIC_REQUIRE(std::is_same_v<defn, expected_defn>);
+}
+
+TEST_CASE("auto layout fills gaps around located fields", "[layout]") {
+    using defn = auto_layout<"msg", auto_f8, id_field, auto_f16>;
+    using expected_defn =
+        message<"msg", id_field, auto_f16::located<at{0_dw, 15_msb, 0_lsb}>,
+                auto_f8::located<at{0_dw, 23_msb, 16_lsb}>>;
+    STATIC_REQUIRE(std::is_same_v<defn, expected_defn>);
+    STATIC_REQUIRE(analyze_layout<defn>().padding_bits == 0);
+}
+
+TEST_CASE("auto layout avoids straddles", "[layout]") {
+    using defn =
+        auto_layout<"msg", field<"b16", std::uint16_t>, auto_f8, auto_f16,
+                    field<"b8", std::uint8_t>, auto_f32, auto_f64>;
+    constexpr auto l = analyze_layout<defn>();
+    STATIC_REQUIRE(l.num_straddles == 0);
+}
+
+TEST_CASE("auto layout places wide fields on word boundaries", "[layout]") {
+    using defn = auto_layout<"msg", auto_f8, auto_f64>;
+    constexpr auto l = analyze_layout<defn>();
+    STATIC_REQUIRE(l.storage_bits == 96);
+    STATIC_REQUIRE(l.num_straddles == 0);
+}
+
+TEST_CASE("auto layout shrinks a relaxed message", "[layout]") {
+    using relaxed = relaxed_message<"msg", id_field, auto_f16, auto_f8>;
+    using packed = auto_layout<"msg", id_field, auto_f16, auto_f8>;
+    STATIC_REQUIRE(packed::size<std::uint8_t>::value <
+                   relaxed::size<std::uint8_t>::value);
+}
@@ -511,6 +511,36 @@ TEST_CASE("message equivalence (views)", "[message]") {
     CHECK(not equivalent(cv1, cv2));
 }
 
+TEST_CASE("message equivalence ignores bits outside fields", "[message]") {
+    auto const a1 = std::array{0x8000'ba11u, 0x0042'd00du};
+    auto const a2 = std::array{0x80ff'ba11u, 0xff42'd00du};
+    auto const a3 = std::array{0x8000'ba11u, 0x0043'd00du};
+    auto const cv1 = const_view<msg_defn>{a1};
+    CHECK(equivalent(cv1, const_view<msg_defn>{a2}));
+    CHECK(not equivalent(cv1, const_view<msg_defn>{a3}));
+}
+
+TEST_CASE("message hash", "[message]") {
+    test_msg m1{"f1"_field = 0xba11, "f2"_field = 0x42, "f3"_field = 0xd00d};
+    test_msg m2{"f1"_field = 0xba11, "f2"_field = 0x42, "f3"_field = 0xd00d};
+    test_msg other{"f1"_field = 0xba11, "f2"_field = 0x42, "f3"_field = 0xd00f};
+    CHECK(msg::hash(m1) == msg::hash(m2));
+    CHECK(msg::hash(m1) == msg::hash(m1.as_const_view()));
+    CHECK(msg::hash(m1) != msg::hash(other));
+}
+
+TEST_CASE("message hash ignores bits outside fields", "[message]") {
+    auto const a1 = std::array{0x8000'ba11u, 0x0042'd00du};
+    auto const a2 = std::array{0x80ff'ba11u, 0xff42'd00du};
+    CHECK(msg::hash(const_view<msg_defn>{a1}) ==
+          msg::hash(const_view<msg_defn>{a2}));
+}
+
+TEST_CASE("message hash is constexpr", "[message]") {
+    constexpr auto h = msg::hash(test_msg{"f1"_field = 0xba11});
+    STATIC_REQUIRE(h != 0);
+}
+
 namespace {
 template <typename View>
 struct MsgEquivMatcher : Catch::Matchers::MatcherGenericBase {
@@ -0,0 +1,201 @@
+#include <cib/cib.hpp>
+#include <log/catalog/mipi_messages.hpp>
+#include <msg/callback.hpp>
+#include <msg/field.hpp>
+#include <msg/message.hpp>
+#include <msg/message_pool.hpp>
+#include <msg/service.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace {
+using namespace msg;
+
+using id_field = field<"id", std::uint32_t>::located<at{0_dw, 31_msb, 24_lsb}>;
+using field1 = field<"f1", std::uint32_t>::located<at{0_dw, 15_msb, 0_lsb}>;
+using field2 = field<"f2", std::uint32_t>::located<at{1_dw, 23_msb, 16_lsb}>;
+using field3 = field<"f3", std::uint32_t>::located<at{3_dw, 15_msb, 0_lsb}>;
+
+using small_msg = message<"small", id_field, field1>;
+using medium_msg = message<"medium", id_field, field1, field2>;
+using large_msg = message<"large", id_field, field1, field2, field3>;
+
+using pool_t = msg::message_pool<
+    "test", std::uint32_t, 2,
+    stdx::type_list<small_msg, medium_msg, large_msg, medium_msg>>;
+
+constexpr auto small_callback = msg::callback<"small", small_msg>(
+    msg::equal_to<id_field, 0x80>, [](msg::const_view<small_msg>) {});
+constexpr auto large_callback = msg::callback<"large", large_msg>(
+    msg::equal_to<id_field, 0x81>, [](msg::const_view<large_msg>) {});
+
+struct test_service : msg::service<msg::const_view<large_msg>> {};
+struct test_project {
+    constexpr static auto config =
+        cib::config(cib::exports<test_service>,
+                    cib::extend<test_service>(small_callback, large_callback));
+};
+
+using nexus_pool_t =
+    msg::message_pool<"nexus", std::uint32_t, 2,
+                      msg::nexus_messages_t<test_project, test_service>>;
+
+// a long build message is its header (6 bytes) and payload_len bytes
+using build_msg_t = logging::mipi::defn::normal_build_msg_t;
+using byte_pool_t = msg::message_pool<"bytes", std::uint8_t, 2,
+                                      stdx::type_list<build_msg_t>, 64>;
+using build_message_t = msg::pooled_message<byte_pool_t, build_msg_t>;
+} // namespace
+
+TEST_CASE("size classes come from message definitions", "[message_pool]") {
+    STATIC_REQUIRE(pool_t::size_classes == std::array<std::size_t, 3>{1, 2, 4});
+    STATIC_REQUIRE(pool_t::class_index(1) == 0);
+    STATIC_REQUIRE(pool_t::class_index(3) == 2);
+    STATIC_REQUIRE(pool_t::class_index(5) == 3);
+}
+
+TEST_CASE("size classes come from nexus-registered definitions",
+          "[message_pool]") {
+    STATIC_REQUIRE(std::is_same_v<
+                   msg::nexus_messages_t<test_project, test_service>,
+                   stdx::type_list<small_msg, large_msg>>);
+    STATIC_REQUIRE(nexus_pool_t::size_classes ==
+                   std::array<std::size_t, 2>{1, 4});
+}
+
+TEST_CASE("size classes double up to the maximum size", "[message_pool]") {
+    STATIC_REQUIRE(byte_pool_t::size_classes ==
+                   std::array<std::size_t, 5>{6, 12, 24, 48, 64});
+    STATIC_REQUIRE(byte_pool_t::max_size == 64);
+}
+
+TEST_CASE("pooled storage is storage-like", "[message_pool]") {
+    using storage_t = msg::pooled_storage<pool_t, 2>;
+    STATIC_REQUIRE(msg::detail::storage_like<storage_t>);
+    STATIC_REQUIRE(stdx::ct_capacity_v<storage_t> == 2);
+    STATIC_REQUIRE(sizeof(storage_t) == sizeof(std::uint32_t *));
+}
+
+TEST_CASE("owning message with pooled storage", "[message_pool]") {
+    using msg_t = msg::pooled_owning<pool_t, medium_msg>;
+    auto m = msg_t{"id"_field = 0x80, "f1"_field = 0xba11, "f2"_field = 0x42};
+    CHECK(m.get("id"_field) == 0x80);
+    CHECK(m.get("f1"_field) == 0xba11);
+    CHECK(m.get("f2"_field) == 0x42);
+
+    m.set("f2"_field = 0x17);
+    CHECK(m.get("f2"_field) == 0x17);
+}
+
+TEST_CASE("copying pooled storage copies the data", "[message_pool]") {
+    using msg_t = msg::pooled_owning<pool_t, small_msg>;
+    auto m1 = msg_t{"id"_field = 0x80};
+    auto m2 = m1;
+    CHECK(m1.data().data() != m2.data().data());
+    m2.set("id"_field = 0x81);
+    CHECK(m1.get("id"_field) == 0x80);
+    CHECK(m2.get("id"_field) == 0x81);
+}
+
+TEST_CASE("moving pooled storage transfers the block", "[message_pool]") {
+    using msg_t = msg::pooled_owning<pool_t, large_msg>;
+    auto m1 = msg_t{"f3"_field = 0x42};
+    auto const p = m1.data().data();
+    auto m2 = std::move(m1);
+    CHECK(m2.data().data() == p);
+    CHECK(m2.get("f3"_field) == 0x42);
+}
+
+TEST_CASE("released blocks are reused", "[message_pool]") {
+    using storage_t = msg::pooled_storage<pool_t, 4>;
+    auto const *p = [] {
+        auto s = storage_t{};
+        return s.data();
+    }();
+    auto s1 = storage_t{};
+    auto s2 = storage_t{};
+    CHECK((s1.data() == p or s2.data() == p));
+    CHECK(s1.data() != s2.data());
+}
+
+TEST_CASE("sizes in the same class share a slab", "[message_pool]") {
+    auto const *p = [] {
+        auto s = msg::pooled_storage<pool_t, 4>{};
+        return s.data();
+    }();
+    auto s1 = msg::pooled_storage<pool_t, 3>{};
+    auto s2 = msg::pooled_storage<pool_t, 3>{};
+    CHECK((s1.data() == p or s2.data() == p));
+}
+
+TEST_CASE("reused blocks are cleared", "[message_pool]") {
+    using storage_t = msg::pooled_storage<pool_t, 2>;
+    auto const *p = [] {
+        auto s = storage_t{};
+        std::fill(s.begin(), s.end(), 0xffff'ffffu);
+        return s.data();
+    }();
+    auto s1 = storage_t{};
+    auto s2 = storage_t{};
+    auto const &reused = s1.data() == p ? s1 : s2;
+    REQUIRE(reused.data() == p);
+    CHECK(std::all_of(reused.begin(), reused.end(),
+                      [](auto x) { return x == 0; }));
+}
+
+TEST_CASE("views over pooled messages", "[message_pool]") {
+    using msg_t = msg::pooled_owning<pool_t, medium_msg>;
+    auto m = msg_t{"id"_field = 0x80, "f2"_field = 0x42};
+    auto v = m.as_const_view();
+    CHECK(v.get("f2"_field) == 0x42);
+    CHECK(equivalent(m, v));
+}
+
+TEST_CASE("a runtime-length message takes the smallest block that fits",
+          "[message_pool]") {
+    auto m = build_message_t{10, "payload_len"_field = 10};
+    CHECK(m.size() == 16);
+    CHECK(m.payload().size() == 10);
+    CHECK(m.payload().data() == m.data().data() + 6);
+    CHECK(byte_pool_t::slab_at<2>.owns(m.data().data()));
+
+    auto large = build_message_t{50, "payload_len"_field = 50};
+    CHECK(byte_pool_t::slab_at<4>.owns(large.data().data()));
+}
+
+TEST_CASE("a runtime-length message has the fields of its definition",
+          "[message_pool]") {
+    using namespace logging::mipi::defn;
+    auto m = build_message_t{4, "payload_len"_field = 4};
+    CHECK(m.get("type"_field) == type::Build);
+    CHECK(m.get("subtype"_field) == build_subtype::Long);
+    CHECK(m.get("payload_len"_field) == 4);
+
+    m.set("payload_len"_field = 3);
+    CHECK(m.view().get("payload_len"_field) == 3);
+}
+
+TEST_CASE("copying a runtime-length message copies the payload",
+          "[message_pool]") {
+    auto m1 = build_message_t{4, "payload_len"_field = 4};
+    std::fill(m1.payload().begin(), m1.payload().end(), std::uint8_t{0xa5});
+    auto m2 = m1;
+    CHECK(m1.data().data() != m2.data().data());
+    CHECK(m2.size() == m1.size());
+    CHECK(std::equal(m1.data().begin(), m1.data().end(), m2.data().begin()));
+}
+
+TEST_CASE("moving a runtime-length message transfers the block",
+          "[message_pool]") {
+    auto m1 = build_message_t{20, "payload_len"_field = 20};
+    auto const p = m1.data().data();
+    auto m2 = std::move(m1);
+    CHECK(m2.data().data() == p);
+    CHECK(m2.get("payload_len"_field) == 20);
+}
@@ -0,0 +1,102 @@
+#include <log/fmt/logger.hpp>
+#include <msg/callback.hpp>
+#include <msg/field.hpp>
+#include <msg/handler.hpp>
+#include <msg/message.hpp>
+#include <msg/mismatch_policy.hpp>
+
+#include <stdx/tuple.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <string>
+
+namespace {
+using namespace msg;
+
+using id_field = field<"id", std::uint32_t>::located<at{0_dw, 31_msb, 24_lsb}>;
+using field1 = field<"f1", std::uint32_t>::located<at{0_dw, 15_msb, 0_lsb}>;
+
+using msg_defn = message<"msg", id_field, field1>;
+
+template <auto V> constexpr auto id_match = msg::equal_to_t<id_field, V>{};
+
+std::string log_buffer{};
+
+using policy_t = msg::deferred_mismatch_log<4, 16, 2>;
+} // namespace
+
+template <>
+inline auto logging::config<> =
+    logging::fmt::config{std::back_inserter(log_buffer)};
+
+template <> inline auto msg::mismatch_policy<> = policy_t{};
+
+namespace {
+auto callback = msg::callback<"cb", msg_defn>(id_match<0x80>,
+                                              [](msg::const_view<msg_defn>) {});
+auto callbacks = stdx::make_tuple(callback);
+using msg_t = std::array<std::uint32_t, 1>;
+auto const handler = msg::handler<decltype(callbacks), msg_t>{callbacks};
+
+auto reset() {
+    msg::mismatch_policy<>.drain();
+    log_buffer.clear();
+}
+} // namespace
+
+TEST_CASE("mismatch is not logged immediately", "[mismatch_policy]") {
+    reset();
+    CHECK(not handler.handle(msg_t{0x8100ba11u}));
+    CHECK(log_buffer.empty());
+    CHECK(msg::mismatch_policy<>.pending() == 1);
+}
+
+TEST_CASE("drain logs deferred mismatches", "[mismatch_policy]") {
+    reset();
+    CHECK(not handler.handle(msg_t{0x8100ba11u}));
+    CHECK(msg::mismatch_policy<>.drain() == 1);
+    CAPTURE(log_buffer);
+    CHECK(log_buffer.find(
+              "None of the registered callbacks (1) claimed this message") !=
+          std::string::npos);
+    CHECK(log_buffer.find("cb") != std::string::npos);
+    CHECK(msg::mismatch_policy<>.pending() == 0);
+}
+
+TEST_CASE("deferred mismatch records a copy of the message",
+          "[mismatch_policy]") {
+    reset();
+    {
+        auto const msg = msg_t{0x8100ba11u};
+        CHECK(not handler.handle(msg));
+    }
+    CHECK(msg::mismatch_policy<>.drain() == 1);
+    CAPTURE(log_buffer);
+    CHECK(log_buffer.find("0x81") != std::string::npos);
+}
+
+TEST_CASE("mismatches are rate limited between drains",
+          "[mismatch_policy]") {
+    reset();
+    for (auto i = 0; i < 5; ++i) {
+        CHECK(not handler.handle(msg_t{0x8100ba11u}));
+    }
+    CHECK(msg::mismatch_policy<>.pending() == 2);
+    CHECK(msg::mismatch_policy<>.num_dropped() == 3);
+
+    CHECK(msg::mismatch_policy<>.drain() == 2);
+    CAPTURE(log_buffer);
+    CHECK(log_buffer.find("3 mismatched messages were not recorded") !=
+          std::string::npos);
+    CHECK(msg::mismatch_policy<>.num_dropped() == 0);
+}
+
+TEST_CASE("matched messages are not recorded", "[mismatch_policy]") {
+    reset();
+    CHECK(handler.handle(msg_t{0x8000ba11u}));
+    CHECK(msg::mismatch_policy<>.pending() == 0);
+}
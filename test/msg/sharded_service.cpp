@@ -0,0 +1,132 @@
+#include <cib/cib.hpp>
+#include <log/fmt/logger.hpp>
+#include <msg/callback.hpp>
+#include <msg/field.hpp>
+#include <msg/message.hpp>
+#include <msg/sharded_service.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+using namespace msg;
+
+using id_field = field<"id", std::uint32_t>::located<at{0_dw, 31_msb, 24_lsb}>;
+using conn_field =
+    field<"conn", std::uint32_t>::located<at{0_dw, 15_msb, 0_lsb}>;
+using seq_field = field<"seq", std::uint32_t>::located<at{1_dw, 31_msb, 0_lsb}>;
+
+using msg_defn = message<"msg", id_field, conn_field, seq_field>;
+using test_msg_t = msg::owning<msg_defn>;
+using msg_view_t = msg::const_view<msg_defn>;
+
+constexpr auto id_match = msg::equal_to<id_field, 0x80>;
+
+std::vector<std::uint32_t> received{};
+
+constexpr auto test_callback =
+    msg::callback<"cb", msg_defn>(id_match, [](msg_view_t m) {
+        received.push_back(m.get("seq"_field));
+    });
+
+using spec_t = msg::shard_spec<conn_field, 4, 8>;
+struct test_service : msg::sharded_service<spec_t, test_msg_t> {};
+struct test_project {
+    constexpr static auto config = cib::config(
+        cib::exports<test_service>, cib::extend<test_service>(test_callback));
+};
+
+auto make_msg(std::uint32_t conn, std::uint32_t seq) {
+    return test_msg_t{"id"_field = 0x80, "conn"_field = conn,
+                      "seq"_field = seq};
+}
+
+auto process_all() -> std::size_t {
+    auto n = std::size_t{};
+    for (auto i = std::size_t{}; i < spec_t::num_shards; ++i) {
+        n += cib::service<test_service>->process(i);
+    }
+    return n;
+}
+
+std::string log_buffer{};
+} // namespace
+
+template <>
+inline auto logging::config<> =
+    logging::fmt::config{std::back_inserter(log_buffer)};
+
+TEST_CASE("shard selection is a function of the field value",
+          "[sharded_service]") {
+    auto const m1 = make_msg(42, 1);
+    auto const m2 = make_msg(42, 2);
+    CHECK(spec_t::shard_for(m1) == spec_t::shard_for(m2));
+    CHECK(spec_t::shard_for(m1) < spec_t::num_shards);
+}
+
+TEST_CASE("handle queues and process dispatches", "[sharded_service]") {
+    cib::nexus<test_project> test_nexus{};
+    test_nexus.init();
+    process_all();
+    received.clear();
+
+    auto const m = make_msg(42, 17);
+    CHECK(cib::service<test_service>->handle(m));
+    CHECK(received.empty());
+
+    CHECK(cib::service<test_service>->process(spec_t::shard_for(m)) == 1);
+    REQUIRE(received.size() == 1);
+    CHECK(received[0] == 17);
+}
+
+TEST_CASE("per-key ordering is preserved", "[sharded_service]") {
+    cib::nexus<test_project> test_nexus{};
+    test_nexus.init();
+    process_all();
+    received.clear();
+
+    for (auto seq = std::uint32_t{}; seq < 5; ++seq) {
+        CHECK(cib::service<test_service>->handle(make_msg(7, seq)));
+    }
+    CHECK(process_all() == 5);
+    CHECK(received == std::vector<std::uint32_t>{0, 1, 2, 3, 4});
+}
+
+TEST_CASE("full shard queue drops and counts messages",
+          "[sharded_service]") {
+    cib::nexus<test_project> test_nexus{};
+    test_nexus.init();
+    process_all();
+    received.clear();
+    auto const dropped_before = cib::service<test_service>->dropped();
+
+    for (auto seq = std::uint32_t{}; seq < spec_t::queue_capacity; ++seq) {
+        CHECK(cib::service<test_service>->handle(make_msg(3, seq)));
+    }
+    CHECK(cib::service<test_service>->handle(make_msg(3, 99)));
+    CHECK(cib::service<test_service>->dropped() == dropped_before + 1);
+    CHECK(process_all() == spec_t::queue_capacity);
+    CHECK(received.size() == spec_t::queue_capacity);
+}
+
+TEST_CASE("unmatched messages are rejected and not queued",
+          "[sharded_service]") {
+    cib::nexus<test_project> test_nexus{};
+    test_nexus.init();
+    process_all();
+    received.clear();
+    log_buffer.clear();
+    auto const dropped_before = cib::service<test_service>->dropped();
+
+    CHECK(not cib::service<test_service>->handle(
+        test_msg_t{"id"_field = 0x81, "conn"_field = 1, "seq"_field = 1}));
+    CHECK(log_buffer.find("None of the registered callbacks") !=
+          std::string::npos);
+    CHECK(process_all() == 0);
+    CHECK(received.empty());
+    CHECK(cib::service<test_service>->dropped() == dropped_before);
+}
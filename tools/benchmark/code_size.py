@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+
+"""Report the code size of log call sites, and check it against a baseline.
+
+Each object file is given as name=path, and holds functions named
+call_site_*, each with one log call (see benchmark/log/code_size.cpp). The
+size of each such function is what a call site costs; everything else in the
+text of the object (template instantiations shared by call sites) is reported
+as "shared".
+"""
+
+import argparse
+import json
+import subprocess
+import sys
+from typing import Iterator
+
+CALL_SITE_PREFIX = "call_site_"
+TEXT_TYPES = set("tTwW")
+
+
+def symbol_sizes(nm: str, path: str) -> dict[str, int]:
+    out = subprocess.run(
+        [nm, "--print-size", "--defined-only", path],
+        check=True,
+        capture_output=True,
+        text=True,
+    ).stdout
+
+    sizes = {"shared": 0}
+    for line in out.splitlines():
+        fields = line.split()
+        # address size type name; symbols without a size have 3 fields
+        if len(fields) != 4 or fields[2] not in TEXT_TYPES:
+            continue
+        size = int(fields[1], 16)
+        name = fields[3].lstrip("_")
+        if name.startswith(CALL_SITE_PREFIX):
+            sizes[name[len(CALL_SITE_PREFIX) :]] = size
+        else:
+            sizes["shared"] += size
+    return sizes
+
+
+def print_table(results: dict[str, dict[str, int]]) -> None:
+    loggers = list(results.keys())
+    rows = sorted({row for sizes in results.values() for row in sizes})
+    width = max(len(r) for r in rows)
+    header = "  ".join(f"{logger:>8}" for logger in loggers)
+    print(f"{'call site':<{width}}  {header}")
+    for row in rows:
+        cells = (str(results[logger].get(row, "-")) for logger in loggers)
+        print(f"{row:<{width}}  " + "  ".join(f"{c:>8}" for c in cells))
+
+
+def regressions(
+    results: dict[str, dict[str, int]],
+    baseline: dict[str, dict[str, int]],
+    tolerance: float,
+) -> Iterator[str]:
+    for logger, sizes in results.items():
+        for row, size in sizes.items():
+            old = baseline.get(logger, {}).get(row)
+            if old is not None and size > old * (1 + tolerance):
+                yield f"{logger} {row}: {old} -> {size} bytes"
+
+
+def parse_cmdline() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--nm", default="nm", help="The nm tool to use.")
+    parser.add_argument(
+        "--output", help="Write the sizes to this file, as JSON."
+    )
+    parser.add_argument(
+        "--baseline",
+        help="Sizes from an earlier run: fail if a call site has grown.",
+    )
+    parser.add_argument(
+        "--tolerance",
+        type=float,
+        default=0.05,
+        help="The growth allowed over the baseline (default 0.05, i.e. 5%%).",
+    )
+    parser.add_argument(
+        "objects", nargs="+", metavar="name=object", help="Objects to measure."
+    )
+    return parser.parse_args()
+
+
+def main() -> None:
+    args = parse_cmdline()
+
+    results: dict[str, dict[str, int]] = {}
+    for obj in args.objects:
+        name, _, path = obj.partition("=")
+        results[name] = symbol_sizes(args.nm, path)
+
+    print_table(results)
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=4, sort_keys=True)
+
+    if args.baseline:
+        with open(args.baseline, "r") as f:
+            baseline = json.load(f)
+        failed = list(regressions(results, baseline, args.tolerance))
+        for r in failed:
+            print(f"code size regression: {r}", file=sys.stderr)
+        if failed:
+            sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
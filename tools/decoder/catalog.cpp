@@ -0,0 +1,141 @@
+#include "catalog.hpp"
+#include "json.hpp"
+
+#include <charconv>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace logging::decoder {
+namespace {
+auto to_id(json::value const &v) -> std::uint32_t {
+    auto const d = v.as_number();
+    if (d < 0 or d > 0xffff'ffff) {
+        throw std::runtime_error{"catalog: ID out of range"};
+    }
+    return static_cast<std::uint32_t>(d);
+}
+
+// Argument types look like "encode_32<int>", "encode_u64<ns::E>" or
+// "encode_z32<int>"; see log/catalog/arguments.hpp.
+auto to_arg_type(std::string_view s,
+                 std::unordered_map<std::string, enum_names> const &enums)
+    -> arg_type {
+    auto const open = s.find('<');
+    if (open == std::string_view::npos or s.back() != '>') {
+        throw std::runtime_error{"catalog: unknown argument type " +
+                                 std::string{s}};
+    }
+    auto const encoding = s.substr(0, open);
+    auto const type = s.substr(open + 1, s.size() - open - 2);
+
+    auto kind = arg_kind{};
+    if (encoding == "encode_32") {
+        kind = arg_kind::i32;
+    } else if (encoding == "encode_u32") {
+        kind = type == "float" ? arg_kind::f32 : arg_kind::u32;
+    } else if (encoding == "encode_64") {
+        kind = arg_kind::i64;
+    } else if (encoding == "encode_u64") {
+        kind = type == "double" ? arg_kind::f64 : arg_kind::u64;
+    } else if (encoding == "encode_z32") {
+        kind = arg_kind::z32;
+    } else if (encoding == "encode_v32") {
+        kind = arg_kind::v32;
+    } else if (encoding == "encode_z64") {
+        kind = arg_kind::z64;
+    } else if (encoding == "encode_v64") {
+        kind = arg_kind::v64;
+    } else {
+        throw std::runtime_error{"catalog: unknown argument encoding " +
+                                 std::string{s}};
+    }
+
+    auto const e = enums.find(std::string{type});
+    return {kind, e == std::end(enums) ? nullptr : &e->second};
+}
+
+// Splits text at plain {} fields, so that the decoder can format them
+// without parsing the format string for each message.
+auto split_plain_fields(std::string_view text, std::size_t num_args)
+    -> std::vector<std::string> {
+    auto pieces = std::vector<std::string>(1);
+    for (auto i = std::size_t{}; i < text.size(); ++i) {
+        auto const c = text[i];
+        auto const next = i + 1 < text.size() ? text[i + 1] : '\0';
+        if ((c == '{' and next == '{') or (c == '}' and next == '}')) {
+            pieces.back() += c;
+            ++i;
+        } else if (c == '{' and next == '}') {
+            pieces.emplace_back();
+            ++i;
+        } else if (c == '{' or c == '}') {
+            return {};
+        } else {
+            pieces.back() += c;
+        }
+    }
+    if (pieces.size() != num_args + 1) {
+        return {};
+    }
+    return pieces;
+}
+} // namespace
+
+auto catalog::from_json(std::string_view text) -> catalog {
+    auto const doc = json::parse(text);
+    auto c = catalog{};
+
+    if (auto const es = doc.find("enums")) {
+        for (auto const &[name, values] : es->as_object()) {
+            auto &names = c.enums[name];
+            for (auto const &[value, enumerator] : values.as_object()) {
+                auto v = std::int64_t{};
+                auto const last = value.data() + value.size();
+                auto const [p, ec] = std::from_chars(value.data(), last, v);
+                if (ec != std::errc{} or p != last) {
+                    throw std::runtime_error{"catalog: bad enum value " +
+                                             value};
+                }
+                names.emplace(v, enumerator.as_string());
+            }
+        }
+    }
+
+    if (auto const ms = doc.find("messages")) {
+        for (auto const &m : ms->as_array()) {
+            auto const *id = m.find("id");
+            auto const *msg = m.find("msg");
+            auto const *arg_types = m.find("arg_types");
+            if (id == nullptr or msg == nullptr or arg_types == nullptr) {
+                throw std::runtime_error{"catalog: incomplete message entry"};
+            }
+            auto info = message_info{msg->as_string(), {}, 0, false, {}};
+            for (auto const &a : arg_types->as_array()) {
+                info.args.push_back(to_arg_type(a.as_string(), c.enums));
+                auto const size = size_of(info.args.back().kind);
+                info.arg_bytes += size;
+                info.has_varints = info.has_varints or size == 0;
+            }
+            info.pieces = split_plain_fields(info.text, info.args.size());
+            // stable IDs may repeat an entry; the first one wins
+            c.messages.insert(to_id(*id), std::move(info));
+        }
+    }
+
+    if (auto const ms = doc.find("modules")) {
+        for (auto const &m : ms->as_array()) {
+            auto const *id = m.find("id");
+            auto const *str = m.find("string");
+            if (id == nullptr or str == nullptr) {
+                throw std::runtime_error{"catalog: incomplete module entry"};
+            }
+            c.modules.insert(to_id(*id), str->as_string());
+        }
+    }
+    return c;
+}
+} // namespace logging::decoder
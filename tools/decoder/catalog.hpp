@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace logging::decoder {
+// z and v kinds are varints (from logging::varint_arg_packer); z kinds are
+// zigzag encoded.
+enum struct arg_kind : std::uint8_t {
+    i32,
+    u32,
+    i64,
+    u64,
+    f32,
+    f64,
+    z32,
+    v32,
+    z64,
+    v64
+};
+
+// The size of a fixed-size argument, or 0 for a varint.
+[[nodiscard]] constexpr auto size_of(arg_kind k) -> std::size_t {
+    switch (k) {
+    case arg_kind::i32:
+    case arg_kind::u32:
+    case arg_kind::f32: return 4;
+    case arg_kind::i64:
+    case arg_kind::u64:
+    case arg_kind::f64: return 8;
+    default: return 0;
+    }
+}
+
+[[nodiscard]] constexpr auto max_size_of(arg_kind k) -> std::size_t {
+    switch (k) {
+    case arg_kind::z32:
+    case arg_kind::v32: return 5;
+    case arg_kind::z64:
+    case arg_kind::v64: return 10;
+    default: return size_of(k);
+    }
+}
+
+using enum_names = std::unordered_map<std::int64_t, std::string>;
+
+struct arg_type {
+    arg_kind kind;
+    // non-null if the argument is an enumeration with known names
+    enum_names const *names;
+};
+
+struct message_info {
+    std::string text;
+    std::vector<arg_type> args;
+    std::size_t arg_bytes; // the size of the fixed-size arguments
+    bool has_varints;
+    // If every replacement field in text is a plain {}, the literal text
+    // around them (one more piece than args); otherwise empty.
+    std::vector<std::string> pieces;
+};
+
+// An open-addressing hash table keyed by 32-bit ID.
+template <typename T> class id_table {
+    struct slot {
+        std::uint32_t key;
+        std::uint32_t index; // 1-based index into values; 0 is empty
+    };
+
+    std::vector<slot> slots{};
+    std::vector<std::uint32_t> keys{};
+    std::vector<T> values{};
+    std::uint32_t shift{32};
+
+    [[nodiscard]] auto home(std::uint32_t key) const -> std::size_t {
+        // Fibonacci hashing: spreads sequential IDs across the table
+        return (key * 0x9e37'79b9u) >> shift;
+    }
+
+    auto rehash(std::size_t capacity) -> void {
+        shift = 32;
+        for (auto c = capacity; c > 1; c >>= 1u) {
+            --shift;
+        }
+        slots.assign(capacity, slot{});
+        for (auto i = std::size_t{}; i < values.size(); ++i) {
+            place(keys[i], static_cast<std::uint32_t>(i + 1));
+        }
+    }
+
+    auto place(std::uint32_t key, std::uint32_t index) -> void {
+        auto const mask = slots.size() - 1;
+        for (auto i = home(key);; i = (i + 1) & mask) {
+            if (slots[i].index == 0) {
+                slots[i] = {key, index};
+                return;
+            }
+        }
+    }
+
+  public:
+    // Returns false (and changes nothing) if the key is already present.
+    auto insert(std::uint32_t key, T value) -> bool {
+        if (find(key) != nullptr) {
+            return false;
+        }
+        keys.push_back(key);
+        values.push_back(std::move(value));
+        if (values.size() * 2 > slots.size()) {
+            rehash(slots.empty() ? 16 : slots.size() * 2);
+        } else {
+            place(key, static_cast<std::uint32_t>(values.size()));
+        }
+        return true;
+    }
+
+    [[nodiscard]] auto find(std::uint32_t key) const -> T const * {
+        if (slots.empty()) {
+            return nullptr;
+        }
+        auto const mask = slots.size() - 1;
+        for (auto i = home(key);; i = (i + 1) & mask) {
+            auto const &s = slots[i];
+            if (s.index == 0) {
+                return nullptr;
+            }
+            if (s.key == key) {
+                return &values[s.index - 1];
+            }
+        }
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t { return values.size(); }
+};
+
+// The string catalog, as written by gen_str_catalog.py --json_output.
+class catalog {
+    id_table<message_info> messages{};
+    id_table<std::string> modules{};
+    std::unordered_map<std::string, enum_names> enums{};
+
+  public:
+    // Throws std::runtime_error on malformed input.
+    [[nodiscard]] static auto from_json(std::string_view text) -> catalog;
+
+    [[nodiscard]] auto find_message(std::uint32_t id) const
+        -> message_info const * {
+        return messages.find(id);
+    }
+
+    [[nodiscard]] auto find_module(std::uint32_t id) const
+        -> std::string const * {
+        return modules.find(id);
+    }
+
+    [[nodiscard]] auto num_messages() const -> std::size_t {
+        return messages.size();
+    }
+};
+} // namespace logging::decoder
@@ -0,0 +1,559 @@
+#include "decoder.hpp"
+
+#include <fmt/args.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace logging::decoder {
+namespace {
+using namespace std::string_view_literals;
+
+// MIPI Sys-T severity, as logging::level
+constexpr auto level_text =
+    std::array{"MAX"sv,  "FATAL"sv, "ERROR"sv, "WARN"sv,
+               "INFO"sv, "USER1"sv, "USER2"sv, "TRACE"sv};
+
+constexpr auto header_bytes = std::size_t{4};
+constexpr auto long_build_header_bytes = std::size_t{6};
+constexpr auto delta_bytes = std::size_t{4};
+
+template <typename T> auto load_le(std::byte const *p) -> T {
+    auto v = T{};
+    for (auto i = sizeof(T); i-- > 0;) {
+        v = static_cast<T>(v << 8u) | std::to_integer<T>(p[i]);
+    }
+    return v;
+}
+
+// Reads a LEB128 varint that framing has checked, and advances p past it.
+auto load_varint(std::byte const *&p) -> std::uint64_t {
+    auto v = std::uint64_t{};
+    for (auto shift = 0u;; shift += 7u) {
+        auto const b = std::to_integer<std::uint64_t>(*p++);
+        v |= (b & 0x7fu) << shift;
+        if (b < 0x80u) {
+            return v;
+        }
+    }
+}
+
+// The size of the varint at the start of data, or 0 if it is truncated or
+// longer than max bytes.
+auto varint_size(std::span<std::byte const> data, std::size_t max)
+    -> std::size_t {
+    auto const n = std::min(data.size(), max);
+    for (auto i = std::size_t{}; i < n; ++i) {
+        if (std::to_integer<unsigned>(data[i]) < 0x80u) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+auto bits(std::uint32_t w, unsigned msb, unsigned lsb) -> std::uint32_t {
+    return (w >> lsb) & ((2u << (msb - lsb)) - 1u);
+}
+
+// Catalog message subtypes. Only pack32 is assigned by Sys-T; the others
+// are private to cib. A varint message's arguments are packed by
+// logging::varint_arg_packer (see log/catalog/mipi_messages.hpp). A delta
+// message has a 32-bit time delta between its header and its string ID (see
+// log/catalog/timestamp.hpp).
+constexpr auto pack32_subtype = std::uint32_t{0x01u};
+constexpr auto varint_delta_subtype = std::uint32_t{0x3du};
+constexpr auto varint_subtype = std::uint32_t{0x3eu};
+constexpr auto delta_subtype = std::uint32_t{0x3fu};
+
+auto known_catalog_subtype(std::uint32_t hdr) -> bool {
+    auto const s = bits(hdr, 29, 24);
+    return s == pack32_subtype or s >= varint_delta_subtype;
+}
+
+auto has_delta(std::uint32_t hdr) -> bool {
+    auto const s = bits(hdr, 29, 24);
+    return s == delta_subtype or s == varint_delta_subtype;
+}
+
+auto has_varints(std::uint32_t hdr) -> bool {
+    auto const s = bits(hdr, 29, 24);
+    return s == varint_subtype or s == varint_delta_subtype;
+}
+
+// Whether a message's integral arguments are varints exactly when its record
+// says they are; floating-point arguments are packed the same either way.
+auto packing_matches(message_info const &info, bool varints) -> bool {
+    return std::none_of(
+        std::cbegin(info.args), std::cend(info.args), [&](arg_type const &a) {
+            auto const is_float =
+                a.kind == arg_kind::f32 or a.kind == arg_kind::f64;
+            return not is_float and (size_of(a.kind) == 0) != varints;
+        });
+}
+
+auto catalog_prefix_bytes(std::uint32_t hdr) -> std::size_t {
+    return has_delta(hdr) ? header_bytes + delta_bytes : header_bytes;
+}
+
+auto compact_version(std::uint32_t hdr) -> std::uint64_t {
+    return (std::uint64_t{bits(hdr, 31, 30)} << 20u) | bits(hdr, 23, 4);
+}
+
+// Writes one line per record. Fixed parts of a line are appended directly
+// and message text with plain {} fields is formatted without parsing it
+// again; fmt's format string parser is only used for fields with format
+// specs.
+class formatter {
+    using buffer = fmt::memory_buffer;
+
+    catalog const &cat;
+    output_format format;
+    fmt::dynamic_format_arg_store<fmt::format_context> args{};
+    buffer msg{};
+    buffer &out;
+
+    static auto append(buffer &b, std::string_view s) -> void {
+        b.append(s.data(), s.data() + s.size());
+    }
+
+    template <typename T> static auto append_int(buffer &b, T v) -> void {
+        auto const f = fmt::format_int{v};
+        b.append(f.data(), f.data() + f.size());
+    }
+
+    template <typename T>
+    static auto append_enum_or_int(buffer &b, arg_type const &t, T v)
+        -> void {
+        if (t.names != nullptr) {
+            auto const it = t.names->find(static_cast<std::int64_t>(v));
+            if (it != t.names->end()) {
+                append(b, it->second);
+                return;
+            }
+        }
+        append_int(b, v);
+    }
+
+    template <typename T>
+    auto push_enum_or_int(arg_type const &t, T v) -> void {
+        if (t.names != nullptr) {
+            auto const it = t.names->find(static_cast<std::int64_t>(v));
+            if (it != t.names->end()) {
+                args.push_back(std::string_view{it->second});
+                return;
+            }
+        }
+        args.push_back(v);
+    }
+
+    // Calls f with the value of the argument at p and advances p past it.
+    template <typename F>
+    static auto visit_arg(arg_type const &t, std::byte const *&p, F &&f)
+        -> void {
+        auto const unzigzag = [](std::uint64_t u) {
+            return static_cast<std::int64_t>(u >> 1u) ^
+                   -static_cast<std::int64_t>(u & 1u);
+        };
+        switch (t.kind) {
+        case arg_kind::i32:
+            f(static_cast<std::int32_t>(load_le<std::uint32_t>(p)));
+            break;
+        case arg_kind::u32: f(load_le<std::uint32_t>(p)); break;
+        case arg_kind::i64:
+            f(static_cast<std::int64_t>(load_le<std::uint64_t>(p)));
+            break;
+        case arg_kind::u64: f(load_le<std::uint64_t>(p)); break;
+        case arg_kind::f32:
+            f(std::bit_cast<float>(load_le<std::uint32_t>(p)));
+            break;
+        case arg_kind::f64:
+            f(std::bit_cast<double>(load_le<std::uint64_t>(p)));
+            break;
+        case arg_kind::z32:
+            f(static_cast<std::int32_t>(unzigzag(load_varint(p))));
+            return;
+        case arg_kind::v32:
+            f(static_cast<std::uint32_t>(load_varint(p)));
+            return;
+        case arg_kind::z64: f(unzigzag(load_varint(p))); return;
+        case arg_kind::v64: f(load_varint(p)); return;
+        }
+        p += size_of(t.kind);
+    }
+
+    // Formats the message text into b; on a format error, the text is shown
+    // unformatted.
+    auto format_message(buffer &b, message_info const &info,
+                        std::byte const *p) -> void {
+        if (not info.pieces.empty()) {
+            for (auto i = std::size_t{}; i < info.args.size(); ++i) {
+                auto const &t = info.args[i];
+                append(b, info.pieces[i]);
+                visit_arg(t, p, [&]<typename T>(T v) {
+                    if constexpr (std::is_integral_v<T>) {
+                        append_enum_or_int(b, t, v);
+                    } else {
+                        fmt::format_to(fmt::appender(b), "{}", v);
+                    }
+                });
+            }
+            append(b, info.pieces.back());
+            return;
+        }
+
+        args.clear();
+        for (auto const &t : info.args) {
+            visit_arg(t, p, [&]<typename T>(T v) {
+                if constexpr (std::is_integral_v<T>) {
+                    push_enum_or_int(t, v);
+                } else {
+                    args.push_back(v);
+                }
+            });
+        }
+        auto const size = b.size();
+        try {
+            fmt::vformat_to(fmt::appender(b), info.text, args);
+        } catch (std::exception const &e) {
+            b.resize(size);
+            fmt::format_to(fmt::appender(b), "{} <format error: {}>",
+                           info.text, e.what());
+        }
+    }
+
+    auto append_module(std::uint32_t id) -> void {
+        if (auto const m = cat.find_module(id)) {
+            if (format == output_format::text) {
+                append(out, *m);
+            } else {
+                append_json_string(out, *m);
+            }
+        } else {
+            append_int(out, id);
+        }
+    }
+
+    // The message text: formatted directly for text output; for JSON, via
+    // msg to be escaped.
+    auto append_message(message_info const &info, std::byte const *p)
+        -> void {
+        if (format == output_format::text) {
+            format_message(out, info, p);
+        } else {
+            msg.clear();
+            format_message(msg, info, p);
+            append_json_string(out, {msg.data(), msg.size()});
+        }
+    }
+
+    auto json_header(record const &r, std::string_view type) -> void {
+        append(out, R"({"offset":)");
+        append_int(out, r.offset);
+        append(out, R"(,"type":")");
+        append(out, type);
+        out.push_back('"');
+    }
+
+    auto short32(record const &r, std::byte const *p) -> void {
+        auto const id = bits(load_le<std::uint32_t>(p), 31, 4);
+        auto const info = cat.find_message(id);
+        if (format == output_format::text) {
+            append(out, "- [-]: ");
+        } else {
+            json_header(r, "short32");
+            append(out, R"(,"id":)");
+            append_int(out, id);
+            append(out, R"(,"msg":)");
+        }
+        if (info != nullptr) {
+            append_message(*info, p);
+        } else {
+            msg.clear();
+            fmt::format_to(fmt::appender(msg), "<unknown string ID {}>", id);
+            append_message(
+                message_info{{msg.data(), msg.size()}, {}, 0, false, {}}, p);
+        }
+        append(out, format == output_format::text ? "\n" : "}\n");
+    }
+
+    auto catalog_msg(record const &r, std::byte const *p) -> void {
+        auto const hdr = load_le<std::uint32_t>(p);
+        auto const level = level_text[bits(hdr, 6, 4)];
+        auto const prefix = catalog_prefix_bytes(hdr);
+        if (format == output_format::text) {
+            if (has_delta(hdr)) {
+                out.push_back('+');
+                append_int(out, load_le<std::uint32_t>(p + header_bytes));
+                out.push_back(' ');
+            }
+            append(out, level);
+            append(out, " [");
+            append_module(bits(hdr, 22, 16));
+            append(out, "]: ");
+        } else {
+            json_header(r, "catalog");
+            if (has_delta(hdr)) {
+                append(out, R"(,"delta":)");
+                append_int(out, load_le<std::uint32_t>(p + header_bytes));
+            }
+            append(out, R"(,"id":)");
+            append_int(out, load_le<std::uint32_t>(p + prefix));
+            append(out, R"(,"level":")");
+            append(out, level);
+            append(out, R"(","module":)");
+            append_module(bits(hdr, 22, 16));
+            append(out, R"(,"msg":)");
+        }
+        append_message(*r.info, p + prefix + sizeof(std::uint32_t));
+        append(out, format == output_format::text ? "\n" : "}\n");
+    }
+
+    auto build(record const &r, std::uint64_t version, std::string_view str)
+        -> void {
+        if (format == output_format::text) {
+            append(out, "- [-]: Version: ");
+            append_int(out, version);
+            if (not str.empty()) {
+                append(out, " (");
+                append(out, str);
+                out.push_back(')');
+            }
+            out.push_back('\n');
+        } else {
+            json_header(r, "build");
+            append(out, R"(,"version":)");
+            append_int(out, version);
+            if (not str.empty()) {
+                append(out, R"(,"string":)");
+                append_json_string(out, str);
+            }
+            append(out, "}\n");
+        }
+    }
+
+  public:
+    formatter(catalog const &c, output_format f, buffer &o)
+        : cat{c}, format{f}, out{o} {}
+
+    auto operator()(record const &r, std::byte const *p) -> void {
+        switch (r.type) {
+        case record_type::short32: short32(r, p); break;
+        case record_type::catalog: catalog_msg(r, p); break;
+        case record_type::compact32_build:
+            build(r, compact_version(load_le<std::uint32_t>(p)), {});
+            break;
+        case record_type::compact64_build: {
+            auto const hi = load_le<std::uint32_t>(p + header_bytes);
+            build(r,
+                  (std::uint64_t{hi} << 22u) |
+                      compact_version(load_le<std::uint32_t>(p)),
+                  {});
+            break;
+        }
+        case record_type::long_build: {
+            auto const payload = p + long_build_header_bytes;
+            auto const str = payload + sizeof(std::uint64_t);
+            build(r, load_le<std::uint64_t>(payload),
+                  {reinterpret_cast<char const *>(str),
+                   r.size - long_build_header_bytes - sizeof(std::uint64_t)});
+            break;
+        }
+        }
+    }
+};
+} // namespace
+
+auto append_json_string(fmt::memory_buffer &out, std::string_view s)
+    -> void {
+    auto const append = [&](std::string_view t) {
+        out.append(t.data(), t.data() + t.size());
+    };
+    out.push_back('"');
+    auto run = s.data();
+    auto const flush = [&](char const *end) {
+        out.append(run, end);
+        run = end + 1;
+    };
+    for (auto const &c : s) {
+        switch (c) {
+        case '"': flush(&c); append("\\\""); break;
+        case '\\': flush(&c); append("\\\\"); break;
+        case '\n': flush(&c); append("\\n"); break;
+        case '\r': flush(&c); append("\\r"); break;
+        case '\t': flush(&c); append("\\t"); break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                flush(&c);
+                fmt::format_to(fmt::appender(out), "\\u{:04x}",
+                               static_cast<unsigned>(c));
+            }
+        }
+    }
+    out.append(run, s.data() + s.size());
+    out.push_back('"');
+}
+
+auto frame(std::span<std::byte const> data, std::size_t start,
+           catalog const &c, std::vector<record> &records,
+           std::size_t max_records) -> frame_result {
+    auto pos = start;
+    auto const fail = [&](std::string_view why) {
+        return frame_result{pos, fmt::format("{} at offset {}", why, pos)};
+    };
+
+    for (auto n = std::size_t{}; n < max_records and pos < data.size(); ++n) {
+        auto const p = data.data() + pos;
+        auto const remaining = data.size() - pos;
+        if (remaining < header_bytes) {
+            return fail("truncated message");
+        }
+        auto const hdr = load_le<std::uint32_t>(p);
+
+        auto r = record{pos, header_bytes, record_type::short32, nullptr};
+        switch (bits(hdr, 3, 0)) {
+        case 1: break;
+        case 3: {
+            if (not known_catalog_subtype(hdr)) {
+                return fail("unknown catalog message subtype");
+            }
+            auto const prefix = catalog_prefix_bytes(hdr);
+            if (remaining < prefix + sizeof(std::uint32_t)) {
+                return fail("truncated message");
+            }
+            auto const id = load_le<std::uint32_t>(p + prefix);
+            r.info = c.find_message(id);
+            if (r.info == nullptr) {
+                return fail(fmt::format("unknown string ID {}", id));
+            }
+            r.type = record_type::catalog;
+            r.size = prefix + sizeof(std::uint32_t) + r.info->arg_bytes;
+            if (not packing_matches(*r.info, has_varints(hdr))) {
+                return fail(fmt::format(
+                    "catalog subtype does not match the arguments of string "
+                    "ID {}",
+                    id));
+            }
+            if (has_varints(hdr)) {
+                r.size = prefix + sizeof(std::uint32_t);
+                for (auto const &a : r.info->args) {
+                    if (auto const fixed = size_of(a.kind); fixed != 0) {
+                        r.size += fixed;
+                        continue;
+                    }
+                    auto const size = varint_size(
+                        data.subspan(std::min(data.size(), pos + r.size)),
+                        max_size_of(a.kind));
+                    if (size == 0) {
+                        return fail("truncated or malformed varint");
+                    }
+                    r.size += size;
+                }
+            }
+            break;
+        }
+        case 0:
+            switch (bits(hdr, 29, 24)) {
+            case 0: r.type = record_type::compact32_build; break;
+            case 1:
+                r.type = record_type::compact64_build;
+                r.size = 2 * header_bytes;
+                break;
+            case 2:
+                if (remaining < long_build_header_bytes) {
+                    return fail("truncated message");
+                }
+                r.type = record_type::long_build;
+                r.size = long_build_header_bytes +
+                         load_le<std::uint16_t>(p + header_bytes);
+                if (r.size < long_build_header_bytes + sizeof(std::uint64_t)) {
+                    return fail("malformed build message");
+                }
+                break;
+            default: return fail("unknown build message subtype");
+            }
+            break;
+        default: return fail("unknown message type");
+        }
+
+        if (r.size > remaining) {
+            return fail("truncated message");
+        }
+        records.push_back(r);
+        pos += r.size;
+    }
+    return {pos, {}};
+}
+
+auto decode(std::span<std::byte const> data, std::span<record const> records,
+            catalog const &c, output_format format, fmt::memory_buffer &out)
+    -> void {
+    auto f = formatter{c, format, out};
+    for (auto const &r : records) {
+        f(r, data.data() + r.offset);
+    }
+}
+
+auto decode_all(std::span<std::byte const> data, catalog const &c,
+                decode_options const &opts, std::FILE *out) -> decode_stats {
+    auto const num_threads = std::max(1u, opts.num_threads);
+    auto const batch_size =
+        num_threads * std::max(std::size_t{1}, opts.records_per_thread);
+
+    auto stats = decode_stats{};
+    auto records = std::vector<record>{};
+    // reused across batches, so that their memory stays mapped
+    auto outputs = std::vector<fmt::memory_buffer>(num_threads);
+    auto workers = std::vector<std::thread>{};
+
+    auto pos = std::size_t{};
+    while (pos < data.size()) {
+        records.clear();
+        auto const fr = frame(data, pos, c, records, batch_size);
+        pos = fr.consumed;
+
+        auto const per_thread =
+            (records.size() + num_threads - 1) / num_threads;
+        auto const slice = [&](std::size_t i) {
+            auto const first = std::min(records.size(), i * per_thread);
+            auto const last = std::min(records.size(), first + per_thread);
+            outputs[i].clear();
+            decode(data,
+                   std::span{records}.subspan(first, last - first), c,
+                   opts.format, outputs[i]);
+        };
+        for (auto i = std::size_t{1}; i < num_threads; ++i) {
+            workers.emplace_back(slice, i);
+        }
+        slice(0);
+        for (auto &w : workers) {
+            w.join();
+        }
+        workers.clear();
+
+        for (auto const &o : outputs) {
+            std::fwrite(o.data(), 1, o.size(), out);
+        }
+        stats.records += records.size();
+
+        if (not fr.error.empty()) {
+            stats.error = fr.error;
+            break;
+        }
+    }
+    stats.bytes = pos;
+    return stats;
+}
+} // namespace logging::decoder
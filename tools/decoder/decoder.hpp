@@ -0,0 +1,81 @@
+#pragma once
+
+#include "catalog.hpp"
+
+#include <fmt/format.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace logging::decoder {
+// The MIPI Sys-T messages that logging::mipi produces; see
+// log/catalog/mipi_messages.hpp.
+enum struct record_type : std::uint8_t {
+    short32,
+    catalog,
+    compact32_build,
+    compact64_build,
+    long_build
+};
+
+struct record {
+    std::size_t offset;
+    std::size_t size;
+    record_type type;
+    message_info const *info; // for catalog records
+};
+
+struct frame_result {
+    std::size_t consumed;
+    std::string error; // empty unless framing stopped early
+};
+
+/**
+ * Split a capture into records, starting at offset start.
+ *
+ * A capture is the concatenation of messages as written by a destination.
+ * Messages carry no length, so the length of a catalog message comes from
+ * the argument types of its string ID. Framing stops after max_records
+ * records, or at the first message that can't be framed (truncated, of an
+ * unknown type, or with an unknown string ID). consumed is the offset reached.
+ */
+[[nodiscard]] auto frame(std::span<std::byte const> data, std::size_t start,
+                         catalog const &c, std::vector<record> &records,
+                         std::size_t max_records) -> frame_result;
+
+enum struct output_format : std::uint8_t { text, json };
+
+// Decode framed records, appending one line for each to out.
+auto decode(std::span<std::byte const> data, std::span<record const> records,
+            catalog const &c, output_format format, fmt::memory_buffer &out)
+    -> void;
+
+// Append s to out as a quoted JSON string.
+auto append_json_string(fmt::memory_buffer &out, std::string_view s) -> void;
+
+struct decode_options {
+    output_format format{output_format::text};
+    unsigned num_threads{1};
+    std::size_t records_per_thread{1u << 16u};
+};
+
+struct decode_stats {
+    std::size_t records{};
+    std::size_t bytes{};
+    std::string error{};
+};
+
+/**
+ * Decode a whole capture to a file.
+ *
+ * Records are framed in batches; each batch is split across num_threads
+ * threads and the output is written in capture order.
+ */
+auto decode_all(std::span<std::byte const> data, catalog const &c,
+                decode_options const &opts, std::FILE *out) -> decode_stats;
+} // namespace logging::decoder
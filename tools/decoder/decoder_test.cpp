@@ -0,0 +1,370 @@
+#include "catalog.hpp"
+#include "decoder.hpp"
+#include "ring_file.hpp"
+
+#include <fmt/format.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace logging::decoder;
+
+namespace {
+constexpr auto test_catalog = std::string_view{R"({
+    "messages": [
+        {"msg": "Hello", "type": "msg", "arg_types": [], "arg_count": 0, "id": 1},
+        {"msg": "{} and {:#x}", "type": "msg",
+         "arg_types": ["encode_32<int>", "encode_u32<unsigned int>"],
+         "arg_count": 2, "id": 2},
+        {"msg": "big {} \"f\" {}", "type": "msg",
+         "arg_types": ["encode_u64<unsigned long>", "encode_u64<double>"],
+         "arg_count": 2, "id": 3},
+        {"msg": "state {}", "type": "msg", "arg_types": ["encode_32<ns::E>"],
+         "arg_count": 1, "id": 4},
+        {"msg": "{} {} {} {}", "type": "msg",
+         "arg_types": ["encode_z32<int>", "encode_v32<unsigned int>",
+                       "encode_u32<float>", "encode_z64<long>"],
+         "arg_count": 4, "id": 5}
+    ],
+    "modules": [{"string": "default", "id": 0}, {"string": "net", "id": 5}],
+    "extra_key": [1, 2.5, true, null],
+    "enums": {"ns::E": {"17": "ready", "3": "idle"}}
+})"};
+
+struct capture {
+    std::vector<std::byte> bytes{};
+
+    template <typename T> auto add(T v) -> capture & {
+        for (auto i = 0u; i < sizeof(T); ++i) {
+            bytes.push_back(static_cast<std::byte>(
+                static_cast<std::uint64_t>(v) >> (8 * i)));
+        }
+        return *this;
+    }
+
+    auto catalog_header(std::uint32_t level, std::uint32_t module,
+                        std::uint32_t subtype = 1) -> capture & {
+        return add(
+            std::uint32_t{3u | level << 4u | module << 16u | subtype << 24u});
+    }
+
+    auto span() const -> std::span<std::byte const> { return bytes; }
+};
+
+// A persistent ring buffer with 32-byte slots.
+struct ring_image : capture {
+    ring_image(std::uint32_t num_slots, std::uint64_t head) {
+        add(std::uint32_t{0x4c42'4943}).add(std::uint32_t{1});
+        add(num_slots).add(std::uint32_t{32}).add(head).add(std::uint64_t{});
+    }
+
+    auto slot(std::uint64_t stored_seq, bool text, capture const &record)
+        -> ring_image & {
+        add(stored_seq).add(static_cast<std::uint16_t>(record.bytes.size()));
+        add(std::uint8_t{text}).add(std::uint32_t{}).add(std::uint8_t{});
+        bytes.insert(bytes.end(), record.bytes.begin(), record.bytes.end());
+        bytes.resize(bytes.size() + 16 - record.bytes.size());
+        return *this;
+    }
+};
+
+auto text_record(std::string_view s) -> capture {
+    auto c = capture{};
+    for (auto ch : s) {
+        c.add(ch);
+    }
+    return c;
+}
+
+auto decode_all_records(capture const &cap, catalog const &c,
+                        output_format format = output_format::text)
+    -> std::string {
+    auto records = std::vector<record>{};
+    auto const fr = frame(cap.span(), 0, c, records, 100);
+    CHECK(fr.error.empty());
+    CHECK(fr.consumed == cap.bytes.size());
+    auto out = fmt::memory_buffer{};
+    decode(cap.span(), records, c, format, out);
+    return fmt::to_string(out);
+}
+} // namespace
+
+TEST_CASE("catalog is read from JSON", "[decoder]") {
+    auto const c = catalog::from_json(test_catalog);
+    CHECK(c.num_messages() == 5);
+
+    auto const m = c.find_message(3);
+    REQUIRE(m != nullptr);
+    CHECK(m->text == R"(big {} "f" {})");
+    REQUIRE(m->args.size() == 2);
+    CHECK(m->args[0].kind == arg_kind::u64);
+    CHECK(m->args[1].kind == arg_kind::f64);
+    CHECK(m->arg_bytes == 16);
+    CHECK(m->pieces == std::vector<std::string>{"big ", R"( "f" )", ""});
+
+    // a field with a format spec is left to fmt
+    CHECK(c.find_message(2)->pieces.empty());
+    CHECK(c.find_message(4)->args[0].names != nullptr);
+    CHECK(c.find_message(6) == nullptr);
+
+    REQUIRE(c.find_module(5) != nullptr);
+    CHECK(*c.find_module(5) == "net");
+}
+
+TEST_CASE("id table handles many IDs", "[decoder]") {
+    auto t = id_table<std::uint32_t>{};
+    for (auto i = 0u; i < 1000; ++i) {
+        CHECK(t.insert(i * 16, i));
+    }
+    CHECK(not t.insert(16, 0));
+    CHECK(t.size() == 1000);
+    for (auto i = 0u; i < 1000; ++i) {
+        REQUIRE(t.find(i * 16) != nullptr);
+        CHECK(*t.find(i * 16) == i);
+        CHECK(t.find(i * 16 + 1) == nullptr);
+    }
+}
+
+TEST_CASE("short32 messages are decoded", "[decoder]") {
+    auto const c = catalog::from_json(test_catalog);
+    auto cap = capture{};
+    cap.add(std::uint32_t{1u | 1u << 4u});
+    CHECK(decode_all_records(cap, c) == "- [-]: Hello\n");
+}
+
+TEST_CASE("catalog messages are decoded", "[decoder]") {
+    auto const c = catalog::from_json(test_catalog);
+    auto cap = capture{};
+    cap.catalog_header(4, 5).add(std::uint32_t{2}).add(-3).add(255u);
+    cap.catalog_header(7, 0)
+        .add(std::uint32_t{3})
+        .add(std::uint64_t{1} << 40u)
+        .add(std::uint64_t{0x3ff8'0000'0000'0000}); // 1.5
+    cap.catalog_header(2, 9).add(std::uint32_t{4}).add(17);
+    CHECK(decode_all_records(cap, c) == "INFO [net]: -3 and 0xff\n"
+                                        "TRACE [default]: big 1099511627776 "
+                                        "\"f\" 1.5\n"
+                                        "ERROR [9]: state ready\n");
+}
+
+TEST_CASE("build messages are decoded", "[decoder]") {
+    auto const c = catalog::from_json(test_catalog);
+    auto cap = capture{};
+    // compact32: version 0x40001 is split into bits 31:30 and 23:4
+    cap.add(std::uint32_t{1u << 30u | 1u << 4u});
+    // compact64: the high part is in the second word
+    cap.add(std::uint32_t{1u << 24u}).add(std::uint32_t{1});
+    // long build: payload length, version, then string
+    cap.add(std::uint32_t{1u << 9u | 2u << 24u})
+        .add(std::uint16_t{11})
+        .add(std::uint64_t{99});
+    for (auto ch : std::string_view{"v12"}) {
+        cap.add(ch);
+    }
+    CHECK(decode_all_records(cap, c) == "- [-]: Version: 1048577\n"
+                                        "- [-]: Version: 4194304\n"
+                                        "- [-]: Version: 99 (v12)\n");
+}
+
+TEST_CASE("records are decoded as JSON lines", "[decoder]") {
+    auto const c = catalog::from_json(test_catalog);
+    auto cap = capture{};
+    cap.add(std::uint32_t{1u | 1u << 4u});
+    cap.catalog_header(7, 5)
+        .add(std::uint32_t{3})
+        .add(std::uint64_t{1})
+        .add(std::uint64_t{});
+    CHECK(decode_all_records(cap, c, output_format::json) ==
+          R"({"offset":0,"type":"short32","id":1,"msg":"Hello"})"
+          "\n"
+          R"({"offset":4,"type":"catalog","id":3,"level":"TRACE","module":"net","msg":"big 1 \"f\" 0"})"
+          "\n");
+}
+
+TEST_CASE("framing stops at an unknown string ID", "[decoder]") {
+    auto const c = catalog::from_json(test_catalog);
+    auto cap = capture{};
+    cap.add(std::uint32_t{1u | 1u << 4u});
+    cap.catalog_header(4, 0).add(std::uint32_t{42});
+
+    auto records = std::vector<record>{};
+    auto const fr = frame(cap.span(), 0, c, records, 100);
+    CHECK(records.size() == 1);
+    CHECK(fr.consumed == 4);
+    CHECK(fr.error == "unknown string ID 42 at offset 4");
+}
+
+TEST_CASE("framing stops at a truncated message", "[decoder]") {
+    auto const c = catalog::from_json(test_catalog);
+    auto cap = capture{};
+    cap.catalog_header(4, 0).add(std::uint32_t{2}).add(1);
+
+    auto records = std::vector<record>{};
+    auto const fr = frame(cap.span(), 0, c, records, 100);
+    CHECK(records.empty());
+    CHECK(fr.error == "truncated message at offset 0");
+}
+
+TEST_CASE("framing stops after max records", "[decoder]") {
+    auto const c = catalog::from_json(test_catalog);
+    auto cap = capture{};
+    for (auto i = 0; i < 3; ++i) {
+        cap.add(std::uint32_t{1u | 1u << 4u});
+    }
+
+    auto records = std::vector<record>{};
+    auto fr = frame(cap.span(), 0, c, records, 2);
+    CHECK(records.size() == 2);
+    CHECK(fr.consumed == 8);
+    CHECK(fr.error.empty());
+
+    fr = frame(cap.span(), fr.consumed, c, records, 2);
+    CHECK(records.size() == 3);
+    CHECK(records.back().offset == 8);
+    CHECK(fr.consumed == 12);
+}
+
+TEST_CASE("varint arguments are framed and decoded", "[decoder]") {
+    auto const c = catalog::from_json(test_catalog);
+    auto cap = capture{};
+    cap.catalog_header(4, 5, 0x3e).add(std::uint32_t{5});
+    cap.add(std::uint8_t{0x03});                   // zigzag -2
+    cap.add(std::uint8_t{0xac}).add(std::uint8_t{0x02}); // 300
+    cap.add(std::uint32_t{0x3fc0'0000});           // 1.5f
+    cap.add(std::uint8_t{0x80}).add(std::uint8_t{0x01}); // zigzag 64
+    cap.add(std::uint32_t{1u | 1u << 4u});
+    CHECK(decode_all_records(cap, c) == "INFO [net]: -2 300 1.5 64\n"
+                                        "- [-]: Hello\n");
+}
+
+TEST_CASE("timestamped varint arguments are framed and decoded",
+          "[decoder]") {
+    auto const c = catalog::from_json(test_catalog);
+    auto cap = capture{};
+    cap.catalog_header(4, 5, 0x3d).add(std::uint32_t{250});
+    cap.add(std::uint32_t{5});
+    cap.add(std::uint8_t{0x03}).add(std::uint8_t{0x01});
+    cap.add(std::uint32_t{0x3fc0'0000}).add(std::uint8_t{0x00});
+    CHECK(decode_all_records(cap, c) == "+250 INFO [net]: -2 1 1.5 0\n");
+}
+
+TEST_CASE("framing stops where the subtype does not match the arguments",
+          "[decoder]") {
+    auto const c = catalog::from_json(test_catalog);
+    auto records = std::vector<record>{};
+
+    // varint arguments under the Sys-T packed subtype
+    auto packed = capture{};
+    packed.catalog_header(4, 5).add(std::uint32_t{5});
+    packed.add(std::uint8_t{0x03}).add(std::uint8_t{0x01});
+    auto fr = frame(packed.span(), 0, c, records, 100);
+    CHECK(fr.error == "catalog subtype does not match the arguments of "
+                      "string ID 5 at offset 0");
+
+    // packed arguments under the varint subtype
+    auto varint = capture{};
+    varint.catalog_header(4, 5, 0x3e).add(std::uint32_t{2}).add(-3).add(255u);
+    fr = frame(varint.span(), 0, c, records, 100);
+    CHECK(fr.error == "catalog subtype does not match the arguments of "
+                      "string ID 2 at offset 0");
+    CHECK(records.empty());
+}
+
+TEST_CASE("framing stops at an unknown catalog subtype", "[decoder]") {
+    auto const c = catalog::from_json(test_catalog);
+    auto cap = capture{};
+    cap.catalog_header(4, 5, 2).add(std::uint32_t{2}).add(-3).add(255u);
+
+    auto records = std::vector<record>{};
+    auto const fr = frame(cap.span(), 0, c, records, 100);
+    CHECK(records.empty());
+    CHECK(fr.error == "unknown catalog message subtype at offset 0");
+}
+
+TEST_CASE("framing stops at a truncated varint", "[decoder]") {
+    auto const c = catalog::from_json(test_catalog);
+    auto cap = capture{};
+    cap.catalog_header(4, 5, 0x3e).add(std::uint32_t{5});
+    cap.add(std::uint8_t{0x03}).add(std::uint8_t{0xac});
+
+    auto records = std::vector<record>{};
+    auto const fr = frame(cap.span(), 0, c, records, 100);
+    CHECK(records.empty());
+    CHECK(fr.error == "truncated or malformed varint at offset 0");
+}
+
+TEST_CASE("timestamped catalog messages are decoded", "[decoder]") {
+    auto const c = catalog::from_json(test_catalog);
+    auto cap = capture{};
+    cap.catalog_header(4, 5);
+    cap.bytes[3] = std::byte{0x3f}; // delta subtype
+    cap.add(std::uint32_t{250}).add(std::uint32_t{2}).add(-3).add(255u);
+    CHECK(decode_all_records(cap, c) == "+250 INFO [net]: -3 and 0xff\n");
+    CHECK(decode_all_records(cap, c, output_format::json) ==
+          R"({"offset":0,"type":"catalog","delta":250,"id":2,"level":"INFO","module":"net","msg":"-3 and 0xff"})"
+          "\n");
+}
+
+TEST_CASE("records are recovered from a ring buffer", "[decoder]") {
+    auto const c = catalog::from_json(test_catalog);
+    auto hello = capture{};
+    hello.add(std::uint32_t{1u | 1u << 4u});
+    auto msg = capture{};
+    msg.catalog_header(4, 5).add(std::uint32_t{2}).add(-3).add(255u);
+
+    auto ring = ring_image{3, 4};
+    ring.slot(4, false, msg).slot(2, true, text_record("text")).slot(3, false,
+                                                                     hello);
+    auto const contents = read_ring(ring.span());
+    CHECK(contents.head == 4);
+    CHECK(contents.num_torn == 0);
+    REQUIRE(contents.records.size() == 3);
+    CHECK(contents.records[0].seq == 1);
+
+    auto out = fmt::memory_buffer{};
+    auto const stats = decode_ring(contents, c, output_format::text, out);
+    CHECK(stats.records == 3);
+    CHECK(stats.error.empty());
+    CHECK(fmt::to_string(out) == "text\n"
+                                 "- [-]: Hello\n"
+                                 "INFO [net]: -3 and 0xff\n");
+
+    out.clear();
+    CHECK(decode_ring(contents, c, output_format::json, out).records == 3);
+    CHECK(fmt::to_string(out).starts_with(
+        R"({"seq":1,"type":"text","msg":"text"})"
+        "\n"));
+}
+
+TEST_CASE("incomplete ring buffer records are skipped", "[decoder]") {
+    auto const c = catalog::from_json(test_catalog);
+    auto hello = capture{};
+    hello.add(std::uint32_t{1u | 1u << 4u});
+
+    // record 4 was never written, so slot 1 still holds record 1
+    auto ring = ring_image{3, 5};
+    ring.slot(4, false, hello).slot(2, false, hello).slot(3, false, hello);
+    auto const contents = read_ring(ring.span());
+    CHECK(contents.num_torn == 1);
+    REQUIRE(contents.records.size() == 2);
+    CHECK(contents.records[0].seq == 2);
+    CHECK(contents.records[1].seq == 3);
+
+    auto fresh = ring_image{3, 1};
+    fresh.slot(1, false, hello).slot(0, false, {}).slot(0, false, {});
+    CHECK(read_ring(fresh.span()).num_torn == 0);
+    CHECK(read_ring(fresh.span()).records.size() == 1);
+}
+
+TEST_CASE("a file that is not a ring buffer is rejected", "[decoder]") {
+    auto cap = capture{};
+    cap.add(std::uint32_t{1u | 1u << 4u});
+    CHECK_THROWS_AS(read_ring(cap.span()), std::runtime_error);
+}
@@ -0,0 +1,234 @@
+#include "json.hpp"
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace logging::decoder::json {
+namespace {
+class parser {
+    std::string_view text;
+    std::size_t pos{};
+
+    [[noreturn]] auto fail(std::string_view what) const -> void {
+        throw std::runtime_error{"JSON: " + std::string{what} + " at offset " +
+                                 std::to_string(pos)};
+    }
+
+    auto skip_ws() -> void {
+        while (pos < text.size() and (text[pos] == ' ' or text[pos] == '\t' or
+                                      text[pos] == '\n' or text[pos] == '\r')) {
+            ++pos;
+        }
+    }
+
+    auto peek() -> char {
+        skip_ws();
+        if (pos == text.size()) {
+            fail("unexpected end of input");
+        }
+        return text[pos];
+    }
+
+    auto expect(char c) -> void {
+        if (peek() != c) {
+            fail(std::string{"expected '"} + c + "'");
+        }
+        ++pos;
+    }
+
+    auto literal(std::string_view word) -> void {
+        if (text.substr(pos, word.size()) != word) {
+            fail("invalid literal");
+        }
+        pos += word.size();
+    }
+
+    auto hex4() -> std::uint32_t {
+        if (pos + 4 > text.size()) {
+            fail("truncated \\u escape");
+        }
+        auto cp = std::uint32_t{};
+        auto const first = text.data() + pos;
+        auto const [p, ec] = std::from_chars(first, first + 4, cp, 16);
+        if (ec != std::errc{} or p != first + 4) {
+            fail("invalid \\u escape");
+        }
+        pos += 4;
+        return cp;
+    }
+
+    static auto append_utf8(std::string &s, std::uint32_t cp) -> void {
+        if (cp < 0x80) {
+            s += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            s += static_cast<char>(0xc0 | (cp >> 6));
+            s += static_cast<char>(0x80 | (cp & 0x3f));
+        } else if (cp < 0x10000) {
+            s += static_cast<char>(0xe0 | (cp >> 12));
+            s += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+            s += static_cast<char>(0x80 | (cp & 0x3f));
+        } else {
+            s += static_cast<char>(0xf0 | (cp >> 18));
+            s += static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+            s += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+            s += static_cast<char>(0x80 | (cp & 0x3f));
+        }
+    }
+
+    auto string() -> std::string {
+        expect('"');
+        auto s = std::string{};
+        while (true) {
+            if (pos == text.size()) {
+                fail("unterminated string");
+            }
+            auto const c = text[pos++];
+            if (c == '"') {
+                return s;
+            }
+            if (c != '\\') {
+                s += c;
+                continue;
+            }
+            if (pos == text.size()) {
+                fail("unterminated string");
+            }
+            switch (text[pos++]) {
+            case '"': s += '"'; break;
+            case '\\': s += '\\'; break;
+            case '/': s += '/'; break;
+            case 'b': s += '\b'; break;
+            case 'f': s += '\f'; break;
+            case 'n': s += '\n'; break;
+            case 'r': s += '\r'; break;
+            case 't': s += '\t'; break;
+            case 'u': {
+                auto cp = hex4();
+                if (cp >= 0xd800 and cp < 0xdc00 and
+                    text.substr(pos, 2) == "\\u") {
+                    pos += 2;
+                    auto const lo = hex4();
+                    cp = 0x10000 + ((cp - 0xd800) << 10) + (lo - 0xdc00);
+                }
+                append_utf8(s, cp);
+                break;
+            }
+            default: fail("invalid escape");
+            }
+        }
+    }
+
+    auto number() -> double {
+        auto const first = text.data() + pos;
+        auto d = double{};
+        auto const [p, ec] =
+            std::from_chars(first, text.data() + text.size(), d);
+        if (ec != std::errc{}) {
+            fail("invalid number");
+        }
+        pos += static_cast<std::size_t>(p - first);
+        return d;
+    }
+
+    auto array() -> value::array {
+        expect('[');
+        auto a = value::array{};
+        if (peek() == ']') {
+            ++pos;
+            return a;
+        }
+        while (true) {
+            a.push_back(parse_value());
+            if (peek() == ']') {
+                ++pos;
+                return a;
+            }
+            expect(',');
+        }
+    }
+
+    auto object() -> value::object {
+        expect('{');
+        auto o = value::object{};
+        if (peek() == '}') {
+            ++pos;
+            return o;
+        }
+        while (true) {
+            peek();
+            auto key = string();
+            expect(':');
+            o.emplace_back(std::move(key), parse_value());
+            if (peek() == '}') {
+                ++pos;
+                return o;
+            }
+            expect(',');
+        }
+    }
+
+  public:
+    explicit parser(std::string_view t) : text{t} {}
+
+    auto parse_value() -> value {
+        switch (peek()) {
+        case '{': return value{object()};
+        case '[': return value{array()};
+        case '"': return value{string()};
+        case 't': literal("true"); return value{true};
+        case 'f': literal("false"); return value{false};
+        case 'n': literal("null"); return value{nullptr};
+        default: return value{number()};
+        }
+    }
+
+    auto parse_document() -> value {
+        auto v = parse_value();
+        skip_ws();
+        if (pos != text.size()) {
+            fail("trailing characters");
+        }
+        return v;
+    }
+};
+
+template <typename T> auto get(value const &v, char const *name) -> T const & {
+    if (auto const p = std::get_if<T>(&v.v)) {
+        return *p;
+    }
+    throw std::runtime_error{std::string{"JSON: expected "} + name};
+}
+} // namespace
+
+auto value::as_object() const -> object const & {
+    return get<object>(*this, "an object");
+}
+auto value::as_array() const -> array const & {
+    return get<array>(*this, "an array");
+}
+auto value::as_string() const -> std::string const & {
+    return get<std::string>(*this, "a string");
+}
+auto value::as_number() const -> double { return get<double>(*this, "a number"); }
+
+auto value::find(std::string_view key) const -> value const * {
+    if (auto const o = std::get_if<object>(&v)) {
+        for (auto const &[k, val] : *o) {
+            if (k == key) {
+                return &val;
+            }
+        }
+    }
+    return nullptr;
+}
+
+auto parse(std::string_view text) -> value {
+    return parser{text}.parse_document();
+}
+} // namespace logging::decoder::json
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace logging::decoder::json {
+// A minimal JSON document model: enough to read a string catalog.
+struct value {
+    using array = std::vector<value>;
+    using object = std::vector<std::pair<std::string, value>>;
+
+    std::variant<std::nullptr_t, bool, double, std::string, array, object> v{};
+
+    [[nodiscard]] auto is_object() const -> bool {
+        return std::holds_alternative<object>(v);
+    }
+    [[nodiscard]] auto is_array() const -> bool {
+        return std::holds_alternative<array>(v);
+    }
+    [[nodiscard]] auto is_string() const -> bool {
+        return std::holds_alternative<std::string>(v);
+    }
+    [[nodiscard]] auto is_number() const -> bool {
+        return std::holds_alternative<double>(v);
+    }
+
+    // These throw std::runtime_error if the value has a different type.
+    [[nodiscard]] auto as_object() const -> object const &;
+    [[nodiscard]] auto as_array() const -> array const &;
+    [[nodiscard]] auto as_string() const -> std::string const &;
+    [[nodiscard]] auto as_number() const -> double;
+
+    // Returns nullptr if this is not an object or the key is missing.
+    [[nodiscard]] auto find(std::string_view key) const -> value const *;
+};
+
+// Throws std::runtime_error on malformed input.
+[[nodiscard]] auto parse(std::string_view text) -> value;
+} // namespace logging::decoder::json
@@ -0,0 +1,141 @@
+#include "catalog.hpp"
+#include "decoder.hpp"
+#include "mapped_file.hpp"
+#include "ring_file.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr auto usage = std::string_view{
+    "usage: cib_log_decode [options] <catalog.json> <capture>\n"
+    "\n"
+    "Decode a capture of MIPI Sys-T catalog messages.\n"
+    "\n"
+    "options:\n"
+    "  --json         output JSON lines instead of text\n"
+    "  --ring         the capture is a persistent ring buffer file: decode\n"
+    "                 the records it still holds, oldest first\n"
+    "  --threads <n>  decode with n threads (default: hardware concurrency)\n"
+    "  --output <f>   write to f instead of stdout\n"
+    "  --stats        report throughput on stderr\n"};
+
+auto fail(std::string_view what) -> int {
+    fmt::print(stderr, "cib_log_decode: {}\n", what);
+    return 1;
+}
+} // namespace
+
+auto main(int argc, char *argv[]) -> int {
+    using namespace logging::decoder;
+
+    auto opts = decode_options{};
+    opts.num_threads = std::max(1u, std::thread::hardware_concurrency());
+    auto output = std::string{};
+    auto stats = false;
+    auto ring = false;
+    auto positional = std::vector<std::string>{};
+
+    for (auto i = 1; i < argc; ++i) {
+        auto const arg = std::string_view{argv[i]};
+        auto const value = [&]() -> char const * {
+            return i + 1 < argc ? argv[++i] : nullptr;
+        };
+        if (arg == "--json") {
+            opts.format = output_format::json;
+        } else if (arg == "--ring") {
+            ring = true;
+        } else if (arg == "--stats") {
+            stats = true;
+        } else if (arg == "--threads") {
+            auto const v = value();
+            auto n = 0u;
+            if (v == nullptr or
+                std::from_chars(v, v + std::strlen(v), n).ec != std::errc{} or
+                n == 0) {
+                return fail("--threads needs a positive number");
+            }
+            opts.num_threads = n;
+        } else if (arg == "--output") {
+            auto const v = value();
+            if (v == nullptr) {
+                return fail("--output needs a filename");
+            }
+            output = v;
+        } else if (arg == "--help" or arg == "-h") {
+            fmt::print("{}", usage);
+            return 0;
+        } else {
+            positional.emplace_back(arg);
+        }
+    }
+    if (positional.size() != 2) {
+        fmt::print(stderr, "{}", usage);
+        return 1;
+    }
+
+    try {
+        auto const catalog_file = mapped_file{positional[0]};
+        auto const cat = catalog::from_json(
+            {reinterpret_cast<char const *>(catalog_file.bytes().data()),
+             catalog_file.bytes().size()});
+        auto const capture = mapped_file{positional[1]};
+
+        auto out = stdout;
+        if (not output.empty()) {
+            out = std::fopen(output.c_str(), "wb");
+            if (out == nullptr) {
+                return fail("can't open " + output);
+            }
+        }
+
+        auto const start = std::chrono::steady_clock::now();
+        auto const result = [&] {
+            if (not ring) {
+                return decode_all(capture.bytes(), cat, opts, out);
+            }
+            auto const contents = read_ring(capture.bytes());
+            if (contents.num_torn != 0) {
+                fmt::print(stderr,
+                           "cib_log_decode: {} incomplete records skipped\n",
+                           contents.num_torn);
+            }
+            auto buf = fmt::memory_buffer{};
+            auto const r = decode_ring(contents, cat, opts.format, buf);
+            std::fwrite(buf.data(), 1, buf.size(), out);
+            return r;
+        }();
+        auto const elapsed = std::chrono::duration<double>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+        if (out != stdout) {
+            std::fclose(out);
+        }
+
+        if (stats) {
+            fmt::print(stderr,
+                       "{} records, {} bytes in {:.3f}s: {:.1f} MB/s, {:.1f} "
+                       "Mrecords/s\n",
+                       result.records, result.bytes, elapsed,
+                       static_cast<double>(result.bytes) / elapsed / 1e6,
+                       static_cast<double>(result.records) / elapsed / 1e6);
+        }
+        if (not result.error.empty()) {
+            return fail(result.error);
+        }
+    } catch (std::exception const &e) {
+        return fail(e.what());
+    }
+    return 0;
+}
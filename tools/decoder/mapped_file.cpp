@@ -0,0 +1,48 @@
+#include "mapped_file.hpp"
+
+#include <cerrno>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace logging::decoder {
+namespace {
+[[noreturn]] auto throw_errno(std::string const &what) -> void {
+    throw std::system_error{errno, std::generic_category(), what};
+}
+} // namespace
+
+mapped_file::mapped_file(std::string const &path) {
+    auto const fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw_errno("open " + path);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw_errno("stat " + path);
+    }
+    length = static_cast<std::size_t>(st.st_size);
+    if (length != 0) {
+        addr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            addr = nullptr;
+            ::close(fd);
+            throw_errno("mmap " + path);
+        }
+        // records are read front to back
+        ::madvise(addr, length, MADV_SEQUENTIAL);
+    }
+    ::close(fd);
+}
+
+mapped_file::~mapped_file() {
+    if (addr != nullptr) {
+        ::munmap(addr, length);
+    }
+}
+} // namespace logging::decoder
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+namespace logging::decoder {
+// A read-only memory mapping of a whole file (POSIX).
+class mapped_file {
+    void *addr{};
+    std::size_t length{};
+
+  public:
+    // Throws std::system_error if the file can't be opened or mapped.
+    explicit mapped_file(std::string const &path);
+    ~mapped_file();
+
+    mapped_file(mapped_file const &) = delete;
+    auto operator=(mapped_file const &) -> mapped_file & = delete;
+
+    [[nodiscard]] auto bytes() const -> std::span<std::byte const> {
+        return {static_cast<std::byte const *>(addr), length};
+    }
+};
+} // namespace logging::decoder
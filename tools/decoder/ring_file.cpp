@@ -0,0 +1,114 @@
+#include "ring_file.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace logging::decoder {
+namespace {
+// The layout of logging::persistent_ring; the target is little-endian.
+constexpr auto magic = std::uint32_t{0x4c42'4943}; // "CIBL"
+constexpr auto version = std::uint32_t{1};
+constexpr auto header_bytes = std::size_t{32};
+constexpr auto slot_header_bytes = std::size_t{16};
+constexpr auto text_kind = std::uint8_t{1};
+
+template <typename T> auto load_le(std::byte const *p) -> T {
+    auto v = T{};
+    for (auto i = sizeof(T); i-- > 0;) {
+        v = static_cast<T>(v << 8u) | std::to_integer<T>(p[i]);
+    }
+    return v;
+}
+} // namespace
+
+auto read_ring(std::span<std::byte const> data) -> ring_contents {
+    if (data.size() < header_bytes or
+        load_le<std::uint32_t>(data.data()) != magic) {
+        throw std::runtime_error{"ring: not a persistent ring buffer"};
+    }
+    if (load_le<std::uint32_t>(data.data() + 4) != version) {
+        throw std::runtime_error{"ring: unknown version"};
+    }
+    auto const num_slots =
+        std::size_t{load_le<std::uint32_t>(data.data() + 8)};
+    auto const slot_bytes =
+        std::size_t{load_le<std::uint32_t>(data.data() + 12)};
+    if (slot_bytes <= slot_header_bytes or
+        (data.size() - header_bytes) / slot_bytes < num_slots) {
+        throw std::runtime_error{"ring: truncated"};
+    }
+
+    auto ring = ring_contents{load_le<std::uint64_t>(data.data() + 16),
+                              num_slots, 0, {}};
+    auto const tail =
+        ring.head - std::min<std::uint64_t>(ring.head, num_slots);
+    for (auto i = std::size_t{}; i < num_slots; ++i) {
+        auto const slot = data.data() + header_bytes + i * slot_bytes;
+        auto const stored = load_le<std::uint64_t>(slot);
+        auto const size = std::size_t{load_le<std::uint16_t>(slot + 8)};
+        if (stored == 0) {
+            // a slot is zero until its first record, so a zero slot that
+            // should hold a record was being written
+            if (i < ring.head) {
+                ++ring.num_torn;
+            }
+            continue;
+        }
+        auto const seq = stored - 1;
+        if (seq < tail or seq >= ring.head or seq % num_slots != i or
+            size > slot_bytes - slot_header_bytes) {
+            // left over from an earlier lap: its new record was never written
+            ++ring.num_torn;
+            continue;
+        }
+        ring.records.push_back(
+            {seq, std::to_integer<std::uint8_t>(slot[10]) == text_kind,
+             {slot + slot_header_bytes, size}});
+    }
+    std::sort(ring.records.begin(), ring.records.end(),
+              [](auto const &x, auto const &y) { return x.seq < y.seq; });
+    return ring;
+}
+
+auto decode_ring(ring_contents const &ring, catalog const &c,
+                 output_format format, fmt::memory_buffer &out)
+    -> decode_stats {
+    auto stats = decode_stats{};
+    auto records = std::vector<record>{};
+    for (auto const &r : ring.records) {
+        stats.bytes += r.data.size();
+        if (r.text) {
+            auto const line = std::string_view{
+                reinterpret_cast<char const *>(r.data.data()), r.data.size()};
+            if (format == output_format::text) {
+                out.append(line.data(), line.data() + line.size());
+                out.push_back('\n');
+            } else {
+                fmt::format_to(fmt::appender(out),
+                               R"({{"seq":{},"type":"text","msg":)", r.seq);
+                append_json_string(out, line);
+                out.push_back('}');
+                out.push_back('\n');
+            }
+            ++stats.records;
+            continue;
+        }
+
+        records.clear();
+        auto const fr = frame(r.data, 0, c, records, r.data.size());
+        decode(r.data, records, c, format, out);
+        stats.records += records.size();
+        if (not fr.error.empty() and stats.error.empty()) {
+            stats.error = fmt::format("record {}: {}", r.seq, fr.error);
+        }
+    }
+    return stats;
+}
+} // namespace logging::decoder
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "catalog.hpp"
+#include "decoder.hpp"
+
+#include <fmt/format.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace logging::decoder {
+// A record recovered from a logging::persistent_ring; see
+// log/persistent_ring.hpp.
+struct ring_record {
+    std::uint64_t seq;
+    bool text;
+    std::span<std::byte const> data;
+};
+
+struct ring_contents {
+    std::uint64_t head;
+    std::size_t num_slots;
+    std::size_t num_torn; // slots left half-written by a crash
+    std::vector<ring_record> records; // oldest first
+};
+
+/**
+ * Read the records left in a persistent ring buffer (for example, the file
+ * it was memory-mapped from).
+ *
+ * Only complete records from the last lap of the buffer are returned: a slot
+ * that a writer had claimed but not finished is counted in num_torn.
+ * Throws std::runtime_error if the data is not a persistent ring.
+ */
+[[nodiscard]] auto read_ring(std::span<std::byte const> data)
+    -> ring_contents;
+
+/**
+ * Decode recovered records, appending one line for each message to out.
+ *
+ * Binary records are framed and decoded like a capture (a JSON offset is
+ * within the record); text records are output as they are. A binary record
+ * that can't be decoded is skipped and the first such error is reported.
+ */
+auto decode_ring(ring_contents const &ring, catalog const &c,
+                 output_format format, fmt::memory_buffer &out)
+    -> decode_stats;
+} // namespace logging::decoder
@@ -221,6 +221,39 @@ template<> auto module<{m.to_cpp_type()}>() -> module_id {{
 }}"""
 
 
+def make_hpp_catalog_defn(m: Message) -> str:
+    return f"""/*
+    "{m.text}"
+    {m.args}
+ */
+template<> struct sc::static_catalog<{m.to_cpp_type()}> {{
+    constexpr static string_id value = {m.id};
+}};"""
+
+
+def make_hpp_module_defn(m: Module) -> str:
+    return f"""/*
+    "{m.text}"
+ */
+template<> struct sc::static_module<{m.to_cpp_type()}> {{
+    constexpr static module_id value = {m.id};
+}};"""
+
+
+def write_hpp(messages, modules, extra_headers: list[str], filename: str):
+    with open(filename, "w") as f:
+        f.write("#pragma once\n\n")
+        f.write("\n".join(f'#include "{h}"' for h in extra_headers))
+        f.write("\n#include <log/catalog/arguments.hpp>\n")
+        f.write("\n#include <log/catalog/catalog.hpp>\n\n")
+        hpp_catalog_defns = [make_hpp_catalog_defn(m) for m in messages]
+        f.write("\n".join(hpp_catalog_defns))
+        f.write("\n\n")
+        hpp_module_defns = [make_hpp_module_defn(m) for m in modules]
+        f.write("\n".join(hpp_module_defns))
+        f.write("\n")
+
+
 def write_cpp(messages, modules, extra_headers: list[str], filename: str):
     with open(filename, "w") as f:
         f.write("\n".join(f'#include "{h}"' for h in extra_headers))
@@ -347,7 +380,7 @@ def serialize_modules(client_node: et.Element, modules: list[Module]):
 
 
 def arg_type_encoding(arg):
-    string_re = re.compile(r"encode_(32|u32|64|u64)<(.*)>")
+    string_re = re.compile(r"encode_(32|u32|64|u64|v32|v64|z32|z64)<(.*)>")
     m = string_re.match(arg)
     return (f"encode_{m.group(1)}", m.group(2))
 
@@ -358,6 +391,10 @@ def arg_printf_spec(arg: str):
         "encode_u32": "%u",
         "encode_64": "%lld",
         "encode_u64": "%llu",
+        "encode_z32": "%d",
+        "encode_v32": "%u",
+        "encode_z64": "%lld",
+        "encode_v64": "%llu",
         "float": "%f",
         "double": "%f",
     }
@@ -450,6 +487,14 @@ def parse_cmdline():
     parser.add_argument(
         "--cpp_output", type=str, help="Output filename for generated C++ code."
     )
+    parser.add_argument(
+        "--hpp_output",
+        type=str,
+        help=(
+            "Output filename for a generated C++ header of compile-time IDs, for"
+            " a second build pass."
+        ),
+    )
     parser.add_argument(
         "--json_output", type=str, help="Output filename for generated JSON."
     )
@@ -541,6 +586,8 @@ def main():
 
     if args.cpp_output is not None:
         write_cpp(messages, modules, args.cpp_headers, args.cpp_output)
+    if args.hpp_output is not None:
+        write_hpp(messages, modules, args.cpp_headers, args.hpp_output)
 
     stable_output = dict(messages=[], modules=[])
     if not args.forget_old_ids:
@@ -70,3 +70,22 @@ def test_module_cpp_type():
 def test_module_json():
     m = gen.Module("abc", 42)
     assert m.to_json() == {"string": "abc", "id": 42}
+
+
+def test_message_hpp_defn():
+    m = gen.Message.from_cpp_type(test_msg)
+    defn = gen.make_hpp_catalog_defn(m)
+    assert f"template<> struct sc::static_catalog<{m.to_cpp_type()}>" in defn
+    assert "constexpr static string_id value = 42;" in defn
+
+
+def test_module_hpp_defn():
+    m = gen.Module("abc", 17)
+    defn = gen.make_hpp_module_defn(m)
+    assert f"template<> struct sc::static_module<{m.to_cpp_type()}>" in defn
+    assert "constexpr static module_id value = 17;" in defn
+
+
+def test_varint_printf_spec():
+    assert gen.arg_printf_spec("encode_z32<int>") == "%d"
+    assert gen.arg_printf_spec("encode_v64<unsigned long>") == "%llu"